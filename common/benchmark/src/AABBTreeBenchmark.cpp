@@ -34,6 +34,11 @@
 #include <kdl/overload.h>
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <random>
+#include <vector>
 
 #include "BenchmarkUtils.h"
 #include "../../test/src/Catch2.h"
@@ -67,4 +72,84 @@ namespace TrenchBroom {
             }
         }, "Add objects to AABB tree");
     }
+
+    TEST_CASE("AABBTreeBenchmark.benchBulkBuildTree", "[AABBTreeBenchmark]") {
+        const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+        const auto file = IO::Disk::openFile(mapPath);
+        auto fileReader = file->reader().buffer();
+
+        IO::TestParserStatus status;
+        IO::WorldReader worldReader(fileReader.stringView());
+
+        const vm::bbox3 worldBounds(8192.0);
+        auto world = worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+
+        std::vector<Model::Node*> nodes;
+        world->accept(kdl::overload(
+            [] (auto&& thisLambda, Model::WorldNode* world_)  { world_->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::LayerNode* layer)   { layer->visitChildren(thisLambda); },
+            [] (auto&& thisLambda, Model::GroupNode* group)   { group->visitChildren(thisLambda); },
+            [&](auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); nodes.push_back(entity); },
+            [&](Model::BrushNode* brush)                      { nodes.push_back(brush); }
+        ));
+
+        const auto getBounds = [](const Model::Node* node) { return node->physicalBounds(); };
+
+        std::vector<AABB> incrementalTrees(100);
+        timeLambda([&]() {
+            for (auto& tree : incrementalTrees) {
+                for (auto* node : nodes) {
+                    tree.insert(getBounds(node), node);
+                }
+            }
+        }, "Build AABB tree incrementally");
+
+        std::vector<AABB> bulkTrees(100);
+        timeLambda([&]() {
+            for (auto& tree : bulkTrees) {
+                tree.clearAndBuild(nodes, getBounds);
+            }
+        }, "Build AABB tree using SAH bulk builder");
+
+        printf("Tree height: incremental %zu, bulk %zu\n", incrementalTrees.front().height(), bulkTrees.front().height());
+
+        // cast rays from random points inside the map in random directions
+        const auto& mapBounds = bulkTrees.front().bounds();
+        std::mt19937 rng(0u);
+        std::uniform_real_distribution<double> x(mapBounds.min.x(), mapBounds.max.x());
+        std::uniform_real_distribution<double> y(mapBounds.min.y(), mapBounds.max.y());
+        std::uniform_real_distribution<double> z(mapBounds.min.z(), mapBounds.max.z());
+        std::uniform_real_distribution<double> d(-1.0, 1.0);
+
+        std::vector<vm::ray3> rays;
+        for (size_t i = 0u; i < 100000u; ++i) {
+            rays.emplace_back(vm::vec3(x(rng), y(rng), z(rng)), vm::normalize(vm::vec3(d(rng), d(rng), d(rng))));
+        }
+
+        const auto queryRays = [&](const AABB& tree) {
+            size_t hits = 0u;
+            std::vector<Model::Node*> result;
+            for (const auto& ray : rays) {
+                result.clear();
+                tree.findIntersectors(ray, std::back_inserter(result));
+                hits += result.size();
+            }
+            return hits;
+        };
+
+        size_t incrementalHits = 0u;
+        timeLambda([&]() { incrementalHits = queryRays(incrementalTrees.front()); }, "Query incrementally built AABB tree with rays");
+
+        auto& frozenTree = incrementalTrees.back();
+        timeLambda([&]() { frozenTree.freeze(); }, "Freeze incrementally built AABB tree");
+
+        size_t frozenHits = 0u;
+        timeLambda([&]() { frozenHits = queryRays(frozenTree); }, "Query frozen incrementally built AABB tree with rays");
+
+        size_t bulkHits = 0u;
+        timeLambda([&]() { bulkHits = queryRays(bulkTrees.front()); }, "Query bulk built (frozen) AABB tree with rays");
+
+        CHECK(incrementalHits == frozenHits);
+        CHECK(incrementalHits == bulkHits);
+    }
 }
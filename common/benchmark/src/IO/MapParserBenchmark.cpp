@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/StandardMapParser.h"
+#include "IO/TestParserStatus.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/thread_pool.h>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Parses a map without building any nodes so that only the tokenizer and the parser are measured.
+         */
+        class NullMapParser : public StandardMapParser {
+        private:
+            Model::MapFormat m_format;
+            size_t m_faceCount;
+        public:
+            NullMapParser(std::string_view str, const Model::MapFormat format) :
+            StandardMapParser(str),
+            m_format(format),
+            m_faceCount(0u) {}
+
+            size_t parse(ParserStatus& status) {
+                parseEntities(m_format, status);
+                return m_faceCount;
+            }
+        private:
+            void onFormatSet(Model::MapFormat) override {}
+            void onBeginEntity(size_t, const std::vector<Model::EntityAttribute>&, const ExtraAttributes&, ParserStatus&) override {}
+            void onEndEntity(size_t, size_t, ParserStatus&) override {}
+            void onBeginBrush(size_t, ParserStatus&) override {}
+            void onEndBrush(size_t, size_t, const ExtraAttributes&, ParserStatus&) override {}
+
+            void onStandardBrushFace(size_t, Model::MapFormat, const vm::vec3&, const vm::vec3&, const vm::vec3&, const Model::BrushFaceAttributes&, ParserStatus&) override {
+                ++m_faceCount;
+            }
+
+            void onValveBrushFace(size_t, Model::MapFormat, const vm::vec3&, const vm::vec3&, const vm::vec3&, const Model::BrushFaceAttributes&, const vm::vec3&, const vm::vec3&, ParserStatus&) override {
+                ++m_faceCount;
+            }
+        };
+
+        static std::string makeMap(const Model::MapFormat format, const size_t brushCount) {
+            std::stringstream str;
+            str << "{\n\"classname\" \"worldspawn\"\n\"wad\" \"/quake/id1/gfx/base.wad\"\n}\n";
+
+            for (size_t i = 0u; i < brushCount; ++i) {
+                const auto x = static_cast<double>(i % 128u) * 64.0;
+                const auto y = static_cast<double>(i / 128u) * 64.0;
+
+                str << "{\n\"classname\" \"func_wall\"\n\"targetname\" \"wall" << i << "\"\n{\n";
+                for (size_t j = 0u; j < 6u; ++j) {
+                    str << "( " << x - 16.5 << " " << y + 32.25 << " " << static_cast<double>(j) * 8.0 << " ) "
+                        << "( " << x + 16.5 << " " << y - 32.125 << " 16 ) "
+                        << "( " << x << " " << y << " -0.0625 ) "
+                        << "metal" << (i % 17u) << "_" << j;
+
+                    switch (format) {
+                        case Model::MapFormat::Valve:
+                            str << " [ 1 0 0 -" << x << " ] [ 0 -1 0 " << y << " ] 0 1 1\n";
+                            break;
+                        case Model::MapFormat::Quake2:
+                            str << " " << x << " " << y << " 0 1 1 0 " << (j * 8u) << " 0\n";
+                            break;
+                        default:
+                            str << " " << x << " " << y << " 0 1 1\n";
+                            break;
+                    }
+                }
+                str << "}\n}\n";
+            }
+
+            return str.str();
+        }
+
+        static void benchParseMap(const Model::MapFormat format, const std::string& name) {
+            const auto map = makeMap(format, 32768u);
+
+            // only measure the tokenizer and the parser on the calling thread
+            kdl::thread_pool pool(0u);
+            kdl::scoped_default_thread_pool scope(pool);
+
+            TestParserStatus status;
+            size_t faceCount = 0u;
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            timeLambda([&]() {
+                NullMapParser parser(map, format);
+                faceCount = parser.parse(status);
+            }, "Parse " + name + " map");
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const auto seconds = std::chrono::duration<double>(end - start).count();
+            printf("Parsed %zu faces of %s map at %f MB/s\n", faceCount, name.c_str(),
+                   static_cast<double>(map.size()) / seconds / (1024.0 * 1024.0));
+
+            CHECK(faceCount == 32768u * 6u);
+        }
+
+        TEST_CASE("MapParserBenchmark.benchParseStandardMap", "[MapParserBenchmark]") {
+            benchParseMap(Model::MapFormat::Standard, "Standard");
+        }
+
+        TEST_CASE("MapParserBenchmark.benchParseValveMap", "[MapParserBenchmark]") {
+            benchParseMap(Model::MapFormat::Valve, "Valve");
+        }
+
+        TEST_CASE("MapParserBenchmark.benchParseQuake2Map", "[MapParserBenchmark]") {
+            benchParseMap(Model::MapFormat::Quake2, "Quake2");
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/NodeWriter.h"
+#include "IO/ObjSerializer.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/thread_pool.h>
+
+#include <vecmath/bbox.h>
+
+#include <memory>
+#include <string>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static void exportObj(const Model::WorldNode& world, const Path& path) {
+            NodeWriter writer(world, std::make_unique<ObjFileSerializer>(path));
+            writer.setExporting(true);
+            writer.writeMap();
+        }
+
+        TEST_CASE("ObjSerializerBenchmark.benchExportObj", "[ObjSerializerBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            TestParserStatus status;
+            WorldReader worldReader(fileReader.stringView());
+            auto world = worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+
+            const auto serialPath = Disk::getCurrentWorkingDir() + Path("ne_ruins_serial.obj");
+            const auto parallelPath = Disk::getCurrentWorkingDir() + Path("ne_ruins_parallel.obj");
+
+            {
+                // extract the brush geometry and format the output on the calling thread only
+                kdl::thread_pool pool(0u);
+                kdl::scoped_default_thread_pool scope(pool);
+
+                timeLambda([&]() { exportObj(*world, serialPath); }, "Export ne_ruins.map as OBJ on one thread");
+            }
+
+            timeLambda([&]() { exportObj(*world, parallelPath); }, "Export ne_ruins.map as OBJ in parallel");
+
+            // the parallel export must produce the same output as the serial export
+            CHECK(Disk::readTextFile(parallelPath) == Disk::readTextFile(serialPath));
+            CHECK(Disk::readTextFile(parallelPath.replaceExtension("mtl")) == Disk::readTextFile(serialPath.replaceExtension("mtl")));
+
+            for (const auto& path : { serialPath, parallelPath }) {
+                Disk::deleteFile(path);
+                Disk::deleteFile(path.replaceExtension("mtl"));
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/Path.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static std::vector<std::string> makePathStrings() {
+            // paths that look like the contents of a typical game directory
+            auto result = std::vector<std::string>();
+            for (size_t i = 0u; i < 200000u; ++i) {
+                result.push_back("textures/base_wall/set" + std::to_string(i % 50u) + "/metal_panel" + std::to_string(i) + ".tga");
+            }
+            return result;
+        }
+
+        TEST_CASE("PathBenchmark.benchConstruct", "[PathBenchmark]") {
+            const auto strings = makePathStrings();
+            auto paths = std::vector<Path>();
+            paths.reserve(strings.size());
+
+            timeLambda([&]() {
+                for (const auto& string : strings) {
+                    paths.push_back(Path(string));
+                }
+            }, "Construct " + std::to_string(strings.size()) + " paths");
+
+            CHECK(paths.size() == strings.size());
+        }
+
+        TEST_CASE("PathBenchmark.benchCompare", "[PathBenchmark]") {
+            auto paths = Path::asPaths(makePathStrings());
+            std::reverse(std::begin(paths), std::end(paths));
+
+            timeLambda([&]() {
+                std::sort(std::begin(paths), std::end(paths));
+            }, "Sort " + std::to_string(paths.size()) + " paths");
+
+            size_t count = 0u;
+            timeLambda([&]() {
+                for (size_t i = 1u; i < paths.size(); ++i) {
+                    if (paths[i - 1u] == paths[i]) {
+                        ++count;
+                    }
+                }
+            }, "Compare " + std::to_string(paths.size()) + " adjacent paths for equality");
+
+            CHECK(std::is_sorted(std::begin(paths), std::end(paths)));
+            CHECK(count == 0u);
+        }
+
+        TEST_CASE("PathBenchmark.benchConcatenate", "[PathBenchmark]") {
+            const auto paths = Path::asPaths(makePathStrings());
+            const auto root = Path("/home/user/games/quake/id1");
+            auto result = std::vector<Path>();
+            result.reserve(paths.size());
+
+            timeLambda([&]() {
+                for (const auto& path : paths) {
+                    result.push_back(root + path.deleteLastComponent() + path.lastComponent());
+                }
+            }, "Concatenate " + std::to_string(paths.size()) + " paths");
+
+            CHECK(result.front() == root + paths.front());
+        }
+    }
+}
@@ -0,0 +1,258 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TextureName.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/BrushSnapshot.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/result.h>
+#include <kdl/vector_set.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+#include "../../test/src/GTestCompat.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static std::vector<Brush> loadBrushes(const vm::bbox3& worldBounds) {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(fileReader.stringView());
+            auto world = worldReader.read(MapFormat::Standard, worldBounds, status);
+
+            std::vector<Brush> brushes;
+            world->accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* world_)  { world_->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, GroupNode* group)   { group->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, EntityNode* entity) { entity->visitChildren(thisLambda); },
+                [&](BrushNode* brushNode)                  { brushes.push_back(brushNode->brush()); }
+            ));
+            return brushes;
+        }
+
+        TEST_CASE("BrushBenchmark.benchBrushGeometry", "[BrushBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            const auto brushes = loadBrushes(worldBounds);
+            const auto count = std::to_string(brushes.size());
+
+            std::vector<std::vector<BrushFace>> faces;
+            for (const auto& brush : brushes) {
+                faces.push_back(brush.faces());
+            }
+
+            std::vector<Brush> created;
+            created.reserve(brushes.size());
+            timeLambda([&]() {
+                for (const auto& brushFaces : faces) {
+                    created.push_back(Brush::create(worldBounds, brushFaces).value());
+                }
+            }, "Create " + count + " brushes");
+
+            std::vector<Brush> createdInParallel;
+            timeLambda([&]() {
+                createdInParallel = kdl::vec_parallel_transform(faces, [&](const auto& brushFaces) {
+                    return Brush::create(worldBounds, brushFaces).value();
+                });
+            }, "Create " + count + " brushes in parallel");
+
+            std::vector<Brush> copies;
+            copies.reserve(brushes.size());
+            timeLambda([&]() {
+                for (const auto& brush : brushes) {
+                    copies.push_back(brush);
+                }
+            }, "Copy " + count + " brushes");
+
+            const auto translation = vm::translation_matrix(vm::vec3(16.0, 32.0, 8.0));
+            std::vector<Brush> translated;
+            translated.reserve(brushes.size());
+            timeLambda([&]() {
+                for (const auto& brush : brushes) {
+                    translated.push_back(brush.transform(worldBounds, translation, false).value());
+                }
+            }, "Translate " + count + " brushes");
+
+            const auto rotation = vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(15.0));
+            std::vector<Brush> rotated;
+            rotated.reserve(brushes.size());
+            timeLambda([&]() {
+                for (const auto& brush : brushes) {
+                    rotated.push_back(brush.transform(worldBounds, rotation, false).value());
+                }
+            }, "Rotate " + count + " brushes");
+
+            timeLambda([&]() {
+                created.clear();
+                createdInParallel.clear();
+                copies.clear();
+                translated.clear();
+                rotated.clear();
+            }, "Destroy " + std::to_string(5u * brushes.size()) + " brushes");
+        }
+
+        /*
+         * Compares transforming a selection of brushes one by one to computing the transformed brushes in parallel
+         * like MapDocumentCommandFacade::performTransform does.
+         */
+        TEST_CASE("BrushBenchmark.benchTransformSelection", "[BrushBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            const auto brushes = loadBrushes(worldBounds);
+
+            // simulate a large selection
+            std::vector<const Brush*> selection;
+            for (size_t i = 0u; i < 4u; ++i) {
+                for (const auto& brush : brushes) {
+                    selection.push_back(&brush);
+                }
+            }
+            const auto count = std::to_string(selection.size());
+
+            const auto benchTransform = [&](const vm::mat4x4& transformation, const std::string& name) {
+                const auto transformBrush = [&](const Brush* brush) {
+                    return brush->transform(worldBounds, transformation, true).value();
+                };
+
+                std::vector<Brush> serial;
+                serial.reserve(selection.size());
+                timeLambda([&]() {
+                    for (const auto* brush : selection) {
+                        serial.push_back(transformBrush(brush));
+                    }
+                }, name + " " + count + " brushes serially");
+
+                std::vector<Brush> parallel;
+                timeLambda([&]() {
+                    parallel = kdl::vec_parallel_transform(selection, transformBrush);
+                }, name + " " + count + " brushes in parallel");
+
+                CHECK(serial == parallel);
+            };
+
+            benchTransform(vm::translation_matrix(vm::vec3(16.0, 32.0, 8.0)), "Translate");
+            benchTransform(vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(15.0)), "Rotate");
+        }
+
+        TEST_CASE("BrushBenchmark.benchCopyBrushes", "[BrushBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            const auto brushes = loadBrushes(worldBounds);
+            const auto count = std::to_string(brushes.size());
+
+            std::vector<Brush> copies;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < 10u; ++i) {
+                    copies = brushes;
+                }
+            }, "Copy " + count + " brushes 10 times");
+            CHECK(copies == brushes);
+
+            const auto brushNodes = kdl::vec_transform(brushes, [](const Brush& brush) {
+                return std::make_unique<BrushNode>(brush);
+            });
+
+            std::vector<std::unique_ptr<NodeSnapshot>> snapshots;
+            snapshots.reserve(brushNodes.size());
+            timeLambda([&]() {
+                for (const auto& brushNode : brushNodes) {
+                    snapshots.emplace_back(brushNode->takeSnapshot());
+                }
+            }, "Take snapshots of " + count + " brushes");
+            CHECK(snapshots.size() == brushNodes.size());
+        }
+
+        TEST_CASE("BrushBenchmark.benchTextureNames", "[BrushBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            const auto brushes = loadBrushes(worldBounds);
+
+            std::vector<std::string> names;
+            std::vector<Assets::TextureName> internedNames;
+            for (const auto& brush : brushes) {
+                for (const auto& face : brush.faces()) {
+                    names.push_back(face.attributes().textureName());
+                    internedNames.push_back(face.attributes().internedTextureName());
+                }
+            }
+            const auto uniqueNames = kdl::vector_set<std::string>(std::begin(names), std::end(names));
+
+            // a string per face needs a heap allocation if the name does not fit into the small string buffer
+            const auto smallStringCapacity = std::string().capacity();
+            size_t stringBytes = 0u;
+            for (const auto& name : names) {
+                stringBytes += sizeof(std::string) + (name.capacity() > smallStringCapacity ? name.capacity() + 1u : 0u);
+            }
+
+            // an interned name per face, and an entry in the table and its index for every unique name
+            size_t internedBytes = internedNames.size() * sizeof(Assets::TextureName);
+            for (const auto& name : uniqueNames) {
+                internedBytes += 2u * (sizeof(std::string) + name.size() + 1u + sizeof(size_t));
+            }
+
+            printf("Texture names of %zu faces with %zu unique names: %zu bytes as strings, %zu bytes interned\n",
+                names.size(), uniqueNames.size(), stringBytes, internedBytes);
+
+            size_t stringMatches = 0u;
+            timeLambda([&]() {
+                for (const auto& uniqueName : uniqueNames) {
+                    for (const auto& name : names) {
+                        stringMatches += name == uniqueName ? 1u : 0u;
+                    }
+                }
+            }, "Compare " + std::to_string(names.size()) + " texture names to each unique name as strings");
+
+            const auto internedUniqueNames = kdl::vec_transform(uniqueNames.get_data(), [](const auto& name) { return Assets::TextureName(name); });
+            size_t internedMatches = 0u;
+            timeLambda([&]() {
+                for (const auto& uniqueName : internedUniqueNames) {
+                    for (const auto& name : internedNames) {
+                        internedMatches += name == uniqueName ? 1u : 0u;
+                    }
+                }
+            }, "Compare " + std::to_string(names.size()) + " texture names to each unique name as interned names");
+
+            CHECK(internedMatches == stringMatches);
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+#include "../../test/src/GTestCompat.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Matches every node of the given world against every given brush like collectTouchingNodes did before it
+         * used the node tree.
+         */
+        static std::vector<Node*> collectTouchingNodesByTraversal(WorldNode& world, const std::vector<BrushNode*>& brushes) {
+            auto result = std::vector<Node*>{};
+
+            const auto collectIfTouching = [&](auto* node) {
+                for (const auto* brush : brushes) {
+                    if (brush->intersects(node)) {
+                        result.push_back(node);
+                        return;
+                    }
+                }
+            };
+
+            world.accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* world_) { world_->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* layer)  { layer->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, GroupNode* group)  {
+                    if (group->opened()) {
+                        group->visitChildren(thisLambda);
+                    } else {
+                        collectIfTouching(group);
+                    }
+                },
+                [&](auto&& thisLambda, EntityNode* entity) {
+                    if (entity->hasChildren()) {
+                        entity->visitChildren(thisLambda);
+                    } else {
+                        collectIfTouching(entity);
+                    }
+                },
+                [&](BrushNode* brush) { collectIfTouching(brush); }
+            ));
+
+            return result;
+        }
+
+        TEST_CASE("ModelUtilsBenchmark.benchCollectTouchingNodes", "[ModelUtilsBenchmark]") {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(fileReader.stringView());
+
+            const vm::bbox3 worldBounds(8192.0);
+            auto world = worldReader.read(MapFormat::Standard, worldBounds, status);
+
+            // use translated copies of all brushes of the map as the selection, so that every selected brush touches
+            // a few of the brushes in the map
+            const auto translation = vm::translation_matrix(vm::vec3(8.0, 8.0, 8.0));
+            auto selection = std::vector<std::unique_ptr<BrushNode>>{};
+            world->accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* world_)  { world_->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* layer)   { layer->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, GroupNode* group)   { group->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, EntityNode* entity) { entity->visitChildren(thisLambda); },
+                [&](BrushNode* brushNode) {
+                    selection.push_back(std::make_unique<BrushNode>(brushNode->brush().transform(worldBounds, translation, false).value()));
+                }
+            ));
+
+            const auto brushes = kdl::vec_transform(selection, [](const auto& brushNode) { return brushNode.get(); });
+            const auto count = std::to_string(brushes.size());
+
+            auto expected = std::vector<Node*>{};
+            timeLambda([&]() {
+                expected = collectTouchingNodesByTraversal(*world, brushes);
+            }, "Collect nodes touching " + count + " brushes by traversal");
+
+            auto actual = std::vector<Node*>{};
+            timeLambda([&]() {
+                actual = collectTouchingNodes(*world, brushes);
+            }, "Collect nodes touching " + count + " brushes using the node tree");
+
+            CHECK(kdl::vec_sort(std::move(actual)) == kdl::vec_sort(std::move(expected)));
+        }
+    }
+}
@@ -26,6 +26,7 @@
 #include "Model/MapFormat.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushRendererBrushCache.h"
 
 #include <kdl/result.h>
 
@@ -131,6 +132,38 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(brushes);
             kdl::vec_clear_and_delete(textures);
         }
+
+        TEST_CASE("BrushRendererBenchmark.benchVertexCache", "[BrushRendererBenchmark]") {
+            auto [brushes, textures] = makeBrushes();
+            const auto constBrushes = std::vector<const Model::BrushNode*>(std::begin(brushes), std::end(brushes));
+
+            size_t vertexCount = 0u;
+            for (const auto* brush : constBrushes) {
+                vertexCount += brush->brushRendererBrushCache().cachedVertices().size();
+            }
+            const auto count = std::to_string(brushes.size()) + " brushes with " + std::to_string(vertexCount) + " vertices";
+
+            const auto invalidateVertexCaches = [&]() {
+                for (auto* brush : brushes) {
+                    brush->invalidateVertexCache();
+                }
+            };
+
+            invalidateVertexCaches();
+            timeLambda([&]() {
+                for (const auto* brush : constBrushes) {
+                    brush->brushRendererBrushCache().validateVertexCache(brush);
+                }
+            }, "validate vertex caches of " + count + " one by one");
+
+            invalidateVertexCaches();
+            timeLambda([&]() {
+                BrushRendererBrushCache::validateVertexCaches(constBrushes);
+            }, "validate vertex caches of " + count + " in batches");
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
     }
 }
 
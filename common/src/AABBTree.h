@@ -21,14 +21,19 @@
 
 #include "Exceptions.h"
 
+#include <kdl/thread_pool.h>
+
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <iosfwd>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 
@@ -52,6 +57,24 @@ namespace TrenchBroom {
         class InnerNode;
         class LeafNode;
 
+        /**
+         * A node of the frozen representation of this tree, see freeze().
+         */
+        struct FlatNode {
+            Box bounds;
+            /**
+             * The index of the node following the subtree rooted at this node. For a leaf, this is the index of the
+             * next node.
+             */
+            size_t skipIndex;
+            /**
+             * The index of the data of a leaf, or NoData for an inner node.
+             */
+            size_t dataIndex;
+        };
+
+        static constexpr size_t NoData = std::numeric_limits<size_t>::max();
+
         class Visitor {
         public:
             virtual ~Visitor() = default;
@@ -128,6 +151,14 @@ namespace TrenchBroom {
              * @param visitor the visitor to accept
              */
             virtual void accept(Visitor& visitor) const = 0;
+
+            /**
+             * Appends the subtree rooted at this node to the given vectors in depth first order.
+             *
+             * @param nodes the flat nodes to append to
+             * @param data the leaf data to append to
+             */
+            virtual void flatten(std::vector<FlatNode>& nodes, std::vector<U>& data) const = 0;
         public:
             /**
              * Appends a textual representation of this node to the given output stream.
@@ -365,6 +396,15 @@ namespace TrenchBroom {
                     m_right->accept(visitor);
                 }
             }
+
+            void flatten(std::vector<FlatNode>& nodes, std::vector<U>& data) const override {
+                const auto index = nodes.size();
+                nodes.push_back(FlatNode{this->bounds(), 0u, NoData});
+
+                m_left->flatten(nodes, data);
+                m_right->flatten(nodes, data);
+                nodes[index].skipIndex = nodes.size();
+            }
         public:
             void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
                 for (size_t i = 0; i < level; ++i)
@@ -448,6 +488,11 @@ namespace TrenchBroom {
                 visitor.visit(this);
             }
 
+            void flatten(std::vector<FlatNode>& nodes, std::vector<U>& data) const override {
+                nodes.push_back(FlatNode{this->bounds(), nodes.size() + 1u, data.size()});
+                data.push_back(m_data);
+            }
+
             void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
                 for (size_t i = 0; i < level; ++i)
                     str << indent;
@@ -461,9 +506,31 @@ namespace TrenchBroom {
                 assert(this->m_parent == expectedParent);
             }
         };
+    private:
+        /**
+         * An object to be added to the tree by the bulk builder.
+         */
+        struct BuildItem {
+            Box bounds;
+            vm::vec<T,S> center;
+            U data;
+        };
+
+        /**
+         * The number of bins per axis used to evaluate the surface area heuristic.
+         */
+        static constexpr size_t BinCount = 16u;
+
+        /**
+         * Subtrees with at least this many objects are built in parallel.
+         */
+        static constexpr size_t ParallelBuildThreshold = 4096u;
     private:
         Node* m_root;
         std::unordered_map<U, LeafNode*> m_leafForData;
+
+        std::vector<FlatNode> m_flatNodes;
+        std::vector<U> m_flatData;
     public:
         AABBTree() : m_root(nullptr) {}
 
@@ -483,19 +550,181 @@ namespace TrenchBroom {
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Clears this tree and rebuilds it from the given objects.
+         *
+         * Instead of inserting the objects one by one, the tree is built top down by splitting the objects according
+         * to the surface area heuristic, which yields a tree with much better query performance. Large subtrees are
+         * built in parallel. The resulting tree is frozen.
          *
          * @param objects the objects to insert, a list of DataType
          * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if the given objects contain duplicates, or the bounds of an object contains NaN
          */
         template <typename DataList, typename GetBounds>
         void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
             clear();
-            for (const U& object : objects) {
-                insert(getBounds(object), object);
+
+            std::vector<BuildItem> items;
+            items.reserve(objects.size());
+
+            try {
+                for (const U& object : objects) {
+                    const auto bounds = getBounds(object);
+                    check(bounds);
+
+                    if (!m_leafForData.emplace(object, nullptr).second) {
+                        throw NodeTreeException("Data already in tree");
+                    }
+                    items.push_back(BuildItem{bounds, bounds.center(), object});
+                }
+            } catch (...) {
+                m_leafForData.clear();
+                throw;
+            }
+
+            if (items.empty()) {
+                return;
+            }
+
+            // the builder only reorders items within the range it is currently splitting, so once the leaf for an
+            // item was created, the item remains at the same index as its leaf
+            std::vector<LeafNode*> leaves(items.size(), nullptr);
+            m_root = build(items, leaves, 0u, items.size());
+
+            for (size_t i = 0u; i < items.size(); ++i) {
+                m_leafForData[items[i].data] = leaves[i];
+            }
+
+            freeze();
+        }
+    private:
+        /**
+         * Builds a subtree containing the items in the range [first, last).
+         */
+        static Node* build(std::vector<BuildItem>& items, std::vector<LeafNode*>& leaves, const size_t first, const size_t last) {
+            assert(first < last);
+
+            if (last - first == 1u) {
+                auto* leaf = new LeafNode(items[first].bounds, items[first].data);
+                leaves[first] = leaf;
+                return leaf;
+            }
+
+            const size_t mid = split(items, first, last);
+
+            Node* left = nullptr;
+            Node* right = nullptr;
+            if (last - first >= ParallelBuildThreshold) {
+                kdl::task_group group;
+                group.run([&]() { left = build(items, leaves, first, mid); });
+                right = build(items, leaves, mid, last);
+                group.wait();
+            } else {
+                left = build(items, leaves, first, mid);
+                right = build(items, leaves, mid, last);
+            }
+
+            return new InnerNode(left, right);
+        }
+
+        /**
+         * Partitions the items in the range [first, last) into two non-empty ranges using a binned surface area
+         * heuristic. The items are binned by the centers of their bounds along each axis, and the split between two
+         * bins that minimizes the sum of the surface areas of both sides weighted by their item counts is chosen.
+         *
+         * @return the index of the first item of the second range
+         */
+        static size_t split(std::vector<BuildItem>& items, const size_t first, const size_t last) {
+            auto centerMin = items[first].center;
+            auto centerMax = items[first].center;
+            for (size_t i = first + 1u; i < last; ++i) {
+                for (size_t axis = 0u; axis < S; ++axis) {
+                    centerMin[axis] = std::min(centerMin[axis], items[i].center[axis]);
+                    centerMax[axis] = std::max(centerMax[axis], items[i].center[axis]);
+                }
+            }
+
+            const auto binIndex = [&](const BuildItem& item, const size_t axis) {
+                const auto extent = centerMax[axis] - centerMin[axis];
+                const auto bin = static_cast<size_t>((item.center[axis] - centerMin[axis]) / extent * static_cast<T>(BinCount));
+                return std::min(bin, BinCount - 1u);
+            };
+
+            auto bestCost = std::numeric_limits<T>::max();
+            auto bestAxis = S;
+            auto bestBin = BinCount;
+
+            for (size_t axis = 0u; axis < S; ++axis) {
+                if (centerMax[axis] <= centerMin[axis]) {
+                    continue;
+                }
+
+                std::array<Box, BinCount> binBounds;
+                std::array<size_t, BinCount> binCounts{};
+                for (size_t i = first; i < last; ++i) {
+                    const auto bin = binIndex(items[i], axis);
+                    binBounds[bin] = binCounts[bin] == 0u ? items[i].bounds : vm::merge(binBounds[bin], items[i].bounds);
+                    ++binCounts[bin];
+                }
+
+                // sweep from the right to compute the cost of the right side of every split
+                std::array<T, BinCount> rightCosts{};
+                Box rightBounds;
+                size_t rightCount = 0u;
+                for (size_t bin = BinCount - 1u; bin > 0u; --bin) {
+                    if (binCounts[bin] > 0u) {
+                        rightBounds = rightCount == 0u ? binBounds[bin] : vm::merge(rightBounds, binBounds[bin]);
+                        rightCount += binCounts[bin];
+                    }
+                    rightCosts[bin - 1u] = rightCount == 0u ? static_cast<T>(0) : surfaceArea(rightBounds) * static_cast<T>(rightCount);
+                }
+
+                // sweep from the left and evaluate each split between bin and bin + 1
+                Box leftBounds;
+                size_t leftCount = 0u;
+                for (size_t bin = 0u; bin < BinCount - 1u; ++bin) {
+                    if (binCounts[bin] > 0u) {
+                        leftBounds = leftCount == 0u ? binBounds[bin] : vm::merge(leftBounds, binBounds[bin]);
+                        leftCount += binCounts[bin];
+                    }
+
+                    if (leftCount > 0u && leftCount < last - first) {
+                        const auto cost = surfaceArea(leftBounds) * static_cast<T>(leftCount) + rightCosts[bin];
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestBin = bin;
+                        }
+                    }
+                }
             }
+
+            if (bestAxis < S) {
+                const auto mid = std::partition(std::next(std::begin(items), static_cast<std::ptrdiff_t>(first)), std::next(std::begin(items), static_cast<std::ptrdiff_t>(last)), [&](const BuildItem& item) {
+                    return binIndex(item, bestAxis) <= bestBin;
+                });
+                return static_cast<size_t>(std::distance(std::begin(items), mid));
+            }
+
+            // all centers coincide, so any split is as good as any other
+            return first + (last - first) / 2u;
         }
 
+        /**
+         * Returns half of the surface area of the given box, which is sufficient to compare split costs.
+         */
+        static T surfaceArea(const Box& bounds) {
+            const auto size = bounds.size();
+            auto result = static_cast<T>(0);
+            for (size_t i = 0u; i < S; ++i) {
+                for (size_t j = i + 1u; j < S; ++j) {
+                    result += size[i] * size[j];
+                }
+            }
+            return result;
+        }
+    public:
         /**
          * Insert a node with the given bounds and data into this tree.
          *
@@ -512,6 +741,8 @@ namespace TrenchBroom {
                 throw NodeTreeException("Data already in tree");
             }
 
+            thaw();
+
             if (empty()) {
                 auto* insertedLeafNode = new LeafNode(bounds, data);
 
@@ -541,6 +772,8 @@ namespace TrenchBroom {
             assert(leaf->data() == data);
             m_leafForData.erase(it);
 
+            thaw();
+
             m_root = leaf->deleteThis();
 
             return true;
@@ -577,8 +810,63 @@ namespace TrenchBroom {
                 delete m_root;
                 m_root = nullptr;
             }
+            m_leafForData.clear();
+            thaw();
+        }
+
+        /**
+         * Freezes this tree by copying it into a compact array of nodes in depth first order. Queries on a frozen tree
+         * traverse this array linearly instead of chasing pointers through the individually allocated nodes, which is
+         * much more cache friendly. Any modification of the tree discards the frozen representation, and the tree
+         * can be frozen again afterwards.
+         *
+         * Does nothing if this tree is already frozen.
+         */
+        void freeze() {
+            if (!frozen() && !empty()) {
+                m_flatNodes.reserve(2u * m_leafForData.size() - 1u);
+                m_flatData.reserve(m_leafForData.size());
+                m_root->flatten(m_flatNodes, m_flatData);
+            }
+        }
+
+        /**
+         * Indicates whether this tree is frozen, see freeze().
+         *
+         * @return true if this tree is frozen and false otherwise
+         */
+        bool frozen() const {
+            return !m_flatNodes.empty();
+        }
+    private:
+        void thaw() {
+            m_flatNodes.clear();
+            m_flatData.clear();
         }
 
+        /**
+         * Traverses the frozen representation of this tree, skipping every subtree whose bounds are rejected by the
+         * given predicate, and passes the data of every accepted leaf to the given function.
+         */
+        template <typename P, typename F>
+        void traverseFrozen(const P& accept, const F& onLeaf) const {
+            assert(frozen());
+
+            size_t index = 0u;
+            while (index < m_flatNodes.size()) {
+                const auto& node = m_flatNodes[index];
+                if (accept(node.bounds)) {
+                    if (node.dataIndex != NoData) {
+                        onLeaf(m_flatData[node.dataIndex]);
+                    }
+                    ++index;
+                } else {
+                    index = node.skipIndex;
+                }
+            }
+        }
+    public:
+
         /**
          * Indicates whether this tree is empty.
          *
@@ -635,7 +923,17 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findIntersectors(const vm::ray<T,S>& ray, O out) const {
-            if (!empty()) {
+            if (frozen()) {
+                traverseFrozen(
+                    [&](const Box& bounds) {
+                        return bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+                    },
+                    [&](const U& data) {
+                        out = data;
+                        ++out;
+                    }
+                );
+            } else if (!empty()) {
                 LambdaVisitor visitor(
                     [&](const InnerNode* innerNode) {
                         return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
@@ -652,6 +950,55 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the given box and returns a list of those
+         * items.
+         *
+         * @param box the box to test
+         * @return a list containing all found data items
+         */
+        List findIntersectors(const Box& box) const {
+            List result;
+            findIntersectors(box, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the given box and appends it to the given
+         * output iterator.
+         *
+         * @tparam O the output iterator type
+         * @param box the box to test
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findIntersectors(const Box& box, O out) const {
+            if (frozen()) {
+                traverseFrozen(
+                    [&](const Box& bounds) {
+                        return bounds.intersects(box);
+                    },
+                    [&](const U& data) {
+                        out = data;
+                        ++out;
+                    }
+                );
+            } else if (!empty()) {
+                LambdaVisitor visitor(
+                    [&](const InnerNode* innerNode) {
+                        return innerNode->bounds().intersects(box);
+                    },
+                    [&](const LeafNode* leaf) {
+                        if (leaf->bounds().intersects(box)) {
+                            out = leaf->data();
+                            ++out;
+                        }
+                    }
+                );
+                m_root->accept(visitor);
+            }
+        }
+
         /**
          * Finds every data item in this tree whose bounding box contains the given point and returns a list of those items.
          *
@@ -674,7 +1021,17 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findContainers(const vm::vec<T,S>& point, O out) const {
-            if (!empty()) {
+            if (frozen()) {
+                traverseFrozen(
+                    [&](const Box& bounds) {
+                        return bounds.contains(point);
+                    },
+                    [&](const U& data) {
+                        out = data;
+                        ++out;
+                    }
+                );
+            } else if (!empty()) {
                 LambdaVisitor visitor(
                     [&](const InnerNode* innerNode) {
                         return innerNode->bounds().contains(point);
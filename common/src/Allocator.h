@@ -20,179 +20,285 @@
 #pragma once
 
 #include <cassert>
-#include <stack>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
 #include <vector>
 
 // Undefine this to prevent false positives when looking for memory leaks.
 #define TB_ENABLE_ALLOCATOR 1
 
 namespace TrenchBroom {
-    template <class T, size_t PoolSize = 64, size_t BlocksPerChunk = 256>
+    /**
+     * Pooled allocation for small objects which are created and destroyed in large numbers, such as the vertices,
+     * edges and faces of a polyhedron. Derive T from this class to use it.
+     *
+     * Memory is obtained in chunks of BlocksPerChunk blocks each. Every thread keeps a cache of free blocks, so
+     * allocating and freeing an object does not need any synchronization in the common case. The caches are refilled
+     * from and returned to a pool of chunks shared by all threads in batches of CacheSize blocks. A batch is taken from
+     * a single chunk if possible, so the objects which a thread creates in quick succession, e.g. the topology of a
+     * polyhedron, end up close together in memory.
+     *
+     * An object may be deleted on a different thread than the one which created it.
+     *
+     * @tparam T the type of the objects to allocate
+     * @tparam CacheSize the number of blocks to move between a thread's cache and the shared pool at once
+     * @tparam BlocksPerChunk the number of blocks per chunk
+     */
+    template <class T, size_t CacheSize = 64, size_t BlocksPerChunk = 256>
     class Allocator {
     private:
-        class Chunk {
-        private:
-            unsigned char m_blocks[BlocksPerChunk * sizeof(T)];
-            unsigned char m_firstFreeBlock;
-            unsigned char m_numFreeBlocks;
-        public:
+        static_assert(CacheSize > 0, "cache size must not be zero");
+        static_assert(BlocksPerChunk > 0, "chunks must contain at least one block");
+
+        union Block {
+            Block* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        /**
+         * Chunks are aligned to a power of two that is not smaller than their size, so the chunk containing a block
+         * can be computed from the block's address.
+         */
+        struct Chunk {
+            Block blocks[BlocksPerChunk];
+            Block* firstFreeBlock;
+            size_t freeBlockCount;
+            size_t partialIndex;
+
             Chunk() :
-                m_firstFreeBlock(0),
-                m_numFreeBlocks(BlocksPerChunk - 1) {
-                for (size_t i = 0; i < BlocksPerChunk - 1; i++)
-                    m_blocks[i * sizeof(T)] = static_cast<unsigned char>(i + 1);
+            firstFreeBlock(nullptr),
+            freeBlockCount(BlocksPerChunk),
+            partialIndex(NotPartial) {
+                for (size_t i = 0; i < BlocksPerChunk; ++i) {
+                    blocks[i].next = i + 1 < BlocksPerChunk ? &blocks[i + 1] : nullptr;
+                }
+                firstFreeBlock = &blocks[0];
             }
 
-            bool contains(const T* t) const {
-                const unsigned char* block = reinterpret_cast<const unsigned char*>(t);
-                if (block < m_blocks)
-                    return false;
-                size_t offset = static_cast<size_t>(block - m_blocks);
-                return offset < (BlocksPerChunk - 1) * sizeof(T);
+            Block* allocate() {
+                assert(freeBlockCount > 0);
+                Block* block = firstFreeBlock;
+                firstFreeBlock = block->next;
+                --freeBlockCount;
+                return block;
             }
 
-            T* allocate() {
-                if (m_numFreeBlocks == 0)
-                    return nullptr;
-
-                unsigned char* block = m_blocks + m_firstFreeBlock * sizeof(T);
-                m_firstFreeBlock = *block;
-                m_numFreeBlocks--;
-                return reinterpret_cast<T*>(block);
+            void deallocate(Block* block) {
+                assert(freeBlockCount < BlocksPerChunk);
+                block->next = firstFreeBlock;
+                firstFreeBlock = block;
+                ++freeBlockCount;
             }
 
-            void deallocate(T* t) {
-                assert(m_numFreeBlocks < BlocksPerChunk - 1);
-                assert(contains(t));
+            bool empty() const {
+                return freeBlockCount == BlocksPerChunk;
+            }
 
-                unsigned char* block = reinterpret_cast<unsigned char*>(t);
-                assert(block >= m_blocks);
-                size_t offset = static_cast<size_t>(block - m_blocks);
-                assert(offset % sizeof(T) == 0);
+            bool full() const {
+                return freeBlockCount == 0;
+            }
+        };
 
-                size_t index = offset / sizeof(T);
-                assert(index < BlocksPerChunk);
+        static constexpr size_t NotPartial = std::numeric_limits<size_t>::max();
+        static constexpr size_t MaxEmptyChunks = 2;
 
-                *block = m_firstFreeBlock;
-                m_firstFreeBlock = static_cast<unsigned char>(index);
-                m_numFreeBlocks++;
+        static constexpr size_t chunkAlignment() {
+            size_t result = alignof(Chunk);
+            while (result < sizeof(Chunk)) {
+                result *= 2;
             }
+            return result;
+        }
 
-            bool empty() const {
-                return m_numFreeBlocks == BlocksPerChunk - 1;
-            }
+        /**
+         * The chunks shared by all threads. Full chunks are not tracked, they are found by address when one of their
+         * blocks is returned.
+         */
+        struct SharedPool {
+            std::mutex mutex;
+            std::vector<Chunk*> partialChunks;
+            std::vector<Chunk*> emptyChunks;
+        };
 
-            bool full() const {
-                return m_numFreeBlocks == 0;
+        /**
+         * A thread's cache of free blocks. Any blocks left in the cache are returned to the shared pool when the
+         * thread exits.
+         */
+        struct ThreadCache {
+            Block* firstBlock = nullptr;
+            size_t blockCount = 0;
+
+            ~ThreadCache() {
+                releaseBlocks(firstBlock, blockCount);
+                cacheDestroyed() = true;
             }
         };
 
-        using ChunkList = std::vector<Chunk*>;
-        using Pool = std::stack<T*>;
+        static SharedPool& sharedPool() {
+            // never destroyed, objects may be deleted during static destruction
+            static auto* pool = new SharedPool();
+            return *pool;
+        }
 
-        static Pool& pool() {
-            static Pool p;
-            return p;
+        static ThreadCache& threadCache() {
+            thread_local ThreadCache cache;
+            return cache;
         }
 
-        static ChunkList& fullChunks() {
-            static ChunkList chunks;
-            return chunks;
+        static bool& cacheDestroyed() {
+            thread_local bool destroyed = false;
+            return destroyed;
         }
 
-        static ChunkList& mixedChunks() {
-            static ChunkList chunks;
-            return chunks;
+        static Chunk* chunkOf(Block* block) {
+            const auto address = reinterpret_cast<std::uintptr_t>(block);
+            return reinterpret_cast<Chunk*>(address & ~static_cast<std::uintptr_t>(chunkAlignment() - 1));
         }
 
-        static ChunkList emptyChunks() {
-            static ChunkList chunks;
-            return chunks;
+        static Chunk* createChunk() {
+            void* memory = ::operator new(sizeof(Chunk), std::align_val_t(chunkAlignment()));
+            return new (memory) Chunk();
         }
-    public:
-#ifdef TB_ENABLE_ALLOCATOR
-        void* operator new([[maybe_unused]] size_t size) {
-            assert(size == sizeof(T));
 
-            if (!pool().empty()) {
-                T* t = pool().top();
-                pool().pop();
-                return t;
-            }
+        static void destroyChunk(Chunk* chunk) {
+            chunk->~Chunk();
+            ::operator delete(chunk, std::align_val_t(chunkAlignment()));
+        }
+
+        static void addPartialChunk(SharedPool& pool, Chunk* chunk) {
+            assert(chunk->partialIndex == NotPartial);
+            chunk->partialIndex = pool.partialChunks.size();
+            pool.partialChunks.push_back(chunk);
+        }
+
+        static void removePartialChunk(SharedPool& pool, Chunk* chunk) {
+            assert(chunk->partialIndex < pool.partialChunks.size());
+            Chunk* last = pool.partialChunks.back();
+            pool.partialChunks[chunk->partialIndex] = last;
+            last->partialIndex = chunk->partialIndex;
+            pool.partialChunks.pop_back();
+            chunk->partialIndex = NotPartial;
+        }
 
-            Chunk* chunk = nullptr;
-            if (mixedChunks().empty()) {
-                if (!emptyChunks().empty()) {
-                    chunk = emptyChunks().back();
-                    emptyChunks().pop_back();
+        /**
+         * Takes the given number of blocks from the shared pool and returns them as a list.
+         */
+        static Block* acquireBlocks(size_t count) {
+            auto& pool = sharedPool();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+
+            Block* first = nullptr;
+            while (count > 0) {
+                Chunk* chunk = nullptr;
+                if (!pool.partialChunks.empty()) {
+                    chunk = pool.partialChunks.back();
+                    removePartialChunk(pool, chunk);
+                } else if (!pool.emptyChunks.empty()) {
+                    chunk = pool.emptyChunks.back();
+                    pool.emptyChunks.pop_back();
                 } else {
-                    chunk = new Chunk();
+                    chunk = createChunk();
                 }
-            } else {
-                chunk = mixedChunks().back();
-                mixedChunks().pop_back();
-            }
 
-            assert(!chunk->full());
-            T* block = chunk->allocate();
+                while (count > 0 && !chunk->full()) {
+                    Block* block = chunk->allocate();
+                    block->next = first;
+                    first = block;
+                    --count;
+                }
 
-            if (chunk->full()) {
-                fullChunks().push_back(chunk);
-            } else {
-                mixedChunks().push_back(chunk);
+                if (!chunk->full()) {
+                    addPartialChunk(pool, chunk);
+                }
             }
-            return block;
+            return first;
         }
 
-        void operator delete(void* block) {
-            T* t = reinterpret_cast<T*>(block);
-
-            if (PoolSize > 0 && pool().size() < PoolSize) {
-                pool().push(t);
+        /**
+         * Returns the given number of blocks from the given list to the shared pool.
+         */
+        static void releaseBlocks(Block* first, size_t count) {
+            if (count == 0) {
                 return;
             }
 
-            typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
-            fullIt = fullChunks().rbegin();
-            fullEnd = fullChunks().rend();
-            mixedIt = mixedChunks().rbegin();
-            mixedEnd = mixedChunks().rend();
-
-            Chunk* chunk = nullptr;
-            while (fullIt < fullEnd || mixedIt < mixedEnd) {
-                if (fullIt < fullEnd) {
-                    Chunk* fullChunk = *fullIt;
-                    if (fullChunk->contains(t)) {
-                        chunk = fullChunk;
-                        break;
+            auto& pool = sharedPool();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+
+            while (count > 0) {
+                assert(first != nullptr);
+                Block* block = first;
+                first = first->next;
+                --count;
+
+                Chunk* chunk = chunkOf(block);
+                const bool wasFull = chunk->full();
+                chunk->deallocate(block);
+
+                if (chunk->empty()) {
+                    if (!wasFull) {
+                        removePartialChunk(pool, chunk);
                     }
-                    ++fullIt;
-                }
-                if (mixedIt < mixedEnd) {
-                    Chunk* mixedChunk = *mixedIt;
-                    if (mixedChunk->contains(t)) {
-                        chunk = mixedChunk;
-                        break;
+                    if (pool.emptyChunks.size() < MaxEmptyChunks) {
+                        pool.emptyChunks.push_back(chunk);
+                    } else {
+                        destroyChunk(chunk);
                     }
-                    ++mixedIt;
+                } else if (wasFull) {
+                    addPartialChunk(pool, chunk);
                 }
             }
+        }
+    public:
+#ifdef TB_ENABLE_ALLOCATOR
+        void* operator new([[maybe_unused]] size_t size) {
+            assert(size == sizeof(T));
+
+            if (cacheDestroyed()) {
+                return acquireBlocks(1);
+            }
 
-            assert(chunk != nullptr);
+            auto& cache = threadCache();
+            if (cache.blockCount == 0) {
+                cache.firstBlock = acquireBlocks(CacheSize);
+                cache.blockCount = CacheSize;
+            }
 
-            if (chunk->full()) {
-                fullChunks().erase((fullIt + 1).base());
-                mixedChunks().push_back(chunk);
+            Block* block = cache.firstBlock;
+            cache.firstBlock = block->next;
+            --cache.blockCount;
+            return block;
+        }
+
+        void operator delete(void* pointer) {
+            if (pointer == nullptr) {
+                return;
+            }
+
+            Block* block = reinterpret_cast<Block*>(pointer);
+            if (cacheDestroyed()) {
+                block->next = nullptr;
+                releaseBlocks(block, 1);
+                return;
             }
 
-            chunk->deallocate(t);
+            auto& cache = threadCache();
+            block->next = cache.firstBlock;
+            cache.firstBlock = block;
+            ++cache.blockCount;
 
-            if (chunk->empty()) {
-                mixedChunks().erase((mixedIt + 1).base());
-                if (emptyChunks().size() < 2)
-                    emptyChunks().push_back(chunk);
-                else
-                    delete chunk;
+            if (cache.blockCount > 2 * CacheSize) {
+                // return the least recently freed blocks and keep the recently used ones, which are likely cached
+                Block* last = cache.firstBlock;
+                for (size_t i = 1; i < CacheSize; ++i) {
+                    last = last->next;
+                }
+                releaseBlocks(last->next, cache.blockCount - CacheSize);
+                last->next = nullptr;
+                cache.blockCount = CacheSize;
             }
         }
 #endif
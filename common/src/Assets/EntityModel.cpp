@@ -75,6 +75,9 @@ namespace TrenchBroom {
         float EntityModelLoadedFrame::intersect(const vm::ray3f& ray) const {
             auto closestDistance = vm::nan<float>();
 
+            // meshes are added one primitive at a time while the model is loaded, so freeze the tree on the first pick
+            // instead of after every insertion
+            m_spacialTree->freeze();
             const auto candidates = m_spacialTree->findIntersectors(ray);
             for (const TriNum triNum : candidates) {
                 const vm::vec3f& p1 = m_tris[triNum * 3 + 0];
@@ -23,6 +23,7 @@
 #include "Logger.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureName.h"
 #include "IO/TextureLoader.h"
 
 #include <kdl/map_utils.h>
@@ -121,6 +122,7 @@ namespace TrenchBroom {
             m_toPrepare.clear();
             m_texturesByName.clear();
             m_textures.clear();
+            m_texturesByIndex.clear();
 
             // Remove logging because it might fail when the document is already destroyed.
         }
@@ -150,6 +152,15 @@ namespace TrenchBroom {
             return const_cast<Texture*>(const_cast<const TextureManager*>(this)->texture(name));
         }
 
+        const Texture* TextureManager::texture(const TextureName& name) const {
+            const auto index = name.caseInsensitiveIndex();
+            return index < m_texturesByIndex.size() ? m_texturesByIndex[index] : nullptr;
+        }
+
+        Texture* TextureManager::texture(const TextureName& name) {
+            return const_cast<Texture*>(const_cast<const TextureManager*>(this)->texture(name));
+        }
+
         const std::vector<const Texture*>& TextureManager::textures() const {
             return m_textures;
         }
@@ -195,6 +206,15 @@ namespace TrenchBroom {
             }
 
             m_textures = kdl::vec_transform(kdl::map_values(m_texturesByName), [](auto* t) { return const_cast<const Texture*>(t); });
+
+            m_texturesByIndex.clear();
+            for (const auto& [key, texture] : m_texturesByName) {
+                const auto index = TextureName(key).caseInsensitiveIndex();
+                if (index >= m_texturesByIndex.size()) {
+                    m_texturesByIndex.resize(index + 1u, nullptr);
+                }
+                m_texturesByIndex[index] = texture;
+            }
         }
     }
 }
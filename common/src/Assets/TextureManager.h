@@ -36,6 +36,7 @@ namespace TrenchBroom {
     namespace Assets {
         class Texture;
         class TextureCollection;
+        class TextureName;
 
         class TextureManager {
         private:
@@ -51,6 +52,11 @@ namespace TrenchBroom {
             TextureMap m_texturesByName;
             std::vector<const Texture*> m_textures;
 
+            /**
+             * The textures indexed by the case insensitive index of their names, see TextureName.
+             */
+            std::vector<Texture*> m_texturesByIndex;
+
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
@@ -70,6 +76,8 @@ namespace TrenchBroom {
 
             const Texture* texture(const std::string& name) const;
             Texture* texture(const std::string& name);
+            const Texture* texture(const TextureName& name) const;
+            Texture* texture(const TextureName& name);
             
             const std::vector<const Texture*>& textures() const;
             const std::vector<TextureCollection>& collections() const;
@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureName.h"
+
+#include <kdl/string_format.h>
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Assets {
+        struct TextureName::Entry {
+            std::string name;
+            size_t caseInsensitiveIndex;
+        };
+
+        TextureName::TextureName() :
+        m_entry(intern("")) {}
+
+        TextureName::TextureName(const std::string_view name) :
+        m_entry(intern(name)) {}
+
+        const std::string& TextureName::str() const {
+            return m_entry->name;
+        }
+
+        bool TextureName::empty() const {
+            return m_entry->name.empty();
+        }
+
+        size_t TextureName::caseInsensitiveIndex() const {
+            return m_entry->caseInsensitiveIndex;
+        }
+
+        bool operator==(const TextureName& lhs, const TextureName& rhs) {
+            return lhs.m_entry == rhs.m_entry;
+        }
+
+        bool operator!=(const TextureName& lhs, const TextureName& rhs) {
+            return !(lhs == rhs);
+        }
+
+        std::ostream& operator<<(std::ostream& str, const TextureName& name) {
+            str << name.str();
+            return str;
+        }
+
+        const TextureName::Entry* TextureName::intern(const std::string_view name) {
+            // Entries are never removed or moved, so the keys can refer to the names stored in them. Every thread
+            // remembers the entries it has seen so that parsers running in parallel rarely need to lock the table.
+            using EntryMap = std::unordered_map<std::string_view, const Entry*>;
+            thread_local auto cache = EntryMap{};
+
+            if (const auto it = cache.find(name); it != std::end(cache)) {
+                return it->second;
+            }
+
+            struct Table {
+                std::mutex mutex;
+                std::unordered_map<std::string_view, std::unique_ptr<Entry>> entries;
+                std::unordered_map<std::string, size_t> caseInsensitiveIndices;
+            };
+
+            // the table is never destroyed so that texture names remain valid during static destruction
+            static auto* table = new Table{};
+
+            const auto* entry = [&]() -> const Entry* {
+                std::lock_guard<std::mutex> lock(table->mutex);
+                if (const auto it = table->entries.find(name); it != std::end(table->entries)) {
+                    return it->second.get();
+                }
+
+                const auto nextIndex = table->caseInsensitiveIndices.size();
+                const auto index = table->caseInsensitiveIndices.emplace(kdl::str_to_lower(name), nextIndex).first->second;
+                auto newEntry = std::make_unique<Entry>(Entry{std::string(name), index});
+                const auto* result = newEntry.get();
+                table->entries.emplace(result->name, std::move(newEntry));
+                return result;
+            }();
+
+            cache.emplace(entry->name, entry);
+            return entry;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom {
+    namespace Assets {
+        /**
+         * An interned texture name.
+         *
+         * All texture names are stored once in a process wide table, and a texture name only refers to its entry in
+         * that table. Copying and comparing texture names therefore does not touch the strings, and names that are
+         * equal when compared case insensitively share an index that can be used to look up textures. Entries are
+         * never removed from the table.
+         *
+         * Texture names can be created and used concurrently.
+         */
+        class TextureName {
+        private:
+            struct Entry;
+            const Entry* m_entry;
+        public:
+            /**
+             * Creates the empty texture name.
+             */
+            TextureName();
+
+            /**
+             * Creates a texture name with the given string, adding it to the table if necessary.
+             */
+            explicit TextureName(std::string_view name);
+
+            const std::string& str() const;
+            bool empty() const;
+
+            /**
+             * Returns an index that is shared by all names that are equal when compared case insensitively. Indices
+             * are assigned in increasing order starting at 0, so they can be used to index into a vector.
+             */
+            size_t caseInsensitiveIndex() const;
+
+            friend bool operator==(const TextureName& lhs, const TextureName& rhs);
+            friend bool operator!=(const TextureName& lhs, const TextureName& rhs);
+            friend std::ostream& operator<<(std::ostream& str, const TextureName& name);
+        private:
+            static const Entry* intern(std::string_view name);
+        };
+    }
+}
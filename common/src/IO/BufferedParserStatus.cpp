@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BufferedParserStatus.h"
+
+#include <cassert>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        BufferedParserStatus::BufferedParserStatus(ParserStatus& target) :
+        ParserStatus(target.m_logger, target.m_prefix),
+        m_target(target),
+        m_forwardedCount(0u) {}
+
+        size_t BufferedParserStatus::messageCount() const {
+            return m_messages.size();
+        }
+
+        void BufferedParserStatus::forward(const size_t messageCount) {
+            assert(messageCount <= m_messages.size());
+            while (m_forwardedCount < messageCount) {
+                const auto& message = m_messages[m_forwardedCount++];
+                m_target.doLog(message.level, message.str);
+            }
+        }
+
+        void BufferedParserStatus::forward() {
+            forward(m_messages.size());
+        }
+
+        void BufferedParserStatus::doProgress(const double /* progress */) {}
+
+        void BufferedParserStatus::doLog(const LogLevel level, const std::string& str) {
+            m_messages.push_back(Message{level, str});
+        }
+    }
+}
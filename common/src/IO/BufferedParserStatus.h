@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/ParserStatus.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Collects the messages logged by a parser and forwards them to another parser status on request. This allows
+         * parsing parts of a file concurrently while still logging the messages in file order.
+         *
+         * The messages are formatted using the prefix of the target status. Progress is ignored.
+         */
+        class BufferedParserStatus : public ParserStatus {
+        private:
+            struct Message {
+                LogLevel level;
+                std::string str;
+            };
+
+            ParserStatus& m_target;
+            std::vector<Message> m_messages;
+            size_t m_forwardedCount;
+        public:
+            explicit BufferedParserStatus(ParserStatus& target);
+
+            /**
+             * Returns the number of messages that were logged so far.
+             */
+            size_t messageCount() const;
+
+            /**
+             * Forwards the messages up to the given number of messages to the target status. Messages which were
+             * forwarded already are skipped.
+             *
+             * @param messageCount the number of messages that should have been forwarded after the call
+             */
+            void forward(size_t messageCount);
+
+            /**
+             * Forwards all remaining messages to the target status.
+             */
+            void forward();
+        private:
+            void doProgress(double progress) override;
+            void doLog(LogLevel level, const std::string& str) override;
+        };
+    }
+}
@@ -23,10 +23,17 @@
 
 #include "IO/DiskIO.h"
 #include "IO/File.h"
+#include "IO/PathQt.h"
+
+#include <kdl/string_format.h>
 
 #include <memory>
 #include <string>
 
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
 namespace TrenchBroom {
     namespace IO {
         DiskFileSystem::DiskFileSystem(const Path& root, const bool ensureExists) :
@@ -54,22 +61,152 @@ namespace TrenchBroom {
         }
 
         bool DiskFileSystem::doDirectoryExists(const Path& path) const {
-            return Disk::directoryExists(doMakeAbsolute(path));
+            const auto entry = findEntry(path.makeCanonical());
+            return entry && entry->second == EntryType::Directory;
         }
 
         bool DiskFileSystem::doFileExists(const Path& path) const {
-            return Disk::fileExists(doMakeAbsolute(path));
+            const auto entry = findEntry(path.makeCanonical());
+            return entry && entry->second == EntryType::File;
         }
 
         std::vector<Path> DiskFileSystem::doGetDirectoryContents(const Path& path) const {
-            return Disk::getDirectoryContents(doMakeAbsolute(path));
+            const auto entry = findEntry(path.makeCanonical());
+            if (entry && entry->second == EntryType::Directory) {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                if (const auto* directory = findDirectory(entry->first, true)) {
+                    return directory->contents;
+                }
+            }
+            throw FileSystemException("Cannot open directory: '" + doMakeAbsolute(path).asString() + "'");
         }
 
         std::shared_ptr<File> DiskFileSystem::doOpenFile(const Path& path) const {
-            auto file = Disk::openFile(doMakeAbsolute(path));
+            // open the file by the name it has on disk to avoid fixing the case of the path again
+            const auto entry = findEntry(path.makeCanonical());
+            auto file = Disk::openFile(entry ? m_root + entry->first : doMakeAbsolute(path));
             return std::make_shared<FileView>(path, file, 0u, file->size());
         }
 
+        void DiskFileSystem::doRefresh() {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_cache.clear();
+        }
+
+        // the precision of the modification times in milliseconds, FAT file systems only use two seconds
+        static const int64_t ModificationTimePrecision = 2000;
+
+        static std::optional<int64_t> directoryModificationTime(const Path& path) {
+            const auto info = QFileInfo(pathAsQString(path));
+            if (!info.exists() || !info.isDir()) {
+                return std::nullopt;
+            }
+            return info.lastModified().toMSecsSinceEpoch();
+        }
+
+        /**
+         * Finds the entry with the given canonical path like Disk::fixPath does, i.e., ignoring differences in case if
+         * the path does not match any entry exactly. Returns the path of the entry with the case used on disk and the
+         * type of the entry, or nothing if there is no such entry.
+         */
+        std::optional<std::pair<Path, DiskFileSystem::EntryType>> DiskFileSystem::findEntry(const Path& path) const {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+            auto result = std::make_pair(Path(), EntryType::Directory);
+            if (path.isEmpty()) {
+                if (!findDirectory(result.first, true)) {
+                    return std::nullopt;
+                }
+                return result;
+            }
+
+            const auto findInDirectory = [](const CachedDirectory* directory, const std::string& name) -> std::optional<std::pair<std::string, EntryType>> {
+                if (!directory) {
+                    return std::nullopt;
+                }
+                if (const auto it = directory->entryTypes.find(name); it != std::end(directory->entryTypes)) {
+                    return *it;
+                }
+                if (const auto it = directory->entryNames.find(kdl::str_to_lower(name)); it != std::end(directory->entryNames)) {
+                    return std::make_pair(it->second, directory->entryTypes.at(it->second));
+                }
+                return std::nullopt;
+            };
+
+            for (const auto& component : path.components()) {
+                if (result.second != EntryType::Directory) {
+                    return std::nullopt;
+                }
+
+                // if the entry cannot be found, it may have been created since the directory was cached
+                auto entry = findInDirectory(findDirectory(result.first, false), component);
+                if (!entry) {
+                    entry = findInDirectory(findDirectory(result.first, true), component);
+                }
+                if (!entry) {
+                    return std::nullopt;
+                }
+
+                result = std::make_pair(result.first + Path(entry->first), entry->second);
+            }
+
+            return result;
+        }
+
+        /**
+         * Returns the cached directory at the given path, which must have the case used on disk, or nullptr if there
+         * is no directory at the given path. If the directory was not cached yet, or if validate is true and its
+         * modification time has changed, the directory is listed again.
+         *
+         * Must be called with the cache mutex locked.
+         */
+        const DiskFileSystem::CachedDirectory* DiskFileSystem::findDirectory(const Path& path, const bool validate) const {
+            const auto key = path.asString("/");
+            auto it = m_cache.find(key);
+            if (it != std::end(m_cache) && !validate) {
+                return it->second.get();
+            }
+
+            // read the modification time before listing the directory so that later changes are detected
+            const auto listingTime = QDateTime::currentMSecsSinceEpoch();
+            const auto absolutePath = m_root + path;
+            const auto modificationTime = directoryModificationTime(absolutePath);
+            if (!modificationTime) {
+                if (it != std::end(m_cache)) {
+                    m_cache.erase(it);
+                }
+                return nullptr;
+            }
+
+            if (it != std::end(m_cache)) {
+                // A directory that was modified shortly before it was listed may have been modified again without
+                // changing its modification time due to the limited precision of the file system's timestamps.
+                const auto& cached = *it->second;
+                if (cached.modificationTime == *modificationTime && cached.listingTime - cached.modificationTime > ModificationTimePrecision) {
+                    return it->second.get();
+                }
+            }
+
+            auto directory = std::make_unique<CachedDirectory>();
+            directory->modificationTime = *modificationTime;
+            directory->listingTime = listingTime;
+
+            auto dir = QDir(pathAsQString(absolutePath));
+            dir.setFilter(QDir::NoDotAndDotDot | QDir::AllEntries);
+            for (const auto& info : dir.entryInfoList()) {
+                auto name = info.fileName().toStdString();
+                const auto type = info.isDir() ? EntryType::Directory : info.isFile() ? EntryType::File : EntryType::Other;
+
+                directory->contents.push_back(pathFromQString(info.fileName()));
+                directory->entryNames.emplace(kdl::str_to_lower(name), name);
+                directory->entryTypes.emplace(std::move(name), type);
+            }
+
+            auto* result = directory.get();
+            m_cache[key] = std::move(directory);
+            return result;
+        }
+
         WritableDiskFileSystem::WritableDiskFileSystem(const Path& root, const bool create) :
         WritableDiskFileSystem(nullptr, root, create) {}
 
@@ -83,22 +220,27 @@ namespace TrenchBroom {
 
         void WritableDiskFileSystem::doCreateFile(const Path& path, const std::string& contents) {
             Disk::createFile(doMakeAbsolute(path), contents);
+            doRefresh();
         }
 
         void WritableDiskFileSystem::doCreateDirectory(const Path& path) {
             Disk::createDirectory(doMakeAbsolute(path));
+            doRefresh();
         }
 
         void WritableDiskFileSystem::doDeleteFile(const Path& path) {
             Disk::deleteFile(doMakeAbsolute(path));
+            doRefresh();
         }
 
         void WritableDiskFileSystem::doCopyFile(const Path& sourcePath, const Path& destPath, const bool overwrite) {
             Disk::copyFile(doMakeAbsolute(sourcePath), doMakeAbsolute(destPath), overwrite);
+            doRefresh();
         }
 
         void WritableDiskFileSystem::doMoveFile(const Path& sourcePath, const Path& destPath, const bool overwrite) {
             Disk::moveFile(doMakeAbsolute(sourcePath), doMakeAbsolute(destPath), overwrite);
+            doRefresh();
         }
     }
 }
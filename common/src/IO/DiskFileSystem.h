@@ -22,16 +22,51 @@
 #include "IO/FileSystem.h"
 #include "IO/Path.h"
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
         class Path;
 
+        /**
+         * A file system for a directory on disk.
+         *
+         * The contents of the directories are cached when they are first accessed. A cached directory is listed again
+         * if its modification time has changed when it is listed or when an entry cannot be found in it, so that
+         * files and directories created by other programs are found. Entries that other programs removed are only
+         * forgotten when their directory is listed again or when the file system is refreshed.
+         */
         class DiskFileSystem : public FileSystem {
         protected:
             Path m_root;
+        private:
+            enum class EntryType {
+                File,
+                Directory,
+                Other
+            };
+
+            struct CachedDirectory {
+                int64_t modificationTime;
+                int64_t listingTime;
+                std::vector<Path> contents;
+                std::unordered_map<std::string, EntryType> entryTypes;
+                // maps the lower case names of the entries to their names on disk
+                std::unordered_map<std::string, std::string> entryNames;
+            };
+
+            /**
+             * The cached directories, keyed by their paths relative to the root with the case used on disk.
+             */
+            mutable std::unordered_map<std::string, std::unique_ptr<CachedDirectory>> m_cache;
+            mutable std::mutex m_cacheMutex;
         public:
             explicit DiskFileSystem(const Path& root, bool ensureExists = true);
             DiskFileSystem(std::shared_ptr<FileSystem> next, const Path& root, bool ensureExists = true);
@@ -46,6 +81,11 @@ namespace TrenchBroom {
 
             std::vector<Path> doGetDirectoryContents(const Path& path) const override;
             std::shared_ptr<File> doOpenFile(const Path& path) const override;
+
+            void doRefresh() override;
+        private:
+            std::optional<std::pair<Path, EntryType>> findEntry(const Path& path) const;
+            const CachedDirectory* findDirectory(const Path& path, bool validate) const;
         };
 
 #ifdef _MSC_VER
@@ -94,7 +94,8 @@ namespace TrenchBroom {
         }
 
         void DkPakFileSystem::doReadDirectory() {
-            auto reader = m_file->reader();
+            const auto archive = mapArchive();
+            auto reader = archive->reader();
             reader.seekFromBegin(DkPakLayout::HeaderMagicLength);
 
             const auto directoryAddress = reader.readSize<int32_t>();
@@ -112,12 +113,12 @@ namespace TrenchBroom {
                 const auto entrySize = compressed ? compressedSize : uncompressedSize;
 
                 const auto entryPath = Path(kdl::str_to_lower(entryName));
-                auto entryFile = std::make_shared<FileView>(entryPath, m_file, entryAddress, entrySize);
+                auto entry = std::make_unique<ArchiveFileEntry>(*this, entryPath, entryAddress, entrySize);
 
                 if (compressed) {
-                    m_root.addFile(entryPath, std::make_unique<DkCompressedFile>(entryFile, uncompressedSize));
+                    m_root.addFile(entryPath, std::make_unique<DkCompressedFile>(std::move(entry), uncompressedSize));
                 } else {
-                    m_root.addFile(entryPath, std::make_unique<SimpleFileEntry>(entryFile));
+                    m_root.addFile(entryPath, std::move(entry));
                 }
             }
         }
@@ -22,6 +22,19 @@
 #include "Exceptions.h"
 #include "IO/IOUtils.h"
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 namespace TrenchBroom {
     namespace IO {
         File::File(const Path& path) :
@@ -90,6 +103,93 @@ namespace TrenchBroom {
             return m_file;
         }
 
+        MappedFile::MappedFile(const Path& path) :
+        File(path),
+        m_begin(nullptr),
+        m_end(nullptr),
+        m_mapped(false) {
+            std::FILE* file = openPathAsFILE(path, "rb");
+            if (file == nullptr) {
+                throw FileSystemException("Cannot open file " + path.asString());
+            }
+
+            try {
+                load(file, fileSize(file));
+            } catch (...) {
+                std::fclose(file);
+                throw;
+            }
+
+            // a mapping remains valid after the file is closed
+            std::fclose(file);
+        }
+
+        MappedFile::~MappedFile() {
+            if (m_mapped) {
+#ifdef _WIN32
+                ::UnmapViewOfFile(m_begin);
+#else
+                ::munmap(const_cast<char*>(m_begin), size());
+#endif
+            }
+        }
+
+        Reader MappedFile::reader() const {
+            return Reader::from(m_begin, m_end);
+        }
+
+        size_t MappedFile::size() const {
+            return static_cast<size_t>(m_end - m_begin);
+        }
+
+        const char* MappedFile::begin() const {
+            return m_begin;
+        }
+
+        const char* MappedFile::end() const {
+            return m_end;
+        }
+
+        void MappedFile::load(std::FILE* file, const size_t size) {
+            if (size == 0) {
+                return;
+            }
+
+#ifdef _WIN32
+            const auto fileHandle = reinterpret_cast<HANDLE>(::_get_osfhandle(::_fileno(file)));
+            if (fileHandle != INVALID_HANDLE_VALUE) {
+                const HANDLE mapping = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping != nullptr) {
+                    const void* address = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+                    // the view keeps the mapping object alive
+                    ::CloseHandle(mapping);
+
+                    if (address != nullptr) {
+                        m_begin = static_cast<const char*>(address);
+                        m_end = m_begin + size;
+                        m_mapped = true;
+                        return;
+                    }
+                }
+            }
+#else
+            void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+            if (address != MAP_FAILED) {
+                m_begin = static_cast<const char*>(address);
+                m_end = m_begin + size;
+                m_mapped = true;
+                return;
+            }
+#endif
+
+            m_buffer = std::make_unique<char[]>(size);
+            if (std::fread(m_buffer.get(), 1, size, file) != size) {
+                throw FileSystemException("Cannot read file " + path().asString());
+            }
+            m_begin = m_buffer.get();
+            m_end = m_begin + size;
+        }
+
         FileView::FileView(const Path& path, std::shared_ptr<File> file, const size_t offset, const size_t length) :
         File(path),
         m_file(std::move(file)),
@@ -133,6 +133,55 @@ namespace TrenchBroom {
             std::FILE* file() const;
         };
 
+        /**
+         * A file that is backed by a physical file on the disk which is mapped into memory. Readers of this file
+         * access the mapped pages directly, so buffering the entire file does not copy its contents.
+         *
+         * The file is mapped with mmap on POSIX systems and with MapViewOfFile on Windows. If the file cannot be
+         * mapped, its contents are read into a memory buffer instead.
+         *
+         * On POSIX systems, the mapping does not prevent other processes from modifying the file. If the file is
+         * truncated while it is mapped, accessing the pages beyond its new end raises SIGBUS, which terminates the
+         * application. Therefore, instances of this class should not be kept alive longer than necessary for files
+         * that other programs might overwrite, such as map files. Windows does not allow truncating a file while it
+         * is mapped.
+         */
+        class MappedFile : public File {
+        private:
+            std::unique_ptr<char[]> m_buffer;
+            const char* m_begin;
+            const char* m_end;
+            bool m_mapped;
+        public:
+            /**
+             * Creates a new file with the given path and maps the file into memory.
+             *
+             * @param path the path of the file
+             *
+             * @throw FileSystemException if the file cannot be opened or read
+             */
+            explicit MappedFile(const Path& path);
+            ~MappedFile() override;
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            Reader reader() const override;
+            size_t size() const override;
+
+            /**
+             * Returns the start of the file contents in memory.
+             */
+            const char* begin() const;
+
+            /**
+             * Returns the end of the file contents in memory (position after the last byte).
+             */
+            const char* end() const;
+        private:
+            void load(std::FILE* file, size_t size);
+        };
+
         /**
          * A file that is backed by a portion of a physical file.
          */
@@ -22,6 +22,7 @@
 #include "Exceptions.h"
 #include "IO/FileMatcher.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <string>
@@ -143,6 +144,25 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<std::shared_ptr<File>> FileSystem::openFiles(const std::vector<Path>& paths) const {
+            auto result = std::vector<std::shared_ptr<File>>(paths.size());
+            kdl::parallel_for(0u, paths.size(), [&](const size_t i) {
+                try {
+                    result[i] = openFile(paths[i]);
+                } catch (const Exception&) {
+                    // leave the file empty, the caller can call openFile to get the reason
+                }
+            });
+            return result;
+        }
+
+        void FileSystem::refresh() {
+            doRefresh();
+            if (m_next) {
+                m_next->refresh();
+            }
+        }
+
         Path FileSystem::_makeAbsolute(const Path& path) const {
             if (doFileExists(path) || doDirectoryExists(path)) {
                 // If the file is present in this file system, make it absolute here.
@@ -192,6 +212,8 @@ namespace TrenchBroom {
             throw FileSystemException("Cannot make absolute path of '" + path.asString() + "'");
         }
 
+        void FileSystem::doRefresh() {}
+
         WritableFileSystem::WritableFileSystem() = default;
         WritableFileSystem::~WritableFileSystem() = default;
 
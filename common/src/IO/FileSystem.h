@@ -114,6 +114,24 @@ namespace TrenchBroom {
 
             std::vector<Path> getDirectoryContents(const Path& directoryPath) const;
             std::shared_ptr<File> openFile(const Path& path) const;
+
+            /**
+             * Opens the files with the given paths in parallel using the default thread pool. This lets file systems
+             * that decompress their files on opening, such as zip archives, decompress many files at once.
+             *
+             * Requires that the file systems in this chain can open files concurrently.
+             *
+             * @param paths the paths of the files to open
+             * @return the opened files in the order of the given paths, or nullptr for every file that could not be
+             * opened; call openFile to get the reason
+             */
+            std::vector<std::shared_ptr<File>> openFiles(const std::vector<Path>& paths) const;
+
+            /**
+             * Discards any information that this file system and the next file systems in the chain have cached
+             * about the files and directories on disk, so that changes made by other programs are picked up.
+             */
+            void refresh();
         private: // private API to be used for chaining, avoids multiple checks of parameters
             bool _canMakeAbsolute(const Path& path) const;
             Path _makeAbsolute(const Path& path) const;
@@ -207,6 +225,8 @@ namespace TrenchBroom {
             virtual std::vector<Path> doGetDirectoryContents(const Path& path) const = 0;
 
             virtual std::shared_ptr<File> doOpenFile(const Path& path) const = 0;
+
+            virtual void doRefresh();
         };
 
         class WritableFileSystem {
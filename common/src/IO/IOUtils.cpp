@@ -24,9 +24,13 @@
 #include "IO/Path.h"
 #include "IO/PathQt.h"
 
+#include <kdl/string_compare.h>
+
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <streambuf>
 #include <string>
@@ -135,5 +139,131 @@ namespace TrenchBroom {
             stream << "// Game: " << gameName << "\n"
                    << "// Format: " << mapFormat << "\n";
         }
+
+        std::optional<std::string_view> skipGameComment(std::string_view text, const std::string& gameName, const std::string& mapFormat) {
+            const auto skipLine = [&](const std::string& line) {
+                if (!kdl::cs::str_is_prefix(text, line)) {
+                    return false;
+                }
+                text.remove_prefix(line.size());
+
+                if (kdl::cs::str_is_prefix(text, "\r\n")) {
+                    text.remove_prefix(2u);
+                } else if (kdl::cs::str_is_prefix(text, "\n")) {
+                    text.remove_prefix(1u);
+                } else {
+                    return false;
+                }
+                return true;
+            };
+
+            if (!skipLine("// Game: " + gameName) || !skipLine("// Format: " + mapFormat)) {
+                return std::nullopt;
+            }
+            return text;
+        }
+
+        bool operator==(const TextHash& lhs, const TextHash& rhs) {
+            return lhs.size == rhs.size && lhs.hash == rhs.hash;
+        }
+
+        bool operator!=(const TextHash& lhs, const TextHash& rhs) {
+            return !(lhs == rhs);
+        }
+
+        static const std::uint64_t FnvOffsetBasis = 14695981039346656037ull;
+        static const std::uint64_t FnvPrime = 1099511628211ull;
+
+        TextHasher::TextHasher() :
+        m_hash(FnvOffsetBasis),
+        m_size(0u) {}
+
+        void TextHasher::add(std::string_view text) {
+            if (text.empty()) {
+                return;
+            }
+
+            auto pendingSize = m_size % sizeof(std::uint64_t);
+            m_size += text.size();
+
+            // complete the pending word first
+            if (pendingSize > 0u) {
+                const auto count = std::min(sizeof(std::uint64_t) - pendingSize, text.size());
+                std::memcpy(m_pending + pendingSize, text.data(), count);
+                text.remove_prefix(count);
+                pendingSize += count;
+
+                if (pendingSize < sizeof(std::uint64_t)) {
+                    return;
+                }
+                addWord(m_pending);
+            }
+
+            while (text.size() >= sizeof(std::uint64_t)) {
+                addWord(text.data());
+                text.remove_prefix(sizeof(std::uint64_t));
+            }
+
+            std::memcpy(m_pending, text.data(), text.size());
+        }
+
+        TextHash TextHasher::result() const {
+            auto hash = m_hash;
+            for (size_t i = 0u; i < m_size % sizeof(std::uint64_t); ++i) {
+                hash = (hash ^ static_cast<unsigned char>(m_pending[i])) * FnvPrime;
+            }
+            return TextHash{m_size, hash};
+        }
+
+        void TextHasher::addWord(const char* word) {
+            std::uint64_t value;
+            std::memcpy(&value, word, sizeof(std::uint64_t));
+            m_hash = (m_hash ^ value) * FnvPrime;
+            m_hash ^= m_hash >> 29u;
+        }
+
+        TextHash hashText(const std::string_view text) {
+            auto hasher = TextHasher();
+            hasher.add(text);
+            return hasher.result();
+        }
+
+        HashingOutputStream::Buffer::Buffer(std::ostream& target) :
+        m_target(target) {}
+
+        TextHash HashingOutputStream::Buffer::hash() const {
+            return m_hasher.result();
+        }
+
+        HashingOutputStream::Buffer::int_type HashingOutputStream::Buffer::overflow(const int_type c) {
+            if (traits_type::eq_int_type(c, traits_type::eof())) {
+                return traits_type::not_eof(c);
+            }
+
+            const auto ch = traits_type::to_char_type(c);
+            return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+        }
+
+        std::streamsize HashingOutputStream::Buffer::xsputn(const char* s, const std::streamsize count) {
+            if (!m_target.write(s, count)) {
+                return 0;
+            }
+            m_hasher.add(std::string_view(s, static_cast<size_t>(count)));
+            return count;
+        }
+
+        int HashingOutputStream::Buffer::sync() {
+            return m_target.flush() ? 0 : -1;
+        }
+
+        HashingOutputStream::HashingOutputStream(std::ostream& target) :
+        std::ostream(nullptr),
+        m_buffer(target) {
+            rdbuf(&m_buffer);
+        }
+
+        TextHash HashingOutputStream::hash() const {
+            return m_buffer.hash();
+        }
     }
 }
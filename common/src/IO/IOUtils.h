@@ -21,10 +21,15 @@
 
 #include "Macros.h"
 
+#include <cstdint>
 #include <cstdio> // for FILE
 #include <iosfwd>
 #include <fstream>
+#include <optional>
+#include <ostream>
+#include <streambuf>
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
@@ -51,5 +56,86 @@ namespace TrenchBroom {
         std::string readInfoComment(std::istream& stream, const std::string& name);
 
         void writeGameComment(std::ostream& stream, const std::string& gameName, const std::string& mapFormat);
+
+        /**
+         * Returns the remainder of the given text if it starts with the comment that writeGameComment writes for the
+         * given game and map format, and nothing otherwise. The lines of the comment may end with LF or CRLF.
+         */
+        std::optional<std::string_view> skipGameComment(std::string_view text, const std::string& gameName, const std::string& mapFormat);
+
+        /**
+         * The size and hash of a text. Used to detect whether a file was changed since it was written.
+         */
+        struct TextHash {
+            size_t size;
+            std::uint64_t hash;
+        };
+
+        bool operator==(const TextHash& lhs, const TextHash& rhs);
+        bool operator!=(const TextHash& lhs, const TextHash& rhs);
+
+        /**
+         * Computes the hash of a text that is given in several consecutive pieces. The result does not depend on how
+         * the text is split into pieces.
+         *
+         * The hash is FNV-1a over 64 bit words with an additional shift to mix the upper bits into the lower bits, and
+         * the bytes that do not fill a whole word are hashed one by one. This is not a cryptographic hash, it only
+         * needs to detect that a file was changed.
+         */
+        class TextHasher {
+        private:
+            std::uint64_t m_hash;
+            size_t m_size;
+            char m_pending[sizeof(std::uint64_t)];
+        public:
+            TextHasher();
+
+            void add(std::string_view text);
+
+            /**
+             * Returns the size and hash of the text added so far.
+             */
+            TextHash result() const;
+        private:
+            void addWord(const char* word);
+        };
+
+        TextHash hashText(std::string_view text);
+
+        /**
+         * An output stream that passes everything written to it on to another stream and hashes it along the way, so
+         * that the hash of a file can be obtained without reading the file again after writing it.
+         *
+         * If the target stream is a file stream, it must be opened in binary mode. Otherwise, line endings may be
+         * converted when they are written, and the hash would not match the contents of the file.
+         */
+        class HashingOutputStream : public std::ostream {
+        private:
+            class Buffer : public std::streambuf {
+            private:
+                std::ostream& m_target;
+                TextHasher m_hasher;
+            public:
+                explicit Buffer(std::ostream& target);
+
+                TextHash hash() const;
+            protected:
+                int_type overflow(int_type c) override;
+                std::streamsize xsputn(const char* s, std::streamsize count) override;
+                int sync() override;
+            };
+
+            Buffer m_buffer;
+        public:
+            explicit HashingOutputStream(std::ostream& target);
+
+            /**
+             * Returns the hash of the text written to this stream so far, which is equal to the result of calling
+             * hashText for that text.
+             */
+            TextHash hash() const;
+
+            deleteCopyAndMove(HashingOutputStream)
+        };
     }
 }
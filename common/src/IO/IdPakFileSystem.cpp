@@ -49,7 +49,8 @@ namespace TrenchBroom {
         void IdPakFileSystem::doReadDirectory() {
             char magic[PakLayout::HeaderMagicLength];
 
-            auto reader = m_file->reader();
+            const auto archive = mapArchive();
+            auto reader = archive->reader();
             reader.seekForward(PakLayout::HeaderAddress);
             reader.read(magic, PakLayout::HeaderMagicLength);
 
@@ -65,8 +66,7 @@ namespace TrenchBroom {
                 const auto entrySize = reader.readSize<int32_t>();
 
                 const auto entryPath = Path(kdl::str_to_lower(entryName));
-                auto entryFile = std::make_shared<FileView>(entryPath, m_file, entryAddress, entrySize);
-                m_root.addFile(entryPath, entryFile);
+                m_root.addFile(entryPath, std::make_unique<ArchiveFileEntry>(*this, entryPath, entryAddress, entrySize));
             }
         }
     }
@@ -20,11 +20,17 @@
 #include "ImageFileSystem.h"
 
 #include "Ensure.h"
+#include "Exceptions.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
 
+#include <kdl/string_format.h>
+
 #include <cassert>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -41,13 +47,16 @@ namespace TrenchBroom {
             return m_file;
         }
 
-        ImageFileSystemBase::CompressedFileEntry::CompressedFileEntry(std::shared_ptr<File> file, const size_t uncompressedSize) :
-        m_file(file),
-        m_uncompressedSize(uncompressedSize) {}
+        ImageFileSystemBase::CompressedFileEntry::CompressedFileEntry(std::unique_ptr<FileEntry> entry, const size_t uncompressedSize) :
+        m_entry(std::move(entry)),
+        m_uncompressedSize(uncompressedSize) {
+            ensure(m_entry != nullptr, "entry is null");
+        }
 
         std::shared_ptr<File> ImageFileSystemBase::CompressedFileEntry::doOpen() const {
-            auto data = decompress(m_file, m_uncompressedSize);
-            return std::make_shared<OwningBufferFile>(m_file->path(), std::move(data), m_uncompressedSize);
+            const auto file = m_entry->open();
+            auto data = decompress(file, m_uncompressedSize);
+            return std::make_shared<OwningBufferFile>(file->path(), std::move(data), m_uncompressedSize);
         }
 
         ImageFileSystemBase::Directory::Directory(const Path& path) :
@@ -143,6 +152,18 @@ namespace TrenchBroom {
             return contents;
         }
 
+        void ImageFileSystemBase::Directory::addToIndex(const std::string& key, std::unordered_map<std::string, const FileEntry*>& fileIndex, std::unordered_set<std::string>& directoryIndex) const {
+            directoryIndex.insert(key);
+
+            const auto prefix = key.empty() ? key : key + "/";
+            for (const auto& [name, directory] : m_directories) {
+                directory->addToIndex(prefix + kdl::str_to_lower(name.asString()), fileIndex, directoryIndex);
+            }
+            for (const auto& [name, file] : m_files) {
+                fileIndex[prefix + kdl::str_to_lower(name.asString())] = file.get();
+            }
+        }
+
         ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findOrCreateDirectory(const Path& path) {
             if (path.isEmpty()) {
                 return *this;
@@ -167,41 +188,104 @@ namespace TrenchBroom {
         void ImageFileSystemBase::initialize() {
             try {
                 doReadDirectory();
+                buildIndex();
             } catch (const std::exception& e) {
                 throw FileSystemException("Could not initialize image file system '" + m_path.asString() + "': " + e.what());
             }
         }
 
         void ImageFileSystemBase::reload() {
+            m_fileIndex.clear();
+            m_directoryIndex.clear();
             m_root = Directory(Path());
             initialize();
         }
 
+        void ImageFileSystemBase::buildIndex() {
+            m_fileIndex.clear();
+            m_directoryIndex.clear();
+            m_root.addToIndex("", m_fileIndex, m_directoryIndex);
+        }
+
+        /**
+         * Returns the key of the given path in the indices. The key is the canonical form of the path in lower case
+         * with its components separated by slashes. It is built without creating any intermediate paths.
+         *
+         * @throw PathException if the path cannot be made canonical
+         */
+        std::string ImageFileSystemBase::indexKey(const Path& path) {
+            std::string key;
+            std::vector<size_t> componentStarts;
+            for (const auto& component : path.components()) {
+                if (component == ".") {
+                    continue;
+                }
+                if (component == "..") {
+                    if (componentStarts.empty()) {
+                        throw PathException("Cannot resolve path");
+                    }
+                    key.resize(componentStarts.back());
+                    componentStarts.pop_back();
+                    continue;
+                }
+
+                componentStarts.push_back(key.size());
+                if (!key.empty()) {
+                    key.push_back('/');
+                }
+                for (const auto c : component) {
+                    key.push_back(kdl::str_to_lower(c));
+                }
+            }
+            return key;
+        }
+
         bool ImageFileSystemBase::doDirectoryExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.directoryExists(searchPath);
+            return m_directoryIndex.count(indexKey(path)) > 0u;
         }
 
         bool ImageFileSystemBase::doFileExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.fileExists(searchPath);
+            return m_fileIndex.count(indexKey(path)) > 0u;
         }
 
         std::vector<Path> ImageFileSystemBase::doGetDirectoryContents(const Path& path) const {
             const auto searchPath = path.makeLowerCase().makeCanonical();
-            const auto& directory = m_root.findDirectory(path);
+            const auto& directory = m_root.findDirectory(searchPath);
             return directory.contents();
         }
 
         std::shared_ptr<File> ImageFileSystemBase::doOpenFile(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.findFile(path).open();
+            const auto it = m_fileIndex.find(indexKey(path));
+            if (it == std::end(m_fileIndex)) {
+                throw FileSystemException("File not found: '" + path.asString() + "'");
+            }
+            return it->second->open();
+        }
+
+        ImageFileSystem::ArchiveFileEntry::ArchiveFileEntry(const ImageFileSystem& fileSystem, const Path& path, const size_t offset, const size_t length) :
+        m_fileSystem(fileSystem),
+        m_path(path),
+        m_offset(offset),
+        m_length(length) {}
+
+        std::shared_ptr<File> ImageFileSystem::ArchiveFileEntry::doOpen() const {
+            // the view keeps the archive mapped for as long as it is alive
+            return std::make_shared<FileView>(m_path, m_fileSystem.mapArchive(), m_offset, m_length);
         }
 
         ImageFileSystem::ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
-        ImageFileSystemBase(std::move(next), path),
-        m_file(std::make_shared<CFile>(path)) {
+        ImageFileSystemBase(std::move(next), path) {
             ensure(m_path.isAbsolute(), "path must be absolute");
         }
+
+        std::shared_ptr<MappedFile> ImageFileSystem::mapArchive() const {
+            std::lock_guard<std::mutex> lock(m_archiveMutex);
+            auto archive = m_archive.lock();
+            if (archive == nullptr) {
+                archive = std::make_shared<MappedFile>(m_path);
+                m_archive = archive;
+            }
+            return archive;
+        }
     }
 }
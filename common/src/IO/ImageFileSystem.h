@@ -26,11 +26,15 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace TrenchBroom {
     namespace IO {
-        class CFile;
         class File;
+        class MappedFile;
 
         class ImageFileSystemBase : public FileSystem {
         protected:
@@ -54,10 +58,10 @@ namespace TrenchBroom {
 
             class CompressedFileEntry : public FileEntry {
             private:
-                std::shared_ptr<File> m_file;
+                std::unique_ptr<FileEntry> m_entry;
                 const size_t m_uncompressedSize;
             public:
-                CompressedFileEntry(std::shared_ptr<File> file, size_t uncompressedSize);
+                CompressedFileEntry(std::unique_ptr<FileEntry> entry, size_t uncompressedSize);
                 ~CompressedFileEntry() override = default;
             private:
                 std::shared_ptr<File> doOpen() const override;
@@ -84,12 +88,21 @@ namespace TrenchBroom {
                 const Directory& findDirectory(const Path& path) const;
                 const FileEntry& findFile(const Path& path) const;
                 std::vector<Path> contents() const;
+
+                void addToIndex(const std::string& key, std::unordered_map<std::string, const FileEntry*>& fileIndex, std::unordered_set<std::string>& directoryIndex) const;
             private:
                 Directory& findOrCreateDirectory(const Path& path);
             };
         protected:
             Path m_path;
             Directory m_root;
+        private:
+            /**
+             * Flat indices of all files and directories in m_root, keyed by their normalised lower case paths. These
+             * are used to look up files and directories without walking the directory tree.
+             */
+            std::unordered_map<std::string, const FileEntry*> m_fileIndex;
+            std::unordered_set<std::string> m_directoryIndex;
         protected:
             ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path);
         public:
@@ -102,6 +115,9 @@ namespace TrenchBroom {
              */
             void reload();
         private:
+            void buildIndex();
+            static std::string indexKey(const Path& path);
+
             bool doDirectoryExists(const Path& path) const override;
             bool doFileExists(const Path& path) const override;
 
@@ -111,11 +127,44 @@ namespace TrenchBroom {
             virtual void doReadDirectory() = 0;
         };
 
+        /**
+         * An image file system that is backed by an archive file on the disk, such as a pak or wad file.
+         *
+         * The archive is memory mapped only while its directory is read and while files opened from it are alive.
+         * Other programs may rebuild an archive while it is in use, e.g. texture tools overwrite wad files, and on
+         * POSIX systems, reading from a mapping of a file that was truncated terminates the application.
+         */
         class ImageFileSystem : public ImageFileSystemBase {
         protected:
-            std::shared_ptr<CFile> m_file;
+            /**
+             * An entry that is stored in the archive without compression.
+             */
+            class ArchiveFileEntry : public FileEntry {
+            private:
+                const ImageFileSystem& m_fileSystem;
+                Path m_path;
+                size_t m_offset;
+                size_t m_length;
+            public:
+                ArchiveFileEntry(const ImageFileSystem& fileSystem, const Path& path, size_t offset, size_t length);
+            private:
+                std::shared_ptr<File> doOpen() const override;
+            };
+        private:
+            mutable std::mutex m_archiveMutex;
+            mutable std::weak_ptr<MappedFile> m_archive;
         protected:
             ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
+
+            /**
+             * Maps the archive into memory, or returns the existing mapping if it is still in use. The archive is
+             * unmapped when the returned file and all files opened from it have been destroyed.
+             *
+             * Threadsafe
+             *
+             * @throw FileSystemException if the archive cannot be opened
+             */
+            std::shared_ptr<MappedFile> mapArchive() const;
         };
     }
 }
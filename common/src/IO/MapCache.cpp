@@ -0,0 +1,574 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Model/AttributableNode.h"
+#include "Model/Brush.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/LockState.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/VisibilityState.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace MapCache {
+            namespace {
+                constexpr char Magic[] = { 'T', 'B', 'M', 'C' };
+                constexpr uint32_t Version = 2u;
+
+                // the hash of the preceding contents of the file, followed by the magic number
+                constexpr size_t TrailerSize = sizeof(uint64_t) + sizeof(Magic);
+
+                enum class NodeType : uint8_t {
+                    DefaultLayer,
+                    Layer,
+                    Group,
+                    Entity,
+                    Brush
+                };
+
+                class CacheWriter {
+                private:
+                    HashingOutputStream m_stream;
+                    bool m_parallelTexCoordSystem;
+                public:
+                    CacheWriter(std::ostream& stream, const Model::MapFormat format) :
+                    m_stream(stream),
+                    m_parallelTexCoordSystem(Model::isParallelTexCoordSystem(format)) {}
+
+                    void writeHeader(const std::string_view mapText, const std::string& gameName, const Model::MapFormat format, const vm::bbox3& worldBounds) {
+                        m_stream.write(Magic, sizeof(Magic));
+                        write(Version);
+                        const auto hash = hashText(mapText);
+                        write(static_cast<uint64_t>(hash.size));
+                        write(hash.hash);
+                        writeString(gameName);
+                        write(static_cast<int32_t>(format));
+                        writeVec(worldBounds.min);
+                        writeVec(worldBounds.max);
+                    }
+
+                    void writeWorld(const Model::WorldNode& world) {
+                        writeAttributes(world.entity());
+                        writeNodeState(world);
+                        writeChildren(world);
+
+                        write(m_stream.hash().hash);
+                        m_stream.write(Magic, sizeof(Magic));
+                    }
+                private:
+                    template <typename T>
+                    void write(const T value) {
+                        static_assert(std::is_arithmetic_v<T>);
+                        m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+                    }
+
+                    void writeNodeType(const NodeType type) {
+                        write(static_cast<uint8_t>(type));
+                    }
+
+                    void writeSize(const size_t size) {
+                        write(static_cast<uint64_t>(size));
+                    }
+
+                    void writeString(const std::string& str) {
+                        writeSize(str.size());
+                        m_stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+                    }
+
+                    template <typename T, size_t S>
+                    void writeVec(const vm::vec<T,S>& vec) {
+                        for (size_t i = 0u; i < S; ++i) {
+                            write(vec[i]);
+                        }
+                    }
+
+                    void writeAttributes(const Model::Entity& entity) {
+                        writeSize(entity.attributes().size());
+                        for (const auto& attribute : entity.attributes()) {
+                            writeString(attribute.name());
+                            writeString(attribute.value());
+                        }
+                    }
+
+                    void writeNodeState(const Model::Node& node) {
+                        writeSize(node.lineNumber());
+                        writeSize(node.lineCount());
+                        write(static_cast<int32_t>(node.visibilityState()));
+                        write(static_cast<int32_t>(node.lockState()));
+                    }
+
+                    void writeChildren(const Model::Node& node) {
+                        writeSize(node.children().size());
+                        for (const auto* child : node.children()) {
+                            writeNode(*child);
+                        }
+                    }
+
+                    void writeNode(const Model::Node& node) {
+                        node.accept(kdl::overload(
+                            [] (const Model::WorldNode*) {},
+                            [&](const Model::LayerNode* layer) {
+                                writeNodeType(layer->isDefaultLayer() ? NodeType::DefaultLayer : NodeType::Layer);
+                                writeAttributes(layer->entity());
+                                writeNodeState(*layer);
+                                writeChildren(*layer);
+                            },
+                            [&](const Model::GroupNode* group) {
+                                writeNodeType(NodeType::Group);
+                                writeAttributes(group->entity());
+                                writeNodeState(*group);
+                                writeChildren(*group);
+                            },
+                            [&](const Model::EntityNode* entity) {
+                                writeNodeType(NodeType::Entity);
+                                writeAttributes(entity->entity());
+                                writeNodeState(*entity);
+                                writeChildren(*entity);
+                            },
+                            [&](const Model::BrushNode* brush) {
+                                writeNodeType(NodeType::Brush);
+                                writeNodeState(*brush);
+                                writeBrush(brush->brush());
+                            }
+                        ));
+                    }
+
+                    void writeBrush(const Model::Brush& brush) {
+                        writeSize(brush.faceCount());
+                        for (const auto& face : brush.faces()) {
+                            writeFace(face);
+                        }
+
+                        std::unordered_map<const Model::BrushVertex*, uint32_t> vertexIndices;
+                        writeSize(brush.vertexCount());
+                        for (const auto* vertex : brush.vertices()) {
+                            vertexIndices.emplace(vertex, static_cast<uint32_t>(vertexIndices.size()));
+                            writeVec(vertex->position());
+                        }
+
+                        for (const auto& face : brush.faces()) {
+                            const auto& boundary = face.geometry()->boundary();
+                            write(static_cast<uint32_t>(boundary.size()));
+                            for (const auto* halfEdge : boundary) {
+                                write(vertexIndices.at(halfEdge->origin()));
+                            }
+                        }
+                    }
+
+                    void writeFace(const Model::BrushFace& face) {
+                        for (const auto& point : face.points()) {
+                            writeVec(point);
+                        }
+
+                        const auto& attributes = face.attributes();
+                        writeString(attributes.textureName());
+                        writeVec(attributes.offset());
+                        writeVec(attributes.scale());
+                        write(attributes.rotation());
+                        write(static_cast<int32_t>(attributes.surfaceContents()));
+                        write(static_cast<int32_t>(attributes.surfaceFlags()));
+                        write(attributes.surfaceValue());
+                        writeVec(attributes.color());
+
+                        if (m_parallelTexCoordSystem) {
+                            writeVec(face.textureXAxis());
+                            writeVec(face.textureYAxis());
+                        }
+
+                        writeSize(face.lineNumber());
+                        writeSize(face.lineCount());
+                    }
+                };
+
+                class CacheReader {
+                private:
+                    struct NodeInfo {
+                        Model::Node* parent;
+                        std::unique_ptr<Model::Node> node;
+                    };
+
+                    struct BrushInfo {
+                        Model::Node* parent;
+                        std::vector<Model::BrushFace> faces;
+                        std::vector<vm::vec3> vertices;
+                        std::vector<std::vector<size_t>> faceVertices;
+                        size_t lineNumber;
+                        size_t lineCount;
+                        Model::VisibilityState visibilityState;
+                        Model::LockState lockState;
+                    };
+
+                    using ObjectInfo = std::variant<NodeInfo, BrushInfo>;
+
+                    Reader m_reader;
+                    Model::MapFormat m_format;
+                    bool m_parallelTexCoordSystem;
+                    std::vector<ObjectInfo> m_objectInfos;
+                public:
+                    CacheReader(Reader reader, const Model::MapFormat format) :
+                    m_reader(std::move(reader)),
+                    m_format(format),
+                    m_parallelTexCoordSystem(Model::isParallelTexCoordSystem(format)) {}
+
+                    bool readHeader(const std::string_view mapText, const std::string& gameName, const vm::bbox3& worldBounds) {
+                        if (!readMagic()
+                            || read<uint32_t>() != Version
+                            || readSize() != mapText.size()
+                            || read<uint64_t>() != hashText(mapText).hash
+                            || readString() != gameName
+                            || read<int32_t>() != static_cast<int32_t>(m_format)) {
+                            return false;
+                        }
+
+                        const auto min = readVec<double, 3>();
+                        const auto max = readVec<double, 3>();
+                        return min == worldBounds.min && max == worldBounds.max;
+                    }
+
+                    /**
+                     * Checks that the contents of the cache file match the hash stored at its end.
+                     */
+                    bool checkContents() {
+                        if (m_reader.size() < TrailerSize) {
+                            return false;
+                        }
+
+                        const auto contentsSize = m_reader.size() - TrailerSize;
+                        const auto position = m_reader.position();
+                        m_reader.seekFromBegin(contentsSize);
+                        const auto hash = read<uint64_t>();
+                        const auto hasMagic = readMagic();
+                        m_reader.seekFromBegin(position);
+
+                        const auto contents = m_reader.subReaderFromBegin(0u, contentsSize).buffer();
+                        return hasMagic && hash == hashText(contents.stringView()).hash;
+                    }
+
+                    std::unique_ptr<Model::WorldNode> readWorld() {
+                        auto world = std::make_unique<Model::WorldNode>(Model::Entity(readAttributes()), m_format);
+                        world->disableNodeTreeUpdates();
+                        readNodeState(*world);
+                        readChildren(*world, world.get());
+
+                        if (m_reader.position() != m_reader.size() - TrailerSize) {
+                            return nullptr;
+                        }
+
+                        auto brushInfos = std::vector<BrushInfo*>();
+                        for (auto& objectInfo : m_objectInfos) {
+                            if (auto* brushInfo = std::get_if<BrushInfo>(&objectInfo)) {
+                                brushInfos.push_back(brushInfo);
+                            }
+                        }
+
+                        auto brushes = kdl::vec_parallel_transform(brushInfos, [](BrushInfo* brushInfo) {
+                            return Model::Brush::createFromTopology(std::move(brushInfo->faces), brushInfo->vertices, brushInfo->faceVertices);
+                        });
+
+                        // don't modify the world until all brushes were created successfully
+                        for (const auto& brush : brushes) {
+                            if (!brush.is_success()) {
+                                return nullptr;
+                            }
+                        }
+
+                        size_t brushIndex = 0u;
+                        for (auto& objectInfo : m_objectInfos) {
+                            std::visit(kdl::overload(
+                                [&](NodeInfo& nodeInfo) {
+                                    nodeInfo.parent->addChild(nodeInfo.node.release());
+                                },
+                                [&](BrushInfo& brushInfo) {
+                                    std::move(brushes[brushIndex++]).visit(kdl::overload(
+                                        [&](Model::Brush&& brush) {
+                                            auto* brushNode = world->createBrush(std::move(brush));
+                                            brushNode->setFilePosition(brushInfo.lineNumber, brushInfo.lineCount);
+                                            brushNode->setVisibilityState(brushInfo.visibilityState);
+                                            brushNode->setLockState(brushInfo.lockState);
+                                            brushInfo.parent->addChild(brushNode);
+                                        },
+                                        [](const Model::BrushError) {}
+                                    ));
+                                }
+                            ), objectInfo);
+                        }
+
+                        world->enableNodeTreeUpdates();
+                        return world;
+                    }
+                private:
+                    template <typename T>
+                    T read() {
+                        return m_reader.read<T, T>();
+                    }
+
+                    size_t readSize() {
+                        return m_reader.readSize<uint64_t>();
+                    }
+
+                    bool readMagic() {
+                        char magic[sizeof(Magic)];
+                        m_reader.read(magic, sizeof(Magic));
+                        return std::memcmp(magic, Magic, sizeof(Magic)) == 0;
+                    }
+
+                    std::string readString() {
+                        const auto size = readSize();
+                        if (!m_reader.canRead(size)) {
+                            throw ReaderException("String size exceeds cache file size");
+                        }
+                        return m_reader.readString(size);
+                    }
+
+                    template <typename T, size_t S>
+                    vm::vec<T,S> readVec() {
+                        return m_reader.readVec<T, S>();
+                    }
+
+                    std::vector<Model::EntityAttribute> readAttributes() {
+                        auto attributes = std::vector<Model::EntityAttribute>();
+                        const auto count = readSize();
+                        for (size_t i = 0u; i < count; ++i) {
+                            auto name = readString();
+                            auto value = readString();
+                            attributes.emplace_back(std::move(name), std::move(value));
+                        }
+                        return attributes;
+                    }
+
+                    void readNodeState(Model::Node& node) {
+                        const auto lineNumber = readSize();
+                        const auto lineCount = readSize();
+                        node.setFilePosition(lineNumber, lineCount);
+                        node.setVisibilityState(readVisibilityState());
+                        node.setLockState(readLockState());
+                    }
+
+                    Model::VisibilityState readVisibilityState() {
+                        const auto state = static_cast<Model::VisibilityState>(read<int32_t>());
+                        switch (state) {
+                            case Model::VisibilityState::Visibility_Inherited:
+                            case Model::VisibilityState::Visibility_Hidden:
+                            case Model::VisibilityState::Visibility_Shown:
+                                return state;
+                            default:
+                                throw ReaderException("Unknown visibility state in cache file");
+                        }
+                    }
+
+                    Model::LockState readLockState() {
+                        const auto state = static_cast<Model::LockState>(read<int32_t>());
+                        switch (state) {
+                            case Model::LockState::Lock_Inherited:
+                            case Model::LockState::Lock_Locked:
+                            case Model::LockState::Lock_Unlocked:
+                                return state;
+                            default:
+                                throw ReaderException("Unknown lock state in cache file");
+                        }
+                    }
+
+                    void readChildren(Model::WorldNode& world, Model::Node* parent) {
+                        const auto count = readSize();
+                        for (size_t i = 0u; i < count; ++i) {
+                            readNode(world, parent);
+                        }
+                    }
+
+                    void readNode(Model::WorldNode& world, Model::Node* parent) {
+                        const auto type = static_cast<NodeType>(read<uint8_t>());
+                        switch (type) {
+                            case NodeType::DefaultLayer: {
+                                auto* layer = world.defaultLayer();
+                                layer->setEntity(Model::Entity(readAttributes()));
+                                readNodeState(*layer);
+                                readChildren(world, layer);
+                                break;
+                            }
+                            case NodeType::Layer:
+                                readAttributableNode(world, parent, std::unique_ptr<Model::AttributableNode>(world.createLayer("")));
+                                break;
+                            case NodeType::Group:
+                                readAttributableNode(world, parent, std::unique_ptr<Model::AttributableNode>(world.createGroup("")));
+                                break;
+                            case NodeType::Entity:
+                                readAttributableNode(world, parent, std::unique_ptr<Model::AttributableNode>(world.createEntity(Model::Entity())));
+                                break;
+                            case NodeType::Brush:
+                                readBrush(parent);
+                                break;
+                            default:
+                                throw ReaderException("Unknown node type in cache file");
+                        }
+                    }
+
+                    void readAttributableNode(Model::WorldNode& world, Model::Node* parent, std::unique_ptr<Model::AttributableNode> node) {
+                        auto* nodePtr = node.get();
+                        nodePtr->setEntity(Model::Entity(readAttributes()));
+                        readNodeState(*nodePtr);
+
+                        // the children must be added after their parent to preserve the file order
+                        m_objectInfos.push_back(NodeInfo{parent, std::move(node)});
+                        readChildren(world, nodePtr);
+                    }
+
+                    void readBrush(Model::Node* parent) {
+                        const auto lineNumber = readSize();
+                        const auto lineCount = readSize();
+                        const auto visibilityState = readVisibilityState();
+                        const auto lockState = readLockState();
+
+                        auto faces = std::vector<Model::BrushFace>();
+                        const auto faceCount = readSize();
+                        for (size_t i = 0u; i < faceCount; ++i) {
+                            faces.push_back(readFace());
+                        }
+
+                        auto vertices = std::vector<vm::vec3>();
+                        const auto vertexCount = readSize();
+                        for (size_t i = 0u; i < vertexCount; ++i) {
+                            vertices.push_back(readVec<double, 3>());
+                        }
+
+                        auto faceVertices = std::vector<std::vector<size_t>>(faceCount);
+                        for (auto& indices : faceVertices) {
+                            const auto indexCount = read<uint32_t>();
+                            for (uint32_t i = 0u; i < indexCount; ++i) {
+                                indices.push_back(read<uint32_t>());
+                            }
+                        }
+
+                        m_objectInfos.push_back(BrushInfo{parent, std::move(faces), std::move(vertices), std::move(faceVertices), lineNumber, lineCount, visibilityState, lockState});
+                    }
+
+                    Model::BrushFace readFace() {
+                        const auto point0 = readVec<double, 3>();
+                        const auto point1 = readVec<double, 3>();
+                        const auto point2 = readVec<double, 3>();
+
+                        auto attributes = Model::BrushFaceAttributes(readString());
+                        attributes.setOffset(readVec<float, 2>());
+                        attributes.setScale(readVec<float, 2>());
+                        attributes.setRotation(read<float>());
+                        attributes.setSurfaceContents(read<int32_t>());
+                        attributes.setSurfaceFlags(read<int32_t>());
+                        attributes.setSurfaceValue(read<float>());
+                        attributes.setColor(Color(readVec<float, 4>()));
+
+                        auto texCoordSystem = [&]() -> Model::TexCoordSystemVariant {
+                            if (m_parallelTexCoordSystem) {
+                                const auto xAxis = readVec<double, 3>();
+                                const auto yAxis = readVec<double, 3>();
+                                return Model::ParallelTexCoordSystem(xAxis, yAxis);
+                            } else {
+                                return Model::ParaxialTexCoordSystem(point0, point1, point2, attributes);
+                            }
+                        }();
+
+                        const auto lineNumber = readSize();
+                        const auto lineCount = readSize();
+
+                        return Model::BrushFace::create(point0, point1, point2, attributes, std::move(texCoordSystem))
+                            .visit(kdl::overload(
+                                [&](Model::BrushFace&& face) {
+                                    face.setFilePosition(lineNumber, lineCount);
+                                    return std::move(face);
+                                },
+                                [](const Model::BrushError) -> Model::BrushFace {
+                                    throw ReaderException("Invalid brush face in cache file");
+                                }
+                            ));
+                    }
+                };
+            }
+
+            Path cachePath(const Path& mapPath) {
+                return mapPath.addExtension("tbcache");
+            }
+
+            std::unique_ptr<Model::WorldNode> readWorld(const Path& path, const std::string_view mapText, const std::string& gameName, const Model::MapFormat format, const vm::bbox3& worldBounds) {
+                try {
+                    if (!Disk::fileExists(path)) {
+                        return nullptr;
+                    }
+
+                    const auto file = Disk::openFile(path);
+                    CacheReader reader(file->reader(), format);
+                    if (!reader.readHeader(mapText, gameName, worldBounds) || !reader.checkContents()) {
+                        return nullptr;
+                    }
+
+                    return reader.readWorld();
+                } catch (const Exception&) {
+                    return nullptr;
+                }
+            }
+
+            void writeWorld(const Path& path, const Model::WorldNode& world, const std::string_view mapText, const std::string& gameName, const vm::bbox3& worldBounds) {
+                std::ofstream stream = openPathAsOutputStream(path, std::ios::out | std::ios::binary);
+                if (!stream) {
+                    throw FileSystemException("Cannot open file: " + path.asString());
+                }
+
+                CacheWriter writer(stream, world.format());
+                writer.writeHeader(mapText, gameName, world.format(), worldBounds);
+                writer.writeWorld(world);
+
+                if (!stream) {
+                    throw FileSystemException("Cannot write file: " + path.asString());
+                }
+            }
+        }
+    }
+}
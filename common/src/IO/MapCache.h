@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+#include "Model/MapFormat.h"
+
+#include <vecmath/forward.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom {
+    namespace Model {
+        class WorldNode;
+    }
+
+    namespace IO {
+        class Path;
+
+        /**
+         * A map cache is a binary file stored next to a map file. It contains the node hierarchy of the map, the
+         * entity attributes, the brush faces and the geometry of every brush, so that an unchanged map can be
+         * loaded without parsing it and without building the brush geometry again.
+         *
+         * A cache file is only valid for the map text, game, map format and world bounds it was created with. If any
+         * of these don't match, the map must be loaded from its text instead. The cache file ends with a hash of its
+         * contents, so that a damaged cache file is detected before it is read.
+         */
+        namespace MapCache {
+            /**
+             * Returns the path of the cache file for the map file at the given path.
+             */
+            Path cachePath(const Path& mapPath);
+
+            /**
+             * Reads a world from the cache file at the given path. The cache file is memory mapped.
+             *
+             * @param path the path of the cache file
+             * @param mapText the contents of the map file
+             * @param gameName the name of the game
+             * @param format the map format
+             * @param worldBounds the world bounds
+             * @return the world, or nullptr if the cache file does not exist, was not created for the given map text,
+             * game, format and world bounds, or if its contents don't match their hash
+             */
+            std::unique_ptr<Model::WorldNode> readWorld(const Path& path, std::string_view mapText, const std::string& gameName, Model::MapFormat format, const vm::bbox3& worldBounds);
+
+            /**
+             * Writes the given world to a cache file at the given path. The world must have been read from the given
+             * map text and must not have been modified since.
+             *
+             * @param path the path of the cache file
+             * @param world the world to write
+             * @param mapText the contents of the map file
+             * @param gameName the name of the game
+             * @param worldBounds the world bounds
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            void writeWorld(const Path& path, const Model::WorldNode& world, std::string_view mapText, const std::string& gameName, const vm::bbox3& worldBounds);
+        }
+    }
+}
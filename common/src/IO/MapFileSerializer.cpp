@@ -22,25 +22,24 @@
 #include "Ensure.h"
 #include "Exceptions.h"
 #include "Macros.h"
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/EntityAttributes.h"
-#include "Model/EntityNode.h"
-#include "Model/GroupNode.h"
-#include "Model/LayerNode.h"
-#include "Model/WorldNode.h"
 
-#include <kdl/overload.h>
 #include <kdl/parallel.h>
-#include <kdl/vector_utils.h>
+#include <kdl/string_compare.h>
+#include <kdl/thread_pool.h>
 
 #include <fmt/format.h>
 
-#include <iterator> // for std::ostreambuf_iterator
+#include <iterator> // for std::back_inserter
 #include <memory>
-#include <utility> // for std::pair
+#include <ostream>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
 
 namespace TrenchBroom {
     namespace IO {
@@ -49,16 +48,16 @@ namespace TrenchBroom {
             explicit QuakeFileSerializer(std::ostream& stream) :
             MapFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         protected:
-            void writeFacePoints(std::ostream& stream, const Model::BrushFace& face) const {
+            void writeFacePoints(std::string& str, const Model::BrushFace& face) const {
                 const Model::BrushFace::Points& points = face.points();
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "( {} {} {} ) ( {} {} {} ) ( {} {} {} )",
+                fmt::format_to(std::back_inserter(str), "( {} {} {} ) ( {} {} {} ) ( {} {} {} )",
                                points[0].x(),
                                points[0].y(),
                                points[0].z(),
@@ -70,10 +69,10 @@ namespace TrenchBroom {
                                points[2].z());
             }
 
-            void writeTextureInfo(std::ostream& stream, const Model::BrushFace& face) const {
+            void writeTextureInfo(std::string& str, const Model::BrushFace& face) const {
                 const std::string& textureName = face.attributes().textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face.attributes().textureName();
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {} {} {} {}",
+                fmt::format_to(std::back_inserter(str), " {} {} {} {} {} {}",
                                textureName,
                                face.attributes().xOffset(),
                                face.attributes().yOffset(),
@@ -82,12 +81,12 @@ namespace TrenchBroom {
                                face.attributes().yScale());
             }
 
-            void writeValveTextureInfo(std::ostream& stream, const Model::BrushFace& face) const {
+            void writeValveTextureInfo(std::string& str, const Model::BrushFace& face) const {
                 const std::string& textureName = face.attributes().textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face.attributes().textureName();
                 const vm::vec3 xAxis = face.textureXAxis();
                 const vm::vec3 yAxis = face.textureYAxis();
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}",
+                fmt::format_to(std::back_inserter(str), " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}",
                                textureName,
 
                                xAxis.x(),
@@ -111,19 +110,19 @@ namespace TrenchBroom {
             explicit Quake2FileSerializer(std::ostream& stream) :
             QuakeFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
 
                 // Neverball's "mapc" doesn't like it if surface attributes aren't present.
                 // This suggests the Radiants always output these, so it's probably a compatibility danger.
-                writeSurfaceAttributes(stream, face);
+                writeSurfaceAttributes(str, face);
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         protected:
-            void writeSurfaceAttributes(std::ostream& stream, const Model::BrushFace& face) const {
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {}",
+            void writeSurfaceAttributes(std::string& str, const Model::BrushFace& face) const {
+                fmt::format_to(std::back_inserter(str), " {} {} {}",
                                face.attributes().surfaceContents(),
                                face.attributes().surfaceFlags(),
                                face.attributes().surfaceValue());
@@ -135,12 +134,12 @@ namespace TrenchBroom {
             explicit Quake2ValveFileSerializer(std::ostream& stream) :
             Quake2FileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
-                writeSurfaceAttributes(stream, face);
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeValveTextureInfo(str, face);
+                writeSurfaceAttributes(str, face);
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         };
 
@@ -152,22 +151,22 @@ namespace TrenchBroom {
             Quake2FileSerializer(stream),
             SurfaceColorFormat(" %d %d %d") {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
 
                 if (face.attributes().hasSurfaceAttributes() || face.attributes().hasColor()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(str, face);
                 }
                 if (face.attributes().hasColor()) {
-                    writeSurfaceColor(stream, face);
+                    writeSurfaceColor(str, face);
                 }
 
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         protected:
-            void writeSurfaceColor(std::ostream& stream, const Model::BrushFace& face) const {
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {}",
+            void writeSurfaceColor(std::string& str, const Model::BrushFace& face) const {
+                fmt::format_to(std::back_inserter(str), " {} {} {}",
                                static_cast<int>(face.attributes().color().r()),
                                static_cast<int>(face.attributes().color().g()),
                                static_cast<int>(face.attributes().color().b()));
@@ -179,10 +178,10 @@ namespace TrenchBroom {
             explicit Hexen2FileSerializer(std::ostream& stream):
             QuakeFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), " 0\n"); // extra value written here
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeTextureInfo(str, face);
+                fmt::format_to(std::back_inserter(str), " 0\n"); // extra value written here
             }
         };
 
@@ -191,14 +190,24 @@ namespace TrenchBroom {
             explicit ValveFileSerializer(std::ostream& stream) :
             QuakeFileSerializer(stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
-                fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+            void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const override {
+                writeFacePoints(str, face);
+                writeValveTextureInfo(str, face);
+                fmt::format_to(std::back_inserter(str), "\n");
             }
         };
 
         std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream& stream) {
+            return createSerializer(format, stream);
+        }
+
+        std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream& stream, PreviousMapFile previousFile) {
+            auto serializer = createSerializer(format, stream);
+            serializer->m_previousFile = std::move(previousFile);
+            return serializer;
+        }
+
+        std::unique_ptr<MapFileSerializer> MapFileSerializer::createSerializer(const Model::MapFormat format, std::ostream& stream) {
             switch (format) {
                 case Model::MapFormat::Standard:
                     return std::make_unique<QuakeFileSerializer>(stream);
@@ -222,88 +231,226 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * A chunk is flushed once it contains this many brushes or this many bytes of text.
+         */
+        static const size_t ChunkBrushCount = 2048u;
+        static const size_t ChunkTextSize = 1u << 20u;
+
         MapFileSerializer::MapFileSerializer(std::ostream& stream) :
         m_line(1),
-        m_stream(stream) {}
-
-        void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootNodes) {
-            ensure(m_nodeToPrecomputedString.empty(), "MapFileSerializer may not be reused");
-
-            // collect brushes
-            std::vector<const Model::BrushNode*> brushNodes;
-            brushNodes.reserve(rootNodes.size());
-
-            Model::Node::visitAll(rootNodes, kdl::overload(
-                [](auto&& thisLambda, const Model::WorldNode* world) { world->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::GroupNode* group) { group->visitChildren(thisLambda); },
-                [](auto&& thisLambda, const Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
-                [&](const Model::BrushNode* brush) {
-                    brushNodes.push_back(brush);
-                }
-            ));
+        m_stream(stream),
+        m_currentChunk(0u),
+        m_writeTask(std::make_unique<kdl::task_group>()),
+        m_previousLine(1u),
+        m_previousOffset(0u) {}
 
-            // serialize brushes to strings in parallel
-            using NodeString = std::pair<const Model::Node*, std::string>;
-            std::vector<NodeString> result = kdl::vec_parallel_transform(brushNodes,
-                [&](const Model::BrushNode* node) -> NodeString {
-                    std::string string = writeBrushFaces(node->brush());
-                    return NodeString(node, std::move(string));
-                });
+        MapFileSerializer::~MapFileSerializer() = default;
 
-            // move strings into a map
-            for (auto& [node, string]: result) {
-                m_nodeToPrecomputedString[node] = std::move(string);
-            }
+        void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {
+            ensure(m_line == 1u, "MapFileSerializer may not be reused");
+        }
+
+        void MapFileSerializer::doEndFile() {
+            flushChunk();
+            waitForWrite();
         }
-        void MapFileSerializer::doEndFile() {}
 
         void MapFileSerializer::doBeginEntity(const Model::Node* /* node */) {
-            fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
+            auto& text = currentChunk().text;
+            fmt::format_to(std::back_inserter(text), "// entity {}\n", entityNo());
             ++m_line;
             m_startLineStack.push_back(m_line);
-            fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+            fmt::format_to(std::back_inserter(text), "{{\n");
             ++m_line;
         }
 
         void MapFileSerializer::doEndEntity(const Model::Node* node) {
-            fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+            fmt::format_to(std::back_inserter(currentChunk().text), "}}\n");
             ++m_line;
             setFilePosition(node);
         }
 
         void MapFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
-            fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "\"{}\" \"{}\"\n",
+            fmt::format_to(std::back_inserter(currentChunk().text), "\"{}\" \"{}\"\n",
                            escapeEntityAttribute( attribute.name()),
                            escapeEntityAttribute(attribute.value()));
             ++m_line;
         }
 
         void MapFileSerializer::doBrush(const Model::BrushNode* brush) {
-            fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
-            ++m_line;
-            m_startLineStack.push_back(m_line);
-            fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+            auto& chunk = currentChunk();
+            fmt::format_to(std::back_inserter(chunk.text), "// brush {}\n", brushNo());
             ++m_line;
 
-            // write pre-serialized brush faces
-            auto it = m_nodeToPrecomputedString.find(brush);
-            ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a brush which was not passed to doBeginFile");
-            const std::string& precomputedString = it->second;
-            m_stream << precomputedString;
+            const size_t start = m_line;
+            const size_t faceCount = brush->brush().faceCount();
+            if (const auto text = previousBrushLines(brush)) {
+                appendLines(chunk.text, *text);
+            } else {
+                fmt::format_to(std::back_inserter(chunk.text), "{{\n");
 
-            fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
-            ++m_line;
-            setFilePosition(brush);
+                // the faces are formatted when the chunk is flushed, every face takes up one line
+                chunk.brushes.emplace_back(chunk.text.size(), &brush->brush());
+
+                fmt::format_to(std::back_inserter(chunk.text), "}}\n");
+            }
+
+            size_t faceLine = start + 1u;
+            for (const auto& face : brush->brush().faces()) {
+                face.setFilePosition(faceLine++, 1u);
+            }
+            m_line = start + faceCount + 2u;
+            brush->setFilePosition(start, m_line - start);
         }
 
         void MapFileSerializer::doBrushFace(const Model::BrushFace& face) {
             const size_t lines = 1u;
-            doWriteBrushFace(m_stream, face);
+            doWriteBrushFace(currentChunk().text, face);
             face.setFilePosition(m_line, lines);
             m_line += lines;
         }
 
+        /**
+         * Appends the given lines to the given string. If the lines end with CRLF, as they do if the previous file was
+         * written in text mode on Windows, the carriage returns are removed because maps are written with LF line endings.
+         */
+        static void appendLines(std::string& str, const std::string_view lines) {
+            if (lines.find('\r') == std::string_view::npos) {
+                str.append(lines);
+                return;
+            }
+
+            for (size_t i = 0u; i < lines.size(); ++i) {
+                if (lines[i] != '\r' || i + 1u == lines.size() || lines[i + 1u] != '\n') {
+                    str.push_back(lines[i]);
+                }
+            }
+        }
+
+        /**
+         * Checks whether the given text is a block of lines enclosed in braces.
+         */
+        static bool isBlock(const std::string_view text) {
+            return kdl::cs::str_is_prefix(text, "{") && (kdl::cs::str_is_suffix(text, "}\n") || kdl::cs::str_is_suffix(text, "}\r\n"));
+        }
+
+        /**
+         * Copies the entity written for the given node from the previous file if the node was not modified. The
+         * file positions of the node and its brushes are checked against the previous file, and if they don't match,
+         * the entity is serialized again.
+         */
+        bool MapFileSerializer::doWriteUnchangedEntity(const Model::Node* node, const std::vector<const Model::BrushNode*>& brushNodes) {
+            if (!m_previousFile || m_previousFile->isModified(node)) {
+                return false;
+            }
+
+            // the entity consists of an opening brace, its attributes, its brushes and a closing brace
+            const size_t lineNumber = node->lineNumber();
+            const size_t lineCount = node->lineCount();
+            if (lineNumber == 0u || lineCount < 2u) {
+                return false;
+            }
+
+            // every brush is preceded by a comment and must directly follow the previous brush
+            size_t nextBrushLine = lineNumber + 2u;
+            for (const auto* brushNode : brushNodes) {
+                if (brushNode->lineNumber() < nextBrushLine ||
+                    (brushNode != brushNodes.front() && brushNode->lineNumber() != nextBrushLine) ||
+                    brushNode->lineCount() != brushNode->brush().faceCount() + 2u) {
+                    return false;
+                }
+                nextBrushLine = brushNode->lineNumber() + brushNode->lineCount() + 1u;
+            }
+            if (!brushNodes.empty() && nextBrushLine != lineNumber + lineCount) {
+                return false;
+            }
+
+            const auto text = previousLines(lineNumber, lineCount);
+            if (!text || !isBlock(*text)) {
+                return false;
+            }
+
+            auto& chunk = currentChunk();
+            fmt::format_to(std::back_inserter(chunk.text), "// entity {}\n", entityNo());
+            ++m_line;
+            appendLines(chunk.text, *text);
+
+            node->setFilePosition(m_line, lineCount);
+            for (const auto* brushNode : brushNodes) {
+                const size_t brushLine = m_line + (brushNode->lineNumber() - lineNumber);
+                brushNode->setFilePosition(brushLine, brushNode->lineCount());
+
+                size_t faceLine = brushLine + 1u;
+                for (const auto& face : brushNode->brush().faces()) {
+                    face.setFilePosition(faceLine++, 1u);
+                }
+            }
+            m_line += lineCount;
+
+            return true;
+        }
+
+        /**
+         * Returns the lines of the given brush in the previous file, including its braces, if the brush was not
+         * modified. Copying the brush is what keeps an edit to a single brush of a large entity such as the
+         * worldspawn from formatting all of its other brushes again.
+         */
+        std::optional<std::string_view> MapFileSerializer::previousBrushLines(const Model::BrushNode* brush) {
+            if (!m_previousFile || m_previousFile->isModified(brush)) {
+                return std::nullopt;
+            }
+
+            const size_t lineNumber = brush->lineNumber();
+            const size_t lineCount = brush->lineCount();
+            if (lineNumber == 0u || lineCount != brush->brush().faceCount() + 2u) {
+                return std::nullopt;
+            }
+
+            const auto text = previousLines(lineNumber, lineCount);
+            if (!text || !isBlock(*text)) {
+                return std::nullopt;
+            }
+            return text;
+        }
+
+        /**
+         * Returns the given range of lines of the previous file, or nothing if the previous file does not contain
+         * these lines. The lines are found by scanning the previous file from the end of the last range that was
+         * requested, so requesting the entities in the order in which they were written is efficient.
+         */
+        std::optional<std::string_view> MapFileSerializer::previousLines(const size_t lineNumber, const size_t lineCount) {
+            const auto& text = m_previousFile->text;
+            if (lineNumber < m_previousLine) {
+                m_previousLine = 1u;
+                m_previousOffset = 0u;
+            }
+
+            const auto skipLines = [&](size_t offset, const size_t count) -> std::optional<size_t> {
+                for (size_t i = 0u; i < count; ++i) {
+                    const auto end = text.find('\n', offset);
+                    if (end == std::string_view::npos) {
+                        return std::nullopt;
+                    }
+                    offset = end + 1u;
+                }
+                return offset;
+            };
+
+            const auto begin = skipLines(m_previousOffset, lineNumber - m_previousLine);
+            if (!begin) {
+                return std::nullopt;
+            }
+            const auto end = skipLines(*begin, lineCount);
+            if (!end) {
+                return std::nullopt;
+            }
+
+            m_previousLine = lineNumber + lineCount;
+            m_previousOffset = *end;
+            return text.substr(*begin, *end - *begin);
+        }
+
         void MapFileSerializer::setFilePosition(const Model::Node* node) {
             const size_t start = startLine();
             node->setFilePosition(start, m_line - start);
@@ -316,15 +463,70 @@ namespace TrenchBroom {
             return result;
         }
 
+        /**
+         * Returns the chunk that is currently being collected. If that chunk is full, it is flushed first, and the
+         * other chunk is returned.
+         */
+        MapFileSerializer::Chunk& MapFileSerializer::currentChunk() {
+            const auto& chunk = m_chunks[m_currentChunk];
+            if (chunk.brushes.size() >= ChunkBrushCount || chunk.text.size() >= ChunkTextSize) {
+                flushChunk();
+            }
+            return m_chunks[m_currentChunk];
+        }
+
+        /**
+         * Formats the brush faces of the current chunk in parallel and starts writing it to the stream. The chunk
+         * that was written before must have been written completely before its buffers can be used to collect the
+         * next chunk.
+         */
+        void MapFileSerializer::flushChunk() {
+            auto& chunk = m_chunks[m_currentChunk];
+
+            // keep the strings of the previous chunks to reuse their memory
+            if (chunk.brushFaces.size() < chunk.brushes.size()) {
+                chunk.brushFaces.resize(chunk.brushes.size());
+            }
+            kdl::parallel_for(0u, chunk.brushes.size(), [&](const size_t i) {
+                auto& str = chunk.brushFaces[i];
+                str.clear();
+                writeBrushFaces(str, *chunk.brushes[i].second);
+            });
+
+            waitForWrite();
+            m_writeTask->run([&stream = m_stream, &chunk]() {
+                writeChunk(stream, chunk);
+            });
+
+            m_currentChunk = 1u - m_currentChunk;
+            auto& nextChunk = m_chunks[m_currentChunk];
+            nextChunk.text.clear();
+            nextChunk.brushes.clear();
+        }
+
+        void MapFileSerializer::waitForWrite() {
+            m_writeTask->wait();
+        }
+
+        void MapFileSerializer::writeChunk(std::ostream& stream, const Chunk& chunk) {
+            size_t offset = 0u;
+            for (size_t i = 0u; i < chunk.brushes.size(); ++i) {
+                const auto brushOffset = chunk.brushes[i].first;
+                const auto& brushFaces = chunk.brushFaces[i];
+                stream.write(chunk.text.data() + offset, static_cast<std::streamsize>(brushOffset - offset));
+                stream.write(brushFaces.data(), static_cast<std::streamsize>(brushFaces.size()));
+                offset = brushOffset;
+            }
+            stream.write(chunk.text.data() + offset, static_cast<std::streamsize>(chunk.text.size() - offset));
+        }
+
         /**
          * Threadsafe
          */
-        std::string MapFileSerializer::writeBrushFaces(const Model::Brush& brush) const {
-            std::stringstream stream;
+        void MapFileSerializer::writeBrushFaces(std::string& str, const Model::Brush& brush) const {
             for (const Model::BrushFace& face : brush.faces()) {
-                doWriteBrushFace(stream, face);
+                doWriteBrushFace(str, face);
             }
-            return stream.str();
         }
     }
 }
@@ -22,10 +22,19 @@
 #include "IO/NodeSerializer.h"
 #include "Model/MapFormat.h"
 
+#include <functional>
 #include <iosfwd>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility> // for std::pair
 #include <vector>
 
+namespace kdl {
+    class task_group;
+}
+
 namespace TrenchBroom {
     namespace Model {
         class Brush;
@@ -36,15 +45,62 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        /**
+         * The text of a map file that was previously written by a MapFileSerializer, without any header, and a
+         * predicate that indicates which nodes were modified since then.
+         *
+         * An entity is copied from the previous text if the predicate returns false for the node that it was written
+         * for, i.e. the world, a layer, a group or an entity. The predicate must therefore return true for a node if
+         * its attributes, its parent, or any of its brushes were modified, or if any brushes were added or removed.
+         * Copying an entity requires that the file positions of the node and its brushes refer to the previous text,
+         * and that the layer and group IDs have not changed.
+         *
+         * If an entity must be written again, its brushes are still copied from the previous text unless the
+         * predicate returns true for them.
+         */
+        struct PreviousMapFile {
+            std::string_view text;
+            std::function<bool(const Model::Node*)> isModified;
+        };
+
+        /**
+         * Writes a map file to a stream.
+         *
+         * The output is collected in chunks. The faces of the brushes in a chunk are formatted in parallel when the
+         * chunk is full, and then the chunk is written to the stream by a task of the process wide thread pool while
+         * the next chunk is being collected. Two chunks are used in turn so that their buffers can be reused, which
+         * limits the amount of memory used regardless of the size of the map.
+         *
+         * If a previous map file is given, unmodified entities are copied from it instead of being serialized again.
+         */
         class MapFileSerializer : public NodeSerializer {
         private:
+            /**
+             * The text of a chunk, and the brushes whose faces must be inserted into it. Each brush stores the
+             * offset in the text at which its faces are inserted.
+             */
+            struct Chunk {
+                std::string text;
+                std::vector<std::pair<size_t, const Model::Brush*>> brushes;
+                std::vector<std::string> brushFaces;
+            };
+
             using LineStack = std::vector<size_t>;
             LineStack m_startLineStack;
             size_t m_line;
             std::ostream& m_stream;
-            std::unordered_map<const Model::Node*, std::string> m_nodeToPrecomputedString;
+
+            Chunk m_chunks[2];
+            size_t m_currentChunk;
+            std::unique_ptr<kdl::task_group> m_writeTask;
+
+            std::optional<PreviousMapFile> m_previousFile;
+            size_t m_previousLine;
+            size_t m_previousOffset;
         public:
             static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream& stream);
+            static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream& stream, PreviousMapFile previousFile);
+            ~MapFileSerializer() override;
         protected:
             explicit MapFileSerializer(std::ostream& stream);
         private:
@@ -56,12 +112,22 @@ namespace TrenchBroom {
             void doEntityAttribute(const Model::EntityAttribute& attribute) override;
             void doBrush(const Model::BrushNode* brush) override;
             void doBrushFace(const Model::BrushFace& face) override;
+            bool doWriteUnchangedEntity(const Model::Node* node, const std::vector<const Model::BrushNode*>& brushNodes) override;
         private:
+            static std::unique_ptr<MapFileSerializer> createSerializer(Model::MapFormat format, std::ostream& stream);
+            std::optional<std::string_view> previousBrushLines(const Model::BrushNode* brush);
+            std::optional<std::string_view> previousLines(size_t lineNumber, size_t lineCount);
+
             void setFilePosition(const Model::Node* node);
             size_t startLine();
+
+            Chunk& currentChunk();
+            void flushChunk();
+            void waitForWrite();
+            static void writeChunk(std::ostream& stream, const Chunk& chunk);
         private: // threadsafe
-            virtual void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const = 0;
-            std::string writeBrushFaces(const Model::Brush& brush) const;
+            virtual void doWriteBrushFace(std::string& str, const Model::BrushFace& face) const = 0;
+            void writeBrushFaces(std::string& str, const Model::Brush& brush) const;
         };
     }
 }
@@ -19,6 +19,7 @@
 
 #include "MapReader.h"
 
+#include "IO/BufferedParserStatus.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
@@ -35,6 +36,7 @@
 
 #include <kdl/map_utils.h>
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
@@ -42,6 +44,7 @@
 
 #include <map>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom {
@@ -76,15 +79,31 @@ namespace TrenchBroom {
         m_brushParent(nullptr),
         m_currentNode(nullptr) {}
 
+        MapReader::~MapReader() = default;
+
         void MapReader::readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(format, status);
+            m_parseStatus = std::make_unique<BufferedParserStatus>(status);
+            try {
+                parseEntities(format, *m_parseStatus);
+            } catch (...) {
+                m_parseStatus->forward();
+                throw;
+            }
+            createNodes(status);
             resolveNodes(status);
         }
 
         void MapReader::readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseBrushes(format, status);
+            m_parseStatus = std::make_unique<BufferedParserStatus>(status);
+            try {
+                parseBrushes(format, *m_parseStatus);
+            } catch (...) {
+                m_parseStatus->forward();
+                throw;
+            }
+            createNodes(status);
         }
 
         void MapReader::readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -127,8 +146,8 @@ namespace TrenchBroom {
             assert(m_faces.empty());
         }
 
-        void MapReader::onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
-            createBrush(startLine, lineCount, extraAttributes, status);
+        void MapReader::onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& /* status */) {
+            storeBrush(startLine, lineCount, extraAttributes);
         }
 
         void MapReader::onStandardBrushFace(const size_t line, const Model::MapFormat /* format */, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, ParserStatus& status) {
@@ -207,7 +226,7 @@ namespace TrenchBroom {
             setExtraAttributes(layerNode, extraAttributes);
             m_layers.insert(std::make_pair(layerId, layerNode));
 
-            onLayer(layerNode, status);
+            m_objectInfos.push_back(LayerInfo{std::unique_ptr<Model::LayerNode>(layerNode)});
 
             m_currentNode = layerNode;
             m_brushParent = layerNode;
@@ -260,25 +279,68 @@ namespace TrenchBroom {
             m_brushParent = entity;
         }
 
-        void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
-            Model::Brush::create(m_worldBounds, std::move(m_faces))
-                .and_then(
-                    [&](Model::Brush&& b) {
-                        Model::BrushNode* brushNode = m_factory->createBrush(std::move(b));
-                        setFilePosition(brushNode, startLine, lineCount);
-                        setExtraAttributes(brushNode, extraAttributes);
-                        
-                        onBrush(m_brushParent, brushNode, status);
-                        m_faces.clear();
-                        
-                        return kdl::void_result;
-                    }
-                ).handle_errors(
-                    [&](const Model::BrushError e) {
-                        status.error(startLine, kdl::str_to_string("Skipping brush: ", e));
-                        m_faces.clear();
+        void MapReader::storeBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes) {
+            const auto messageCount = m_parseStatus != nullptr ? m_parseStatus->messageCount() : 0u;
+            m_objectInfos.push_back(BrushInfo{std::move(m_faces), startLine, lineCount, extraAttributes, m_brushParent, messageCount});
+            m_faces.clear();
+        }
+
+        /**
+         * Creates the brushes recorded during parsing and passes all recorded nodes to the subclassing interface in
+         * file order. The brush geometry is built in parallel, but the brush errors are logged in file order, interleaved
+         * with the buffered parser messages.
+         */
+        void MapReader::createNodes(ParserStatus& status) {
+            std::vector<BrushInfo*> brushInfos;
+            for (auto& objectInfo : m_objectInfos) {
+                if (auto* brushInfo = std::get_if<BrushInfo>(&objectInfo)) {
+                    brushInfos.push_back(brushInfo);
+                }
+            }
+
+            // Brush::create only touches the given faces, so it is safe to call it concurrently
+            auto brushes = kdl::vec_parallel_transform(brushInfos, [&](BrushInfo* brushInfo) {
+                return Model::Brush::create(m_worldBounds, std::move(brushInfo->faces));
+            });
+
+            size_t brushIndex = 0u;
+            for (auto& objectInfo : m_objectInfos) {
+                std::visit(kdl::overload(
+                    [&](LayerInfo& layerInfo) {
+                        onLayer(layerInfo.layer.release(), status);
+                    },
+                    [&](NodeInfo& nodeInfo) {
+                        onNode(nodeInfo.parent, nodeInfo.node.release(), status);
+                    },
+                    [&](BrushInfo& brushInfo) {
+                        if (m_parseStatus != nullptr) {
+                            m_parseStatus->forward(brushInfo.messageCount);
+                        }
+                        std::move(brushes[brushIndex++])
+                            .and_then(
+                                [&](Model::Brush&& b) {
+                                    Model::BrushNode* brushNode = m_factory->createBrush(std::move(b));
+                                    setFilePosition(brushNode, brushInfo.startLine, brushInfo.lineCount);
+                                    setExtraAttributes(brushNode, brushInfo.extraAttributes);
+
+                                    onBrush(brushInfo.parent, brushNode, status);
+                                    return kdl::void_result;
+                                }
+                            ).handle_errors(
+                                [&](const Model::BrushError e) {
+                                    status.error(brushInfo.startLine, kdl::str_to_string("Skipping brush: ", e));
+                                }
+                            );
                     }
-                );
+                ), objectInfo);
+            }
+
+            m_objectInfos.clear();
+
+            if (m_parseStatus != nullptr) {
+                m_parseStatus->forward();
+                m_parseStatus.reset();
+            }
         }
 
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, ParserStatus& status) {
@@ -290,7 +352,7 @@ namespace TrenchBroom {
                     Model::LayerNode* layer = kdl::map_find_or_default(m_layers, layerId,
                         static_cast<Model::LayerNode*>(nullptr));
                     if (layer != nullptr)
-                        onNode(layer, node, status);
+                        m_objectInfos.push_back(NodeInfo{layer, std::unique_ptr<Model::Node>(node)});
                     else
                         m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::layer(layerId)));
                     return ParentInfo::Type_Layer;
@@ -306,7 +368,7 @@ namespace TrenchBroom {
                         Model::GroupNode* group = kdl::map_find_or_default(m_groups, groupId,
                             static_cast<Model::GroupNode*>(nullptr));
                         if (group != nullptr)
-                            onNode(group, node, status);
+                            m_objectInfos.push_back(NodeInfo{group, std::unique_ptr<Model::Node>(node)});
                         else
                             m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::group(groupId)));
                         return ParentInfo::Type_Group;
@@ -316,7 +378,7 @@ namespace TrenchBroom {
                 }
             }
 
-            onNode(nullptr, node, status);
+            m_objectInfos.push_back(NodeInfo{nullptr, std::unique_ptr<Model::Node>(node)});
             return ParentInfo::Type_None;
         }
 
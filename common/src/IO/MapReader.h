@@ -28,7 +28,9 @@
 #include <vecmath/bbox.h>
 
 #include <map>
+#include <memory>
 #include <string_view>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom {
@@ -43,6 +45,7 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        class BufferedParserStatus;
         class ParserStatus;
 
         /**
@@ -88,6 +91,32 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            /**
+             * The following structs record the nodes encountered while parsing, in file order. Brushes are only
+             * created once parsing is complete so that their geometry can be built in parallel, and all nodes are then
+             * passed to the subclassing interface in the order in which they appear in the file.
+             */
+            struct LayerInfo {
+                std::unique_ptr<Model::LayerNode> layer;
+            };
+
+            struct NodeInfo {
+                Model::Node* parent;
+                std::unique_ptr<Model::Node> node;
+            };
+
+            struct BrushInfo {
+                std::vector<Model::BrushFace> faces;
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+                Model::Node* parent;
+                // the number of parser messages that were logged before the brush ended
+                size_t messageCount;
+            };
+
+            using ObjectInfo = std::variant<LayerInfo, NodeInfo, BrushInfo>;
+
             vm::bbox3 m_worldBounds;
             Model::ModelFactory* m_factory;
 
@@ -98,8 +127,15 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+            std::vector<ObjectInfo> m_objectInfos;
+
+            // buffers the parser messages so that they can be logged in file order with the brush errors
+            std::unique_ptr<BufferedParserStatus> m_parseStatus;
         protected:
             explicit MapReader(std::string_view str);
+        public:
+            ~MapReader() override;
+        protected:
 
             /**
              * Attempts to parse as one or more entities, in the given format.
@@ -131,7 +167,8 @@ namespace TrenchBroom {
             void createLayer(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createGroup(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createEntity(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
-            void createBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void storeBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes);
+            void createNodes(ParserStatus& status);
 
             ParentInfo::Type storeNode(Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, ParserStatus& status);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
@@ -21,6 +21,7 @@
 
 #include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/EntityAttributes.h"
 #include "Model/LayerNode.h"
@@ -31,6 +32,7 @@
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
 
+#include <atomic>
 #include <string>
 
 namespace TrenchBroom {
@@ -38,13 +40,35 @@ namespace TrenchBroom {
         const std::string& NodeSerializer::IdManager::getId(const Model::Node* t) const {
             auto it = m_ids.find(t);
             if (it == std::end(m_ids)) {
-                it = m_ids.insert(std::make_pair(t, idToString(makeId()))).first;
+                it = m_ids.insert(std::make_pair(t, idToString(persistentId(t)))).first;
             }
             return it->second;
         }
 
+        /**
+         * Returns the persistent ID of the given layer or group, and creates it if necessary. Since the IDs are
+         * never reused, an ID that is created here cannot collide with the persistent ID of another node.
+         */
+        Model::IdType NodeSerializer::IdManager::persistentId(const Model::Node* t) const {
+            const auto getOrCreateId = [&](const auto* node) {
+                if (!node->persistentId()) {
+                    node->setPersistentId(makeId());
+                }
+                return *node->persistentId();
+            };
+
+            return t->accept(kdl::overload(
+                [&](const Model::WorldNode*)        { return makeId(); },
+                [&](const Model::LayerNode* layer)  { return getOrCreateId(layer); },
+                [&](const Model::GroupNode* group)  { return getOrCreateId(group); },
+                [&](const Model::EntityNode*)       { return makeId(); },
+                [&](const Model::BrushNode*)        { return makeId(); }
+            ));
+        }
+
         Model::IdType NodeSerializer::IdManager::makeId() const {
-            static Model::IdType currentId = 1;
+            // IDs may be created by a background autosave while the document is being saved
+            static std::atomic<Model::IdType> currentId{1};
             return currentId++;
         }
 
@@ -137,18 +161,26 @@ namespace TrenchBroom {
         }
 
         void NodeSerializer::entity(const Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, const std::vector<Model::EntityAttribute>& parentAttributes, const Model::Node* brushParent) {
-            beginEntity(node, attributes, parentAttributes);
-
+            std::vector<const Model::BrushNode*> brushNodes;
             brushParent->visitChildren(kdl::overload(
                 [] (const Model::WorldNode*)   {},
                 [] (const Model::LayerNode*)   {},
                 [] (const Model::GroupNode*)   {},
                 [] (const Model::EntityNode*)  {},
                 [&](const Model::BrushNode* b) {
-                    brush(b);
+                    brushNodes.push_back(b);
                 }
             ));
 
+            if (doWriteUnchangedEntity(node, brushNodes)) {
+                ++m_entityNo;
+                return;
+            }
+
+            beginEntity(node, attributes, parentAttributes);
+            for (const auto* brushNode : brushNodes) {
+                brush(brushNode);
+            }
             endEntity(node);
         }
 
@@ -255,6 +287,10 @@ namespace TrenchBroom {
             };
         }
 
+        bool NodeSerializer::doWriteUnchangedEntity(const Model::Node* /* node */, const std::vector<const Model::BrushNode*>& /* brushNodes */) {
+            return false;
+        }
+
         std::string NodeSerializer::escapeEntityAttribute(const std::string& str) const {
             // Remove a trailing unescaped backslash, as this will choke the parser.
             const auto l = str.size();
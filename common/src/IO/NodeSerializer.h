@@ -63,6 +63,7 @@ namespace TrenchBroom {
             public:
                 const std::string& getId(const Model::Node* t) const;
             private:
+                Model::IdType persistentId(const Model::Node* t) const;
                 Model::IdType makeId() const;
                 std::string idToString(const Model::IdType nodeId) const;
             };
@@ -134,6 +135,14 @@ namespace TrenchBroom {
 
             virtual void doBrush(const Model::BrushNode* brushNode) = 0;
             virtual void doBrushFace(const Model::BrushFace& face) = 0;
+
+            /**
+             * Gives subclasses the opportunity to write an entity with the given brushes without serializing it,
+             * e.g. by copying it from a previous file.
+             *
+             * @return true if the entity was written, and false if it must be serialized
+             */
+            virtual bool doWriteUnchangedEntity(const Model::Node* node, const std::vector<const Model::BrushNode*>& brushNodes);
         };
     }
 }
@@ -22,12 +22,18 @@
 #include "Ensure.h"
 #include "Assets/Texture.h"
 #include "IO/Path.h"
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/Polyhedron.h"
 
+#include <kdl/parallel.h>
+
+#include <algorithm>
+#include <cstdio>
 #include <map>
+#include <string>
 
 namespace TrenchBroom {
     namespace IO {
@@ -48,24 +54,31 @@ namespace TrenchBroom {
         m_mtlFile(m_mtlPath, true),
         m_stream(m_objFile.file),
         m_mtlStream(m_mtlFile.file),
-        m_currentObject({ 0, 0, {} }) {
+        m_vertexCount(0u) {
             ensure(m_stream != nullptr, "stream is null");
             ensure(m_mtlStream != nullptr, "mtl stream is null");
         }
 
-        void ObjFileSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {}
-
-        void ObjFileSerializer::doEndFile() {
-            writeMtlFile();
+        /**
+         * A chunk of brushes is processed once it contains this many brushes.
+         */
+        static const size_t ChunkBrushCount = 4096u;
 
+        void ObjFileSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {
             std::fprintf(m_stream, "mtllib %s\n", m_mtlPath.filename().c_str());
-            writeVertices();
+            std::fprintf(m_stream, "# vertices\n");
+        }
+
+        void ObjFileSerializer::doEndFile() {
+            writePendingBrushes();
             std::fprintf(m_stream, "\n");
             writeTexCoords();
             std::fprintf(m_stream, "\n");
             writeNormals();
             std::fprintf(m_stream, "\n");
             writeObjects();
+
+            writeMtlFile();
         }
 
         void ObjFileSerializer::writeMtlFile() {
@@ -85,10 +98,93 @@ namespace TrenchBroom {
             }
         }
 
-        void ObjFileSerializer::writeVertices() {
-            std::fprintf(m_stream, "# vertices\n");
-            for (const vm::vec3& elem : m_vertices.list())
-                std::fprintf(m_stream, "v %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
+        /**
+         * Extracts the geometry of the pending brushes in parallel, writes their vertices and merges their texture
+         * coordinates and normals into the global lists. The result is the same as if the brushes were processed
+         * one after another.
+         */
+        void ObjFileSerializer::writePendingBrushes() {
+            // keep the extracted brushes of the previous chunks to reuse their memory
+            if (m_extractedBrushes.size() < m_pendingBrushes.size()) {
+                m_extractedBrushes.resize(m_pendingBrushes.size());
+            }
+            kdl::parallel_for(0u, m_pendingBrushes.size(), [&](const size_t i) {
+                extractBrush(*m_pendingBrushes[i].brush, m_extractedBrushes[i]);
+            });
+
+            std::vector<size_t> texCoordIndices;
+            std::vector<size_t> normalIndices;
+            for (size_t i = 0u; i < m_pendingBrushes.size(); ++i) {
+                const auto& pendingBrush = m_pendingBrushes[i];
+                auto& extractedBrush = m_extractedBrushes[i];
+
+                std::fwrite(extractedBrush.vertexText.data(), 1u, extractedBrush.vertexText.size(), m_stream);
+
+                texCoordIndices.clear();
+                for (const auto& texCoords : extractedBrush.texCoords) {
+                    texCoordIndices.push_back(m_texCoords.index(texCoords));
+                }
+
+                normalIndices.clear();
+                for (const auto& normal : extractedBrush.normals) {
+                    normalIndices.push_back(m_normals.index(normal));
+                }
+
+                // vertices are not shared between brushes, so they are just numbered consecutively
+                for (auto& face : extractedBrush.faces) {
+                    for (auto& vertex : face.verts) {
+                        vertex.vertex += m_vertexCount;
+                        vertex.texCoords = texCoordIndices[vertex.texCoords];
+                        vertex.normal = normalIndices[vertex.normal];
+                    }
+                }
+                m_vertexCount += extractedBrush.vertexCount;
+
+                m_objects.push_back(Object{ pendingBrush.entityNo, pendingBrush.brushNo, std::move(extractedBrush.faces) });
+                extractedBrush.faces.clear();
+            }
+
+            m_pendingBrushes.clear();
+        }
+
+        /**
+         * Threadsafe
+         */
+        void ObjFileSerializer::extractBrush(const Model::Brush& brush, ExtractedBrush& result) {
+            IndexMap<vm::vec3> vertices;
+            IndexMap<vm::vec2f> texCoords;
+            IndexMap<vm::vec3> normals;
+
+            result.faces.clear();
+            result.faces.reserve(brush.faceCount());
+            for (const Model::BrushFace& face : brush.faces()) {
+                const size_t normalIndex = normals.index(face.boundary().normal);
+
+                IndexedVertexList indexedVertices;
+                indexedVertices.reserve(face.vertexCount());
+
+                for (const Model::BrushVertex* vertex : face.vertices()) {
+                    const vm::vec3& position = vertex->position();
+                    const vm::vec2f faceTexCoords = face.textureCoords(position);
+
+                    const size_t vertexIndex = vertices.index(position);
+                    const size_t texCoordsIndex = texCoords.index(faceTexCoords);
+
+                    indexedVertices.push_back(IndexedVertex(vertexIndex, texCoordsIndex, normalIndex));
+                }
+
+                result.faces.push_back(Face(std::move(indexedVertices), face.attributes().textureName(), face.texture()));
+            }
+
+            result.vertexText.clear();
+            for (const vm::vec3& elem : vertices.list()) {
+                char buffer[128];
+                const auto length = std::snprintf(buffer, sizeof(buffer), "v %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
+                result.vertexText.append(buffer, static_cast<size_t>(length));
+            }
+            result.vertexCount = vertices.list().size();
+            result.texCoords = texCoords.list();
+            result.normals = normals.list();
         }
 
         void ObjFileSerializer::writeTexCoords() {
@@ -107,30 +203,42 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Formats the objects in parallel, one chunk at a time, and writes them to the OBJ file.
+         */
         void ObjFileSerializer::writeObjects() {
             std::fprintf(m_stream, "# objects\n");
-            for (const Object& object : m_objects) {
-                std::fprintf(m_stream, "o entity%lu_brush%lu\n",
-                             static_cast<unsigned long>(object.entityNo),
-                             static_cast<unsigned long>(object.brushNo));
 
-                writeFaces(object.faces);
-                std::fprintf(m_stream, "\n");
+            std::vector<std::string> objectTexts(std::min(m_objects.size(), ChunkBrushCount));
+            for (size_t chunkStart = 0u; chunkStart < m_objects.size(); chunkStart += ChunkBrushCount) {
+                const auto chunkSize = std::min(m_objects.size() - chunkStart, ChunkBrushCount);
+                kdl::parallel_for(0u, chunkSize, [&](const size_t i) {
+                    auto& str = objectTexts[i];
+                    str.clear();
+                    writeObject(str, m_objects[chunkStart + i]);
+                });
+
+                for (size_t i = 0u; i < chunkSize; ++i) {
+                    std::fwrite(objectTexts[i].data(), 1u, objectTexts[i].size(), m_stream);
+                }
             }
         }
 
-        void ObjFileSerializer::writeFaces(const FaceList& faces) {
-            for (const Face& face : faces) {
-                std::fprintf(m_stream, "usemtl %s\n", face.textureName.c_str());
-                std::fprintf(m_stream, "f");
+        /**
+         * Threadsafe
+         */
+        void ObjFileSerializer::writeObject(std::string& str, const Object& object) {
+            str += "o entity" + std::to_string(object.entityNo) + "_brush" + std::to_string(object.brushNo) + "\n";
+
+            for (const Face& face : object.faces) {
+                str += "usemtl " + face.textureName + "\n";
+                str += "f";
                 for (const IndexedVertex& vertex : face.verts) {
-                    std::fprintf(m_stream, " %lu/%lu/%lu",
-                                 static_cast<unsigned long>(vertex.vertex) + 1,
-                                 static_cast<unsigned long>(vertex.texCoords) + 1,
-                                 static_cast<unsigned long>(vertex.normal) + 1);
+                    str += " " + std::to_string(vertex.vertex + 1) + "/" + std::to_string(vertex.texCoords + 1) + "/" + std::to_string(vertex.normal + 1);
                 }
-                std::fprintf(m_stream, "\n");
+                str += "\n";
             }
+            str += "\n";
         }
 
         void ObjFileSerializer::doBeginEntity(const Model::Node* /* node */) {}
@@ -138,38 +246,12 @@ namespace TrenchBroom {
         void ObjFileSerializer::doEntityAttribute(const Model::EntityAttribute& /* attribute */) {}
 
         void ObjFileSerializer::doBrush(const Model::BrushNode* brush) {
-            m_currentObject.entityNo = entityNo();
-            m_currentObject.brushNo = brushNo();
-            // Vertex positions inserted from now on should get new indices
-            m_vertices.clearIndices();
-
-            for (const Model::BrushFace& face : brush->brush().faces()) {
-                doBrushFace(face);
+            m_pendingBrushes.push_back(PendingBrush{ entityNo(), brushNo(), &brush->brush() });
+            if (m_pendingBrushes.size() >= ChunkBrushCount) {
+                writePendingBrushes();
             }
-
-            m_objects.push_back(m_currentObject);
-            m_currentObject.faces.clear();
         }
 
-        void ObjFileSerializer::doBrushFace(const Model::BrushFace& face) {
-            const vm::vec3& normal = face.boundary().normal;
-            const size_t normalIndex = m_normals.index(normal);
-
-            IndexedVertexList indexedVertices;
-            indexedVertices.reserve(face.vertexCount());
-
-            for (const Model::BrushVertex* vertex : face.vertices()) {
-                const vm::vec3& position = vertex->position();
-                const vm::vec2f texCoords = face.textureCoords(position);
-
-                const size_t vertexIndex = m_vertices.index(position);
-                const size_t texCoordsIndex = m_texCoords.index(texCoords);
-
-                indexedVertices.push_back(IndexedVertex(vertexIndex, texCoordsIndex, normalIndex));
-            }
-
-            m_currentObject.faces.push_back(Face(indexedVertices, face.attributes().textureName(), face.texture()));
-        }
+        void ObjFileSerializer::doBrushFace(const Model::BrushFace& /* face */) {}
     }
 }
-
@@ -37,6 +37,7 @@ namespace TrenchBroom {
     }
 
     namespace Model {
+        class Brush;
         class BrushNode;
         class BrushFace;
         class EntityAttribute;
@@ -44,6 +45,14 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        /**
+         * Writes brushes to a Wavefront OBJ file and their materials to an accompanying MTL file.
+         *
+         * The brushes are processed in chunks. The geometry of the brushes in a chunk is extracted in parallel, and
+         * the vertices of each brush are written to the OBJ file right away. Texture coordinates and normals are
+         * shared between all brushes, so they are merged into global lists in the order of the brushes, and the
+         * faces are written once all brushes have been processed.
+         */
         class ObjFileSerializer : public NodeSerializer {
         private:
             template <typename V>
@@ -67,14 +76,6 @@ namespace TrenchBroom {
                     }
                     return index;
                 }
-
-                /**
-                 * Values inserted after this is called will not reuse indices from before this
-                 * is called.
-                 */
-                void clearIndices() {
-                    m_map.clear();
-                }
             };
 
             struct IndexedVertex {
@@ -105,6 +106,24 @@ namespace TrenchBroom {
 
             using ObjectList = std::vector<Object>;
 
+            struct PendingBrush {
+                size_t entityNo;
+                size_t brushNo;
+                const Model::Brush* brush;
+            };
+
+            /**
+             * The geometry of a single brush. The indices of its faces refer to the vertices, texture coordinates
+             * and normals of the brush until they are remapped to the global lists.
+             */
+            struct ExtractedBrush {
+                std::string vertexText;
+                size_t vertexCount;
+                std::vector<vm::vec2f> texCoords;
+                std::vector<vm::vec3> normals;
+                FaceList faces;
+            };
+
             Path m_objPath;
             Path m_mtlPath;
 
@@ -114,11 +133,12 @@ namespace TrenchBroom {
             FILE* m_stream;
             FILE* m_mtlStream;
 
-            IndexMap<vm::vec3> m_vertices;
+            size_t m_vertexCount;
             IndexMap<vm::vec2f> m_texCoords;
             IndexMap<vm::vec3> m_normals;
 
-            Object m_currentObject;
+            std::vector<PendingBrush> m_pendingBrushes;
+            std::vector<ExtractedBrush> m_extractedBrushes;
             ObjectList m_objects;
         public:
             explicit ObjFileSerializer(const Path& path);
@@ -128,11 +148,12 @@ namespace TrenchBroom {
 
             void writeMtlFile();
 
-            void writeVertices();
+            void writePendingBrushes();
+            static void extractBrush(const Model::Brush& brush, ExtractedBrush& result);
             void writeTexCoords();
             void writeNormals();
             void writeObjects();
-            void writeFaces(const FaceList& faces);
+            static void writeObject(std::string& str, const Object& object);
 
             void doBeginEntity(const Model::Node* node) override;
             void doEndEntity(const Model::Node* node) override;
@@ -28,6 +28,8 @@ namespace TrenchBroom {
     namespace IO {
         class ParserStatus {
         private:
+            friend class BufferedParserStatus;
+
             Logger& m_logger;
             std::string m_prefix;
         protected:
@@ -65,6 +67,7 @@ namespace TrenchBroom {
             std::string buildMessage(const std::string& str) const;
         private:
             virtual void doProgress(double progress) = 0;
+        protected:
             virtual void doLog(LogLevel level, const std::string& str);
         };
     }
@@ -24,10 +24,9 @@
 
 #include <kdl/string_compare.h>
 #include <kdl/string_format.h>
-#include <kdl/string_utils.h>
-#include <kdl/vector_utils.h>
 
-#include <iterator>
+#include <algorithm>
+#include <cctype>
 #include <ostream>
 #include <string>
 
@@ -37,15 +36,44 @@ namespace TrenchBroom {
             return std::string_view("/\\");
         }
 
-        Path::Path(bool absolute, const std::vector<std::string>& components) :
-        m_components(components),
+        static std::string_view trimComponent(const std::string_view component) {
+            const auto first = component.find_first_not_of(kdl::Whitespace);
+            if (first == std::string_view::npos) {
+                return std::string_view();
+            }
+            const auto last = component.find_last_not_of(kdl::Whitespace);
+            return component.substr(first, last - first + 1u);
+        }
+
+        Path::Path(const bool absolute, std::string path) :
+        m_path(std::move(path)),
         m_absolute(absolute) {}
 
         Path::Path(const std::string& path) {
+            // split the path at any separator, trim the components and drop the empty ones
             const auto trimmed = kdl::str_trim(path);
-            m_components = kdl::str_split(trimmed, separators());
+            const auto str = std::string_view(trimmed);
+            m_path.reserve(str.size());
+
+            size_t start = 0u;
+            while (start <= str.size()) {
+                auto end = str.find_first_of(separators(), start);
+                if (end == std::string_view::npos) {
+                    end = str.size();
+                }
+
+                const auto component = trimComponent(str.substr(start, end - start));
+                if (!component.empty()) {
+                    if (!m_path.empty()) {
+                        m_path.push_back(InternalSeparator);
+                    }
+                    m_path += component;
+                }
+                start = end + 1u;
+            }
+
 #ifdef _WIN32
-            m_absolute = (hasDriveSpec(m_components) ||
+            m_absolute = (hasDriveSpec(firstComponentView()) ||
                           (!trimmed.empty() && trimmed[0] == '/') ||
                           (!trimmed.empty() && trimmed[0] == '\\'));
 #else
@@ -57,9 +85,20 @@ namespace TrenchBroom {
             if (rhs.isAbsolute()) {
                 throw PathException("Cannot concatenate absolute path");
             }
-            auto components = m_components;
-            components.insert(std::end(components), std::begin(rhs.m_components), std::end(rhs.m_components));
-            return Path(m_absolute, components);
+
+            if (rhs.m_path.empty()) {
+                return *this;
+            }
+            if (m_path.empty()) {
+                return Path(m_absolute, rhs.m_path);
+            }
+
+            auto path = std::string();
+            path.reserve(m_path.size() + 1u + rhs.m_path.size());
+            path += m_path;
+            path.push_back(InternalSeparator);
+            path += rhs.m_path;
+            return Path(m_absolute, std::move(path));
         }
 
         int Path::compare(const Path& rhs, const bool caseSensitive) const {
@@ -69,25 +108,27 @@ namespace TrenchBroom {
                 return 1;
             }
 
-            const auto& rcomps = rhs.m_components;
-
-            size_t i = 0;
-            const auto max = m_components.size() < rcomps.size() ? m_components.size() : rcomps.size();
-            while (i < max) {
-                const auto& mcomp = m_components[i];
-                const auto& rcomp = rcomps[i];
-                const auto result = caseSensitive ? kdl::cs::str_compare(mcomp, rcomp) : kdl::ci::str_compare(mcomp,
-                    rcomp);
-                if (result < 0) {
-                    return -1;
-                } else if (result > 0) {
-                    return 1;
+            // Comparing the strings character by character yields the same order as comparing their components if
+            // the separator is treated as being less than any other character: the component that ends first is a
+            // prefix of the other component.
+            const auto size = std::min(m_path.size(), rhs.m_path.size());
+            for (size_t i = 0u; i < size; ++i) {
+                const auto mc = caseSensitive ? m_path[i] : static_cast<char>(std::tolower(m_path[i]));
+                const auto rc = caseSensitive ? rhs.m_path[i] : static_cast<char>(std::tolower(rhs.m_path[i]));
+                if (mc != rc) {
+                    if (mc == InternalSeparator) {
+                        return -1;
+                    } else if (rc == InternalSeparator) {
+                        return 1;
+                    } else {
+                        return mc < rc ? -1 : 1;
+                    }
                 }
-                ++i;
             }
-            if (m_components.size() < rcomps.size()) {
+
+            if (m_path.size() < rhs.m_path.size()) {
                 return -1;
-            } else if (m_components.size() > rcomps.size()) {
+            } else if (m_path.size() > rhs.m_path.size()) {
                 return 1;
             } else {
                 return 0;
@@ -95,7 +136,8 @@ namespace TrenchBroom {
         }
 
         bool Path::operator==(const Path& rhs) const {
-            return compare(rhs) == 0;
+            // components never contain a separator, so equal strings mean equal components
+            return m_absolute == rhs.m_absolute && m_path == rhs.m_path;
         }
 
         bool Path::operator!= (const Path& rhs) const {
@@ -111,21 +153,29 @@ namespace TrenchBroom {
         }
 
         std::string Path::asString(const std::string_view separator) const {
-            if (m_absolute) {
+            auto result = std::string();
+            if (m_absolute
 #ifdef _WIN32
-                if (hasDriveSpec(m_components)) {
-                    return kdl::str_join(m_components, separator);
-                } else {
-                    return std::string(separator) + kdl::str_join(m_components, separator);
-                }
-#else
-                return std::string(separator) + kdl::str_join(m_components, separator);
+                && !hasDriveSpec(firstComponentView())
 #endif
+                ) {
+                result += separator;
             }
-            return kdl::str_join(m_components, separator);
-        }
-
 
+            if (separator.size() == 1u && separator[0] == InternalSeparator) {
+                result += m_path;
+            } else {
+                result.reserve(result.size() + m_path.size());
+                for (const auto c : m_path) {
+                    if (c == InternalSeparator) {
+                        result += separator;
+                    } else {
+                        result.push_back(c);
+                    }
+                }
+            }
+            return result;
+        }
 
         std::vector<std::string> Path::asStrings(const std::vector<Path>& paths, const std::string_view separator) {
             auto result = std::vector<std::string>();
@@ -146,11 +196,14 @@ namespace TrenchBroom {
         }
 
         size_t Path::length() const {
-            return m_components.size();
+            if (m_path.empty()) {
+                return 0u;
+            }
+            return static_cast<size_t>(std::count(std::begin(m_path), std::end(m_path), InternalSeparator)) + 1u;
         }
 
         bool Path::isEmpty() const {
-            return !m_absolute && m_components.empty();
+            return !m_absolute && m_path.empty();
         }
 
         Path Path::firstComponent() const {
@@ -159,12 +212,12 @@ namespace TrenchBroom {
             }
 
             if (!m_absolute) {
-                return Path(m_components.front());
+                return Path(false, std::string(firstComponentView()));
             }
 
 #ifdef _WIN32
-            if (hasDriveSpec(m_components)) {
-                return Path(m_components.front());
+            if (hasDriveSpec(firstComponentView())) {
+                return Path(true, std::string(firstComponentView()));
             }
 
             return Path("\\");
@@ -177,33 +230,27 @@ namespace TrenchBroom {
             if (isEmpty()) {
                 throw PathException("Cannot delete first component of empty path");
             }
-            if (!m_absolute) {
-                auto components = std::vector<std::string>();
-                components.reserve(m_components.size() - 1);
-                components.insert(std::begin(components), std::begin(m_components) + 1, std::end(m_components));
-                return Path(false, components);
-            }
+            if (!m_absolute
 #ifdef _WIN32
-            if (!m_components.empty() && hasDriveSpec(m_components[0])) {
-                std::vector<std::string> components;
-                components.reserve(m_components.size() - 1);
-                components.insert(std::begin(components), std::begin(m_components) + 1, std::end(m_components));
-                return Path(false, components);
-            }
-            return Path(false, m_components);
-#else
-            return Path(false, m_components);
+                || hasDriveSpec(firstComponentView())
 #endif
+                ) {
+                const auto separatorIndex = m_path.find(InternalSeparator);
+                if (separatorIndex == std::string::npos) {
+                    return Path(false, std::string());
+                }
+                return Path(false, m_path.substr(separatorIndex + 1u));
+            }
+            return Path(false, m_path);
         }
 
         Path Path::lastComponent() const {
-            if (isEmpty())
+            if (isEmpty()) {
                 throw PathException("Cannot return last component of empty path");
-            if (!m_components.empty()) {
-                return Path(m_components.back());
-            } else {
-                return Path("");
             }
+
+            const auto component = lastComponentView();
+            return Path(hasDriveSpec(component), std::string(component));
         }
 
         Path Path::deleteLastComponent() const {
@@ -211,14 +258,11 @@ namespace TrenchBroom {
                 throw PathException("Cannot delete last component of empty path");
             }
 
-            if (!m_components.empty()) {
-                auto components = std::vector<std::string>();
-                components.reserve(m_components.size() - 1);
-                components.insert(std::begin(components), std::begin(m_components), std::end(m_components) - 1);
-                return Path(m_absolute, components);
-            } else {
-                return Path(m_absolute, m_components);
+            const auto separatorIndex = m_path.rfind(InternalSeparator);
+            if (separatorIndex == std::string::npos) {
+                return Path(m_absolute, std::string());
             }
+            return Path(m_absolute, m_path.substr(0u, separatorIndex));
         }
 
         Path Path::prefix(const size_t count) const {
@@ -226,11 +270,11 @@ namespace TrenchBroom {
         }
 
         Path Path::suffix(const size_t count) const {
-            return subPath(m_components.size() - count, count);
+            return subPath(length() - count, count);
         }
 
         Path Path::subPath(const size_t index, const size_t count) const {
-            if (index + count > m_components.size()) {
+            if (index + count > length()) {
                 throw PathException("Sub path out of bounds");
             }
 
@@ -238,16 +282,18 @@ namespace TrenchBroom {
                 return Path("");
             }
 
-            auto newComponents = std::vector<std::string>();
-            newComponents.reserve(count);
-            for (size_t i = 0u; i < count; ++i) {
-                newComponents.push_back(m_components[index + i]);
-            }
-            return Path(m_absolute && index == 0, newComponents);
+            const auto start = componentOffset(index);
+            const auto end = componentOffset(index + count);
+            return Path(m_absolute && index == 0, m_path.substr(start, end - start - 1u));
         }
 
-        const std::vector<std::string>& Path::components() const {
-            return m_components;
+        std::vector<std::string> Path::components() const {
+            auto result = std::vector<std::string>();
+            size_t offset = 0u;
+            while (offset < m_path.size()) {
+                result.emplace_back(nextComponent(m_path, offset));
+            }
+            return result;
         }
 
         std::string Path::filename() const {
@@ -255,11 +301,7 @@ namespace TrenchBroom {
                 throw PathException("Cannot get filename of empty path");
             }
 
-            if (m_components.empty()) {
-                return "";
-            } else {
-                return m_components.back();
-            }
+            return std::string(lastComponentView());
         }
 
         std::string Path::basename() const {
@@ -267,12 +309,12 @@ namespace TrenchBroom {
                 throw PathException("Cannot get basename of empty path");
             }
 
-            const auto filename = this->filename();
+            const auto filename = lastComponentView();
             const auto dotIndex = filename.rfind('.');
-            if (dotIndex == std::string::npos) {
-                return filename;
+            if (dotIndex == std::string_view::npos) {
+                return std::string(filename);
             } else {
-                return filename.substr(0, dotIndex);
+                return std::string(filename.substr(0, dotIndex));
             }
         }
 
@@ -281,12 +323,12 @@ namespace TrenchBroom {
                 throw PathException("Cannot get extension of empty path");
             }
 
-            const auto filename = this->filename();
+            const auto filename = lastComponentView();
             const auto dotIndex = filename.rfind('.');
-            if (dotIndex == std::string::npos) {
+            if (dotIndex == std::string_view::npos) {
                 return "";
             } else {
-                return filename.substr(dotIndex + 1);
+                return std::string(filename.substr(dotIndex + 1));
             }
         }
 
@@ -358,17 +400,15 @@ namespace TrenchBroom {
                 throw PathException("Cannot add extension to empty path");
             }
 
-            auto components = m_components;
-            if (components.empty()
+            auto path = m_path;
 #ifdef _WIN32
-                || hasDriveSpec(m_components.back())
-#endif
-                ) {
-                components.push_back("." + extension);
-            } else {
-                components.back() += "." + extension;
+            if (hasDriveSpec(lastComponentView())) {
+                path.push_back(InternalSeparator);
             }
-            return Path(m_absolute, components);
+#endif
+            // if there are no components, the extension becomes a new component
+            path += "." + extension;
+            return Path(m_absolute, std::move(path));
         }
 
         Path Path::replaceExtension(const std::string& extension) const {
@@ -391,9 +431,9 @@ namespace TrenchBroom {
                     isAbsolute() && absolutePath.isAbsolute()
 #ifdef _WIN32
                     &&
-                    !m_components.empty() && !absolutePath.m_components.empty()
+                    !m_path.empty() && !absolutePath.m_path.empty()
                     &&
-                    m_components[0] == absolutePath.m_components[0]
+                    firstComponentView() == absolutePath.firstComponentView()
 #endif
             );
         }
@@ -420,16 +460,18 @@ namespace TrenchBroom {
             }
 
 #ifdef _WIN32
-            if (m_components.empty()) {
+            if (m_path.empty()) {
                 throw PathException("Cannot make relative path from an reference path with no drive spec");
             }
 
-            return Path(false, kdl::vec_slice_suffix(m_components, m_components.size() - 1u));
+            const auto separatorIndex = m_path.find(InternalSeparator);
+            if (separatorIndex == std::string::npos) {
+                return Path(false, std::string());
+            }
+            return Path(false, m_path.substr(separatorIndex + 1u));
 #else
-            return Path(false, m_components);
+            return Path(false, m_path);
 #endif
-
-
         }
 
         Path Path::makeRelative(const Path& absolutePath) const {
@@ -450,19 +492,19 @@ namespace TrenchBroom {
             }
 
 #ifdef _WIN32
-            if (m_components.empty()) {
+            if (m_path.empty()) {
                 throw PathException("Cannot make relative path from an reference path with no drive spec");
             }
-            if (absolutePath.m_components.empty()) {
+            if (absolutePath.m_path.empty()) {
                 throw PathException("Cannot make relative path with sub path with no drive spec");
             }
-            if (m_components[0] != absolutePath.m_components[0]) {
+            if (firstComponentView() != absolutePath.firstComponentView()) {
                 throw PathException("Cannot make relative path if reference path has different drive spec");
             }
 #endif
 
-            const auto myResolved = resolvePath(true, m_components);
-            const auto theirResolved = resolvePath(true, absolutePath.m_components);
+            const auto myResolved = resolvePath(true, m_path);
+            const auto theirResolved = resolvePath(true, absolutePath.m_path);
 
             // cross off all common prefixes
             size_t p = 0;
@@ -474,7 +516,7 @@ namespace TrenchBroom {
                 ++p;
             }
 
-            auto components = std::vector<std::string>();
+            auto components = std::vector<std::string_view>();
             for (size_t i = p; i < myResolved.size(); ++i) {
                 components.push_back("..");
             }
@@ -482,20 +524,16 @@ namespace TrenchBroom {
                 components.push_back(theirResolved[i]);
             }
 
-            return Path(false, components);
+            return Path(false, joinComponents(components));
         }
 
         Path Path::makeCanonical() const {
-            return Path(m_absolute, resolvePath(m_absolute, m_components));
+            return Path(m_absolute, joinComponents(resolvePath(m_absolute, m_path)));
         }
 
         Path Path::makeLowerCase() const {
-            auto lcComponents = std::vector<std::string>();
-            lcComponents.reserve(m_components.size());
-            for (const auto& component : m_components) {
-                lcComponents.push_back(kdl::str_to_lower(component));
-            }
-            return Path(m_absolute, lcComponents);
+            // the separator is not affected
+            return Path(m_absolute, kdl::str_to_lower(m_path));
         }
 
         std::vector<Path> Path::makeAbsoluteAndCanonical(const std::vector<Path>& paths, const Path& relativePath) {
@@ -507,22 +545,33 @@ namespace TrenchBroom {
             return result;
         }
 
-#ifdef _WIN32
-        bool Path::hasDriveSpec(const std::vector<std::string>& components) {
-            if (components.empty()) {
-                return false;
-            } else {
-                return hasDriveSpec(components[0]);
+        std::string_view Path::firstComponentView() const {
+            size_t offset = 0u;
+            return nextComponent(m_path, offset);
+        }
+
+        std::string_view Path::lastComponentView() const {
+            const auto separatorIndex = m_path.rfind(InternalSeparator);
+            if (separatorIndex == std::string::npos) {
+                return m_path;
             }
+            return std::string_view(m_path).substr(separatorIndex + 1u);
         }
-#else
-        bool Path::hasDriveSpec(const std::vector<std::string>& /* components */) {
-            return false;
+
+        /**
+         * Returns the offset of the component with the given index in m_path. If the index is equal to the number
+         * of components, the size of m_path plus one is returned, as if there was another separator at its end.
+         */
+        size_t Path::componentOffset(const size_t index) const {
+            size_t offset = 0u;
+            for (size_t i = 0u; i < index; ++i) {
+                nextComponent(m_path, offset);
+            }
+            return offset;
         }
-#endif
 
 #ifdef _WIN32
-        bool Path::hasDriveSpec(const std::string& component) {
+        bool Path::hasDriveSpec(const std::string_view component) {
             if (component.size() <= 1) {
                 return false;
             } else {
@@ -530,14 +579,16 @@ namespace TrenchBroom {
             }
         }
 #else
-        bool Path::hasDriveSpec(const std::string& /* component */) {
+        bool Path::hasDriveSpec(const std::string_view /* component */) {
             return false;
         }
 #endif
 
-        std::vector<std::string> Path::resolvePath(const bool absolute, const std::vector<std::string>& components) const {
-            auto resolved = std::vector<std::string>();
-            for (const auto& comp : components) {
+        std::vector<std::string_view> Path::resolvePath(const bool absolute, const std::string_view path) {
+            auto resolved = std::vector<std::string_view>();
+            size_t offset = 0u;
+            while (offset < path.size()) {
+                const auto comp = nextComponent(path, offset);
                 if (comp == ".") {
                     continue;
                 }
@@ -561,6 +612,17 @@ namespace TrenchBroom {
             return resolved;
         }
 
+        std::string Path::joinComponents(const std::vector<std::string_view>& components) {
+            auto result = std::string();
+            for (const auto& component : components) {
+                if (!result.empty()) {
+                    result.push_back(InternalSeparator);
+                }
+                result += component;
+            }
+            return result;
+        }
+
         std::ostream& operator<<(std::ostream& stream, const Path& path) {
             stream << path.asString();
             return stream;
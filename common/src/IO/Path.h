@@ -26,6 +26,11 @@
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * A file system path. The components of a path are stored in a single string in which they are separated by
+         * slashes, regardless of the platform, so that copying a path or taking a part of it requires at most one
+         * allocation. Components are never empty and never contain a separator.
+         */
         class Path {
         public:
             static constexpr std::string_view separator() {
@@ -42,15 +47,28 @@ namespace TrenchBroom {
                 StringLess m_less;
             public:
                 bool operator()(const Path& lhs, const Path& rhs) const {
-                    return std::lexicographical_compare(std::begin(lhs.m_components), std::end(lhs.m_components),
-                                                        std::begin(rhs.m_components), std::end(rhs.m_components), m_less);
+                    size_t lhsOffset = 0u;
+                    size_t rhsOffset = 0u;
+                    while (lhsOffset < lhs.m_path.size() && rhsOffset < rhs.m_path.size()) {
+                        const auto lhsComponent = nextComponent(lhs.m_path, lhsOffset);
+                        const auto rhsComponent = nextComponent(rhs.m_path, rhsOffset);
+                        if (m_less(lhsComponent, rhsComponent)) {
+                            return true;
+                        }
+                        if (m_less(rhsComponent, lhsComponent)) {
+                            return false;
+                        }
+                    }
+                    return lhsOffset >= lhs.m_path.size() && rhsOffset < rhs.m_path.size();
                 }
             };
         private:
-            std::vector<std::string> m_components;
+            static constexpr char InternalSeparator = '/';
+
+            std::string m_path;
             bool m_absolute;
 
-            Path(bool absolute, const std::vector<std::string>& components);
+            Path(bool absolute, std::string path);
         public:
             explicit Path(const std::string& path = "");
 
@@ -74,7 +92,7 @@ namespace TrenchBroom {
             Path prefix(size_t count) const;
             Path suffix(size_t count) const;
             Path subPath(size_t index, size_t count) const;
-            const std::vector<std::string>& components() const;
+            std::vector<std::string> components() const;
 
             std::string filename() const;
             std::string basename() const;
@@ -112,9 +130,28 @@ namespace TrenchBroom {
 
             static std::vector<Path> makeAbsoluteAndCanonical(const std::vector<Path>& paths, const Path& relativePath);
         private:
-            static bool hasDriveSpec(const std::vector<std::string>& components);
-            static bool hasDriveSpec(const std::string& component);
-            std::vector<std::string> resolvePath(bool absolute, const std::vector<std::string>& components) const;
+            /**
+             * Returns the component of the given path that starts at the given offset, and advances the offset to
+             * the start of the next component. The offset is greater than the size of the path after the last
+             * component was returned.
+             */
+            static std::string_view nextComponent(const std::string_view path, size_t& offset) {
+                auto end = path.find(InternalSeparator, offset);
+                if (end == std::string_view::npos) {
+                    end = path.size();
+                }
+                const auto component = path.substr(offset, end - offset);
+                offset = end + 1u;
+                return component;
+            }
+
+            std::string_view firstComponentView() const;
+            std::string_view lastComponentView() const;
+            size_t componentOffset(size_t index) const;
+
+            static bool hasDriveSpec(std::string_view component);
+            static std::vector<std::string_view> resolvePath(bool absolute, std::string_view path);
+            static std::string joinComponents(const std::vector<std::string_view>& components);
         };
 
         std::ostream& operator<<(std::ostream& stream, const Path& path);
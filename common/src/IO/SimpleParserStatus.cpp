@@ -19,13 +19,27 @@
 
 #include "SimpleParserStatus.h"
 
+#include "Logger.h"
+
 #include <string>
 
 namespace TrenchBroom {
     namespace IO {
         SimpleParserStatus::SimpleParserStatus(Logger& logger, const std::string& prefix) :
-        ParserStatus(logger, prefix) {}
+        ParserStatus(logger, prefix),
+        m_hasWarningsOrErrors(false) {}
+
+        bool SimpleParserStatus::hasWarningsOrErrors() const {
+            return m_hasWarningsOrErrors;
+        }
 
         void SimpleParserStatus::doProgress(const double /* progress */) {}
+
+        void SimpleParserStatus::doLog(const LogLevel level, const std::string& str) {
+            if (level == LogLevel::Warn || level == LogLevel::Error) {
+                m_hasWarningsOrErrors = true;
+            }
+            ParserStatus::doLog(level, str);
+        }
     }
 }
@@ -26,10 +26,18 @@
 namespace TrenchBroom {
     namespace IO {
         class SimpleParserStatus : public ParserStatus {
+        private:
+            bool m_hasWarningsOrErrors;
         public:
             explicit SimpleParserStatus(Logger& logger, const std::string& prefix = "");
+
+            /**
+             * Indicates whether any warnings or errors were logged so far.
+             */
+            bool hasWarningsOrErrors() const;
         private:
             void doProgress(double progress) override;
+            void doLog(LogLevel level, const std::string& str) override;
         };
     }
 }
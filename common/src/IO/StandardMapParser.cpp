@@ -19,17 +19,25 @@
 
 #include "StandardMapParser.h"
 
+#include "Assets/TextureName.h"
+#include "IO/BufferedParserStatus.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushFace.h"
 #include "Model/EntityAttributes.h"
 
 #include <kdl/invoke.h>
+#include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/thread_pool.h>
 #include <kdl/vector_set.h>
 
 #include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom {
@@ -39,8 +47,8 @@ namespace TrenchBroom {
             return numberDelim;
         }
 
-        QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str) :
-        Tokenizer(std::move(str), "\"", '\\'),
+        QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str, const size_t firstLine) :
+        Tokenizer(std::move(str), "\"", '\\', firstLine),
         m_skipEol(true) {}
 
         void QuakeMapTokenizer::setSkipEol(bool skipEol) {
@@ -138,7 +146,11 @@ namespace TrenchBroom {
         const std::string StandardMapParser::PatchId = "patchDef2";
 
         StandardMapParser::StandardMapParser(std::string_view str) :
-        m_tokenizer(QuakeMapTokenizer(std::move(str))),
+        StandardMapParser(std::move(str), 1u) {}
+
+        StandardMapParser::StandardMapParser(std::string_view str, const size_t firstLine) :
+        m_str(str),
+        m_tokenizer(QuakeMapTokenizer(m_str, firstLine)),
         m_format(Model::MapFormat::Unknown) {}
 
         StandardMapParser::~StandardMapParser() = default;
@@ -197,9 +209,282 @@ namespace TrenchBroom {
             return format;
         }
 
+        namespace {
+            struct MapChunk {
+                std::string_view str;
+                size_t firstLine;
+            };
+
+            /**
+             * Checks whether the given attribute line contains an even number of unescaped double quotes, i.e.,
+             * whether all quoted strings on that line are terminated.
+             */
+            bool hasTerminatedStrings(const std::string_view line) {
+                auto escaped = false;
+                auto quoted = false;
+                for (const auto c : line) {
+                    if (c == '"' && !escaped) {
+                        quoted = !quoted;
+                    }
+                    escaped = c == '\\' && !escaped;
+                }
+                return !quoted;
+            }
+
+            /**
+             * Splits the given map file into chunks of consecutive top level entities. A new chunk is started at the
+             * first entity that begins at least the given number of bytes after the start of the current chunk.
+             *
+             * Entity boundaries are detected by looking for lines that contain nothing but an opening or a closing
+             * brace. If the file contains a line which this simple scheme cannot classify safely, such as a brace
+             * following other tokens on the same line, or a quoted string that spans multiple lines, the entire file is
+             * returned as a single chunk.
+             */
+            std::vector<MapChunk> splitIntoChunks(const std::string_view str, const size_t chunkSize) {
+                const auto wholeFile = std::vector<MapChunk>{{str, 1u}};
+
+                auto chunks = std::vector<MapChunk>{};
+                auto chunkBegin = size_t(0);
+                auto chunkFirstLine = size_t(1);
+
+                auto depth = size_t(0);
+                auto lineNumber = size_t(1);
+                auto lineBegin = size_t(0);
+                while (lineBegin < str.size()) {
+                    auto lineEnd = str.find_first_of("\n\r", lineBegin);
+                    if (lineEnd == std::string_view::npos) {
+                        lineEnd = str.size();
+                    }
+
+                    auto line = str.substr(lineBegin, lineEnd - lineBegin);
+                    const auto first = line.find_first_not_of(" \t");
+                    line = first == std::string_view::npos ? std::string_view() : line.substr(first, line.find_last_not_of(" \t") - first + 1u);
+
+                    if (line == "{") {
+                        if (depth == 0u && lineBegin - chunkBegin >= chunkSize) {
+                            chunks.push_back({str.substr(chunkBegin, lineBegin - chunkBegin), chunkFirstLine});
+                            chunkBegin = lineBegin;
+                            chunkFirstLine = lineNumber;
+                        }
+                        ++depth;
+                    } else if (line == "}") {
+                        if (depth == 0u) {
+                            return wholeFile;
+                        }
+                        --depth;
+                    } else if (!line.empty()) {
+                        switch (line.front()) {
+                            case '(':
+                            case '/':
+                            case ';':
+                                // faces, patch control points and comments can contain braces in texture names
+                                break;
+                            case '"':
+                                if (!hasTerminatedStrings(line)) {
+                                    return wholeFile;
+                                }
+                                break;
+                            default:
+                                if (line.find_first_of("{}") != std::string_view::npos) {
+                                    return wholeFile;
+                                }
+                                break;
+                        }
+                    }
+
+                    // a CR LF sequence counts as a single line break, just like in the tokenizer
+                    lineBegin = lineEnd;
+                    if (lineBegin < str.size()) {
+                        if (str[lineBegin] == '\r' && lineBegin + 1u < str.size() && str[lineBegin + 1u] == '\n') {
+                            ++lineBegin;
+                        }
+                        ++lineBegin;
+                        ++lineNumber;
+                    }
+                }
+
+                if (depth != 0u) {
+                    return wholeFile;
+                }
+
+                chunks.push_back({str.substr(chunkBegin), chunkFirstLine});
+                return chunks;
+            }
+        }
+
+        /**
+         * Parses a chunk of entities and records the parser callbacks so that they can be replayed by the parser of
+         * the entire file. The messages logged while parsing are replayed along with the callbacks.
+         */
+        class StandardMapParser::ChunkParser : public StandardMapParser {
+        private:
+            struct BeginEntity {
+                size_t line;
+                std::vector<Model::EntityAttribute> attributes;
+                ExtraAttributes extraAttributes;
+            };
+
+            struct EndEntity {
+                size_t startLine;
+                size_t lineCount;
+            };
+
+            struct BeginBrush {
+                size_t line;
+            };
+
+            struct EndBrush {
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+            };
+
+            struct StandardBrushFace {
+                size_t line;
+                Model::MapFormat format;
+                vm::vec3 point1;
+                vm::vec3 point2;
+                vm::vec3 point3;
+                Model::BrushFaceAttributes attribs;
+            };
+
+            struct ValveBrushFace {
+                size_t line;
+                Model::MapFormat format;
+                vm::vec3 point1;
+                vm::vec3 point2;
+                vm::vec3 point3;
+                Model::BrushFaceAttributes attribs;
+                vm::vec3 texAxisX;
+                vm::vec3 texAxisY;
+            };
+
+            using Callback = std::variant<BeginEntity, EndEntity, BeginBrush, EndBrush, StandardBrushFace, ValveBrushFace>;
+
+            struct RecordedCallback {
+                // the number of messages that were logged before the callback
+                size_t messageCount;
+                Callback callback;
+            };
+
+            BufferedParserStatus m_status;
+            std::vector<RecordedCallback> m_callbacks;
+        public:
+            ChunkParser(const MapChunk& chunk, ParserStatus& status) :
+            StandardMapParser(chunk.str, chunk.firstLine),
+            m_status(status) {}
+
+            void parse(const Model::MapFormat format) {
+                setFormat(format);
+                parseEntityList(m_status);
+            }
+
+            void replay(StandardMapParser& parser, ParserStatus& status) {
+                for (const auto& [messageCount, callback] : m_callbacks) {
+                    m_status.forward(messageCount);
+                    std::visit(kdl::overload(
+                        [&](const BeginEntity& c) {
+                            parser.beginEntity(c.line, c.attributes, c.extraAttributes, status);
+                        },
+                        [&](const EndEntity& c) {
+                            parser.endEntity(c.startLine, c.lineCount, status);
+                        },
+                        [&](const BeginBrush& c) {
+                            parser.beginBrush(c.line, status);
+                        },
+                        [&](const EndBrush& c) {
+                            parser.endBrush(c.startLine, c.lineCount, c.extraAttributes, status);
+                        },
+                        [&](const StandardBrushFace& c) {
+                            parser.standardBrushFace(c.line, c.format, c.point1, c.point2, c.point3, c.attribs, status);
+                        },
+                        [&](const ValveBrushFace& c) {
+                            parser.valveBrushFace(c.line, c.format, c.point1, c.point2, c.point3, c.attribs, c.texAxisX, c.texAxisY, status);
+                        }
+                    ), callback);
+                }
+                m_status.forward();
+            }
+        private:
+            void record(Callback callback) {
+                m_callbacks.push_back(RecordedCallback{m_status.messageCount(), std::move(callback)});
+            }
+
+            void onFormatSet(const Model::MapFormat /* format */) override {}
+
+            void onBeginEntity(const size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& /* status */) override {
+                record(BeginEntity{line, attributes, extraAttributes});
+            }
+
+            void onEndEntity(const size_t startLine, const size_t lineCount, ParserStatus& /* status */) override {
+                record(EndEntity{startLine, lineCount});
+            }
+
+            void onBeginBrush(const size_t line, ParserStatus& /* status */) override {
+                record(BeginBrush{line});
+            }
+
+            void onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& /* status */) override {
+                record(EndBrush{startLine, lineCount, extraAttributes});
+            }
+
+            void onStandardBrushFace(const size_t line, const Model::MapFormat format, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, ParserStatus& /* status */) override {
+                record(StandardBrushFace{line, format, point1, point2, point3, attribs});
+            }
+
+            void onValveBrushFace(const size_t line, const Model::MapFormat format, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& /* status */) override {
+                record(ValveBrushFace{line, format, point1, point2, point3, attribs, texAxisX, texAxisY});
+            }
+        };
+
         void StandardMapParser::parseEntities(const Model::MapFormat format, ParserStatus& status) {
             setFormat(format);
 
+            if (!parseEntitiesConcurrently(status)) {
+                parseEntityList(status);
+            }
+        }
+
+        /**
+         * Splits the file into chunks of top level entities which are parsed concurrently. The callbacks of the chunk
+         * parsers are replayed in file order once all chunks have been parsed.
+         *
+         * Returns false if the file is too small to be split or if any chunk could not be parsed. In the latter case,
+         * the file must be parsed sequentially to report the error, because the error may be caused by splitting
+         * the file incorrectly.
+         */
+        bool StandardMapParser::parseEntitiesConcurrently(ParserStatus& status) {
+            static constexpr size_t MinChunkSize = 64u * 1024u;
+
+            auto& pool = kdl::default_thread_pool();
+            if (pool.thread_count() == 0u || m_str.size() < 2u * MinChunkSize) {
+                return false;
+            }
+
+            const auto chunkSize = std::max(MinChunkSize, m_str.size() / (4u * pool.concurrency()));
+            const auto chunks = splitIntoChunks(m_str, chunkSize);
+            if (chunks.size() < 2u) {
+                return false;
+            }
+
+            auto chunkParsers = std::vector<std::unique_ptr<ChunkParser>>{};
+            try {
+                chunkParsers = kdl::vec_parallel_transform(pool, chunks, [&](const MapChunk& chunk) {
+                    auto chunkParser = std::make_unique<ChunkParser>(chunk, status);
+                    chunkParser->parse(m_format);
+                    return chunkParser;
+                });
+            } catch (const ParserException&) {
+                return false;
+            }
+
+            for (auto& chunkParser : chunkParsers) {
+                chunkParser->replay(*this, status);
+            }
+            return true;
+        }
+
+        void StandardMapParser::parseEntityList(ParserStatus& status) {
             auto token = m_tokenizer.peekToken();
             while (token.type() != QuakeMapToken::Eof) {
                 expect(QuakeMapToken::OBrace, token);
@@ -324,7 +609,7 @@ namespace TrenchBroom {
                 expect(QuakeMapToken::String | QuakeMapToken::OParenthesis, token);
                 if (token.hasType(QuakeMapToken::String)) {
                     expect(std::vector<std::string>({ BrushPrimitiveId, PatchId }), token);
-                    if (token.data() == BrushPrimitiveId) {
+                    if (token.view() == BrushPrimitiveId) {
                         parseBrushPrimitive(status, startLine);
                     } else {
                         parsePatch(status, startLine);
@@ -644,8 +929,9 @@ namespace TrenchBroom {
             return std::make_tuple(p1, p2, p3);
         }
 
-        std::string StandardMapParser::parseTextureName(ParserStatus& /* status */) {
-            return m_tokenizer.readAnyString(QuakeMapTokenizer::Whitespace());
+        Assets::TextureName StandardMapParser::parseTextureName(ParserStatus& /* status */) {
+            // interning the name directly avoids allocating a string for every face
+            return Assets::TextureName(m_tokenizer.readAnyString(QuakeMapTokenizer::Whitespace()));
         }
 
         std::tuple<vm::vec3, float, vm::vec3, float> StandardMapParser::parseValveTextureAxes(ParserStatus& /* status */) {
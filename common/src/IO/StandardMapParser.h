@@ -29,11 +29,16 @@
 
 #include <vecmath/forward.h>
 
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class TextureName;
+    }
+
     namespace IO {
         class ParserStatus;
 
@@ -59,7 +64,7 @@ namespace TrenchBroom {
             static const std::string& NumberDelim();
             bool m_skipEol;
         public:
-            explicit QuakeMapTokenizer(std::string_view str);
+            explicit QuakeMapTokenizer(std::string_view str, size_t firstLine = 1);
 
             void setSkipEol(bool skipEol);
         private:
@@ -68,18 +73,23 @@ namespace TrenchBroom {
 
         class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type> {
         private:
+            class ChunkParser;
+
             using Token = QuakeMapTokenizer::Token;
             using AttributeNames = kdl::vector_set<std::string>;
 
             static const std::string BrushPrimitiveId;
             static const std::string PatchId;
 
+            std::string_view m_str;
             QuakeMapTokenizer m_tokenizer;
             Model::MapFormat m_format;
         public:
             explicit StandardMapParser(std::string_view str);
 
             ~StandardMapParser() override;
+        private:
+            StandardMapParser(std::string_view str, size_t firstLine);
         protected:
             Model::MapFormat detectFormat();
 
@@ -91,6 +101,8 @@ namespace TrenchBroom {
         private:
             void setFormat(Model::MapFormat format);
 
+            bool parseEntitiesConcurrently(ParserStatus& status);
+            void parseEntityList(ParserStatus& status);
             void parseEntity(ParserStatus& status);
             void parseEntityAttribute(std::vector<Model::EntityAttribute>& attributes, AttributeNames& names, ParserStatus& status);
 
@@ -110,7 +122,7 @@ namespace TrenchBroom {
             void parsePatch(ParserStatus& status, size_t startLine);
 
             std::tuple<vm::vec3, vm::vec3, vm::vec3> parseFacePoints(ParserStatus& status);
-            std::string parseTextureName(ParserStatus& status);
+            Assets::TextureName parseTextureName(ParserStatus& status);
             std::tuple<vm::vec3, float, vm::vec3, float> parseValveTextureAxes(ParserStatus& status);
             std::tuple<vm::vec3, vm::vec3> parsePrimitiveTextureAxes(ParserStatus& status);
 
@@ -85,9 +85,13 @@ namespace TrenchBroom {
             auto textures = std::vector<Assets::Texture>();
             textures.reserve(texturePaths.size());
 
-            for (const auto& texturePath : texturePaths) {
+            // decompress the files of all textures at once if they are stored in archives
+            const auto files = m_gameFS.openFiles(texturePaths);
+
+            for (size_t i = 0; i < texturePaths.size(); ++i) {
+                const auto& texturePath = texturePaths[i];
                 try {
-                    auto file = m_gameFS.openFile(texturePath);
+                    auto file = files[i] ? files[i] : m_gameFS.openFile(texturePath);
 
                     // Store the absolute path to the original file (may be used by .obj export)
                     IO::Path absolutePath;
@@ -21,7 +21,10 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
+#include <system_error>
 
+#include <kdl/from_chars.h>
 #include <kdl/string_utils.h>
 
 namespace TrenchBroom {
@@ -74,6 +77,14 @@ namespace TrenchBroom {
                 return std::string(m_begin, length());
             }
 
+            /**
+             * Returns a view of the token's characters in the tokenized string. Unlike data(), this does not copy the
+             * characters.
+             */
+            std::string_view view() const {
+                return std::string_view(m_begin, length());
+            }
+
             size_t position() const {
                 return m_position;
             }
@@ -90,14 +101,30 @@ namespace TrenchBroom {
                 return m_column;
             }
 
+            /**
+             * Parses the token as a floating point number. Returns 0 if the token does not start with a number.
+             *
+             * Like std::stod, this accepts infinity, NaN and hexadecimal notation, but these are left to the slower
+             * C library parser.
+             */
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                double result = 0.0;
+                const auto [ptr, ec] = kdl::from_chars(m_begin, m_end, result);
+                if (ec == std::errc::invalid_argument || (ec == std::errc() && ptr != m_end)) {
+                    return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                }
+                return static_cast<T>(result);
             }
 
+            /**
+             * Parses the token as an integer. Returns 0 if the token does not start with an integer.
+             */
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                long result = 0l;
+                kdl::from_chars(m_begin, m_end, result);
+                return static_cast<T>(result);
             }
         };
     }
@@ -28,13 +28,14 @@
 
 namespace TrenchBroom {
     namespace IO {
-        TokenizerState::TokenizerState(const char* begin, const char* end, const std::string& escapableChars, const char escapeChar) :
+        TokenizerState::TokenizerState(const char* begin, const char* end, const std::string& escapableChars, const char escapeChar, const size_t firstLine) :
         m_begin(begin),
         m_cur(m_begin),
         m_end(end),
         m_escapableChars(escapableChars),
         m_escapeChar(escapeChar),
-        m_line(1),
+        m_firstLine(firstLine),
+        m_line(m_firstLine),
         m_column(1),
         m_escaped(false) {}
 
@@ -140,7 +141,7 @@ namespace TrenchBroom {
 
         void TokenizerState::reset() {
             m_cur = m_begin;
-            m_line = 1;
+            m_line = m_firstLine;
             m_column = 1;
             m_escaped = false;
         }
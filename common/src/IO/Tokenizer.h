@@ -34,11 +34,12 @@ namespace TrenchBroom {
             const char* m_end;
             std::string m_escapableChars;
             char m_escapeChar;
+            size_t m_firstLine;
             size_t m_line;
             size_t m_column;
             bool m_escaped;
         public:
-            TokenizerState(const char* begin, const char* end, const std::string& escapableChars, char escapeChar);
+            TokenizerState(const char* begin, const char* end, const std::string& escapableChars, char escapeChar, size_t firstLine = 1);
 
             TokenizerState* clone(const char* begin, const char* end) const;
 
@@ -82,15 +83,15 @@ namespace TrenchBroom {
 
             class SaveState {
             private:
-                StatePtr m_state;
+                TokenizerState& m_state;
                 TokenizerState m_snapshot;
             public:
-                explicit SaveState(StatePtr state) :
+                explicit SaveState(TokenizerState& state) :
                 m_state(state),
-                m_snapshot(m_state->snapshot()) {}
+                m_snapshot(m_state.snapshot()) {}
 
                 ~SaveState() {
-                    m_state->restore(m_snapshot);
+                    m_state.restore(m_snapshot);
                 }
             };
 
@@ -103,8 +104,17 @@ namespace TrenchBroom {
                 return whitespace;
             }
         public:
-            Tokenizer(std::string_view str, const std::string& escapableChars, const char escapeChar) :
-            m_state(std::make_shared<TokenizerState>(str.data(), str.data() + str.size(), escapableChars, escapeChar)) {}
+            /**
+             * Creates a tokenizer for the given string.
+             *
+             * @param str the string to tokenize
+             * @param escapableChars the characters that can be escaped
+             * @param escapeChar the escape character
+             * @param firstLine the line number of the first line of the given string, useful if the string is a
+             * portion of a larger file
+             */
+            Tokenizer(std::string_view str, const std::string& escapableChars, const char escapeChar, const size_t firstLine = 1) :
+            m_state(std::make_shared<TokenizerState>(str.data(), str.data() + str.size(), escapableChars, escapeChar, firstLine)) {}
 
             template <typename OtherType>
             explicit Tokenizer(Tokenizer<OtherType>& nestedTokenizer) :
@@ -124,7 +134,7 @@ namespace TrenchBroom {
             }
 
             Token peekToken(const TokenType skipTokens = 0u) {
-                SaveState oldState(m_state);
+                SaveState oldState(*m_state);
                 return nextToken(skipTokens);
             }
 
@@ -155,13 +165,17 @@ namespace TrenchBroom {
                 return std::string(startPos, static_cast<size_t>(endPos - startPos));
             }
 
-            std::string readAnyString(const std::string& delims) {
+            /**
+             * Reads a quoted string or a string that ends at one of the given delimiters. The returned view refers to
+             * the tokenized string.
+             */
+            std::string_view readAnyString(const std::string& delims) {
                 while (isWhitespace(curChar())) {
                     advance();
                 }
                 const char* startPos = curPos();
                 const char* endPos = (curChar() == '"' ? readQuotedString() : readUntil(delims));
-                return std::string(startPos, static_cast<size_t>(endPos - startPos));
+                return std::string_view(startPos, static_cast<size_t>(endPos - startPos));
             }
 
             std::string unescapeString(const std::string& str) const {
@@ -61,7 +61,8 @@ namespace TrenchBroom {
         }
 
         void WadFileSystem::doReadDirectory() {
-            auto reader = m_file->reader();
+            const auto archive = mapArchive();
+            auto reader = archive->reader();
             if (reader.size() < WadLayout::MinFileSize) {
                 throw FileSystemException("File does not contain a directory.");
             }
@@ -82,7 +83,7 @@ namespace TrenchBroom {
             reader.seekFromBegin(WadLayout::DirOffsetAddress);
             const auto directoryOffset = reader.readSize<int32_t>();
 
-            if (m_file->size() < directoryOffset + entryCount * WadLayout::DirEntrySize) {
+            if (archive->size() < directoryOffset + entryCount * WadLayout::DirEntrySize) {
                 throw FileSystemException("File directory is out of bounds.");
             }
 
@@ -91,7 +92,7 @@ namespace TrenchBroom {
                 const auto entryAddress = reader.readSize<int32_t>();
                 const auto entrySize = reader.readSize<int32_t>();
 
-                if (m_file->size() < entryAddress + entrySize) {
+                if (archive->size() < entryAddress + entrySize) {
                     throw FileSystemException(kdl::str_to_string("File entry at address ", entryAddress, " is out of bounds")) ;
                 }
 
@@ -105,8 +106,7 @@ namespace TrenchBroom {
                 }
 
                 const auto path = IO::Path(entryName).addExtension(entryType);
-                auto file = std::make_shared<FileView>(path, m_file, entryAddress, entrySize);
-                m_root.addFile(path, file);
+                m_root.addFile(path, std::make_unique<ArchiveFileEntry>(*this, path, entryAddress, entrySize));
             }
         }
     }
@@ -19,37 +19,60 @@
 
 #include "ZipFileSystem.h"
 
+#include "Exceptions.h"
 #include "IO/File.h"
-#include "IO/DiskFileSystem.h"
+#include "IO/Reader.h"
+
+#include <kdl/invoke.h>
 
 #include <memory>
 #include <string>
 
+#include <miniz/miniz.h>
+
 namespace TrenchBroom {
     namespace IO {
-        // ZipFileSystem::ZipCompressedFile
+        namespace ZipLayout {
+            static const uint32_t LocalHeaderSignature = 0x04034b50;
+            static const size_t LocalHeaderSize = 30;
+            static const size_t LocalHeaderFilenameLengthOffset = 26;
+        }
 
-        ZipFileSystem::ZipCompressedFile::ZipCompressedFile(ZipFileSystem* owner, const mz_uint fileIndex) :
-        m_owner(owner),
-        m_fileIndex(fileIndex) {}
+        // ZipFileSystem::ZipCompressedFile
 
-        std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
-            const auto path = Path(m_owner->filename(m_fileIndex));
+        ZipFileSystem::ZipCompressedFile::ZipCompressedFile(std::unique_ptr<FileEntry> entry, const size_t uncompressedSize, const unsigned int method, const bool encrypted, const uint32_t checksum) :
+        CompressedFileEntry(std::move(entry), uncompressedSize),
+        m_method(method),
+        m_encrypted(encrypted),
+        m_crc32(checksum) {}
 
-            mz_zip_archive_file_stat stat;
-            if (!mz_zip_reader_file_stat(&m_owner->m_archive, m_fileIndex, &stat)) {
-                throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
+        /**
+         * Inflates the given entry data into a new buffer. Only the entry data and the decompressor state on the stack
+         * are accessed, so this can be called on any thread.
+         */
+        std::unique_ptr<char[]> ZipFileSystem::ZipCompressedFile::decompress(std::shared_ptr<File> file, const size_t uncompressedSize) const {
+            if (m_encrypted) {
+                throw FileSystemException("Encrypted files are not supported: " + file->path().asString());
+            }
+            if (m_method != MZ_DEFLATED) {
+                throw FileSystemException("Unsupported compression method " + std::to_string(m_method) + " for " + file->path().asString());
             }
 
-            const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
+            const auto reader = file->reader().buffer();
             auto data = std::make_unique<char[]>(uncompressedSize);
             auto* begin = data.get();
 
-            if (!mz_zip_reader_extract_to_mem(&m_owner->m_archive, m_fileIndex, begin, uncompressedSize, 0)) {
-                throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
+            const auto inflatedSize = tinfl_decompress_mem_to_mem(begin, uncompressedSize, reader.begin(), reader.size(), 0);
+            if (inflatedSize == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED || inflatedSize != uncompressedSize) {
+                throw FileSystemException("Error decompressing " + file->path().asString());
+            }
+
+            const auto checksum = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(begin), uncompressedSize);
+            if (checksum != m_crc32) {
+                throw FileSystemException("CRC mismatch for " + file->path().asString());
             }
 
-            return std::make_shared<OwningBufferFile>(path, std::move(data), uncompressedSize);
+            return data;
         }
 
         // ZipFileSystem
@@ -62,37 +85,12 @@ namespace TrenchBroom {
             initialize();
         }
 
-        ZipFileSystem::~ZipFileSystem() {
-            mz_zip_reader_end(&m_archive);
-        }
-
-        void ZipFileSystem::doReadDirectory() {
-            mz_zip_zero_struct(&m_archive);
-
-            if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
-                throw FileSystemException("Error calling mz_zip_reader_init_cfile");
-            }
-
-            const mz_uint numFiles = mz_zip_reader_get_num_files(&m_archive);
-            for (mz_uint i = 0; i < numFiles; ++i) {
-                if (!mz_zip_reader_is_file_a_directory(&m_archive, i)) {
-                    const auto path = Path(filename(i));
-                    m_root.addFile(path, std::make_unique<ZipCompressedFile>(this, i));
-                }
-            }
-
-            const auto err = mz_zip_get_last_error(&m_archive);
-            if (err != MZ_ZIP_NO_ERROR) {
-                throw FileSystemException(std::string("Error while reading compressed file: ") + mz_zip_get_error_string(err));
-            }
-        }
-
         /**
          * Helper to get the filename of a file in the zip archive
          */
-        std::string ZipFileSystem::filename(const mz_uint fileIndex) {
+        static std::string filename(mz_zip_archive& archive, const mz_uint fileIndex) {
             // nameLen includes space for the null-terminator byte
-            const mz_uint nameLen = mz_zip_reader_get_filename(&m_archive, fileIndex, nullptr, 0);
+            const mz_uint nameLen = mz_zip_reader_get_filename(&archive, fileIndex, nullptr, 0);
             if (nameLen == 0) {
                 return "";
             }
@@ -101,9 +99,69 @@ namespace TrenchBroom {
             result.resize(static_cast<size_t>(nameLen - 1));
 
             // NOTE: this will overwrite the std::string's null terminator, which is permitted in C++17 and later
-            mz_zip_reader_get_filename(&m_archive, fileIndex, result.data(), nameLen);
+            mz_zip_reader_get_filename(&archive, fileIndex, result.data(), nameLen);
 
             return result;
         }
+
+        void ZipFileSystem::doReadDirectory() {
+            // The zip archive is only used to read the central directory. The entries are located using their local
+            // headers and read directly from the mapped file, which doesn't require any synchronization.
+            const auto file = mapArchive();
+
+            mz_zip_archive archive;
+            mz_zip_zero_struct(&archive);
+
+            if (mz_zip_reader_init_mem(&archive, file->begin(), file->size(), 0) != MZ_TRUE) {
+                throw FileSystemException("Error calling mz_zip_reader_init_mem");
+            }
+            const kdl::invoke_later endArchive([&]() { mz_zip_reader_end(&archive); });
+
+            auto reader = file->reader();
+
+            const mz_uint numFiles = mz_zip_reader_get_num_files(&archive);
+            for (mz_uint i = 0; i < numFiles; ++i) {
+                if (mz_zip_reader_is_file_a_directory(&archive, i)) {
+                    continue;
+                }
+
+                const auto path = Path(filename(archive, i));
+
+                mz_zip_archive_file_stat stat;
+                if (!mz_zip_reader_file_stat(&archive, i, &stat)) {
+                    throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
+                }
+                // the local header repeats the file name and may contain a different extra field
+                const auto headerOffset = static_cast<size_t>(stat.m_local_header_ofs);
+                reader.seekFromBegin(headerOffset);
+                if (reader.readUnsignedInt<uint32_t>() != ZipLayout::LocalHeaderSignature) {
+                    throw FileSystemException("Invalid local header for " + path.asString());
+                }
+
+                reader.seekFromBegin(headerOffset + ZipLayout::LocalHeaderFilenameLengthOffset);
+                const auto filenameLength = reader.readSize<uint16_t>();
+                const auto extraLength = reader.readSize<uint16_t>();
+
+                const auto dataOffset = headerOffset + ZipLayout::LocalHeaderSize + filenameLength + extraLength;
+                const auto compressedSize = static_cast<size_t>(stat.m_comp_size);
+                const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
+                if (dataOffset + compressedSize > file->size()) {
+                    throw FileSystemException("Invalid entry size for " + path.asString());
+                }
+
+                auto entry = std::make_unique<ArchiveFileEntry>(*this, path, dataOffset, compressedSize);
+                if (stat.m_method == 0 && !stat.m_is_encrypted && compressedSize == uncompressedSize) {
+                    // stored entries can be read without copying them
+                    m_root.addFile(path, std::move(entry));
+                } else {
+                    m_root.addFile(path, std::make_unique<ZipCompressedFile>(std::move(entry), uncompressedSize, stat.m_method, stat.m_is_encrypted, stat.m_crc32));
+                }
+            }
+
+            const auto err = mz_zip_get_last_error(&archive);
+            if (err != MZ_ZIP_NO_ERROR) {
+                throw FileSystemException(std::string("Error while reading compressed file: ") + mz_zip_get_error_string(err));
+            }
+        }
     }
 }
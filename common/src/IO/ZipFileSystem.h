@@ -21,36 +21,37 @@
 
 #include "IO/ImageFileSystem.h"
 
+#include <cstdint>
 #include <memory>
 
-#include <miniz/miniz.h>
-
 namespace TrenchBroom {
     namespace IO {
         class Path;
 
+        /**
+         * A file system backed by a zip archive, e.g. a pk3 file.
+         *
+         * The central directory is read when the file system is created. Afterwards, the entries are read directly
+         * from the mapped archive without using any shared state other than the mapping itself, so files can be
+         * opened concurrently, e.g. by FileSystem::openFiles.
+         */
         class ZipFileSystem : public ImageFileSystem {
         private:
-            mz_zip_archive m_archive;
-        private:
-            class ZipCompressedFile : public FileEntry {
+            class ZipCompressedFile : public CompressedFileEntry {
             private:
-                ZipFileSystem* m_owner;
-                mz_uint m_fileIndex;
+                unsigned int m_method;
+                bool m_encrypted;
+                uint32_t m_crc32;
             public:
-                ZipCompressedFile(ZipFileSystem* owner, mz_uint fileIndex);
+                ZipCompressedFile(std::unique_ptr<FileEntry> entry, size_t uncompressedSize, unsigned int method, bool encrypted, uint32_t checksum);
             private:
-                std::shared_ptr<File> doOpen() const override;
+                std::unique_ptr<char[]> decompress(std::shared_ptr<File> file, size_t uncompressedSize) const override;
             };
-            friend class ZipCompressedFile;
         public:
             explicit ZipFileSystem(const Path& path);
             ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
-            ~ZipFileSystem() override;
         private:
             void doReadDirectory() override;
-        private:
-            std::string filename(mz_uint fileIndex);
         };
     }
 }
@@ -23,6 +23,7 @@
 #include "FloatType.h"
 #include "Polyhedron.h"
 #include "Polyhedron_Matcher.h"
+#include "Assets/TextureName.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
@@ -43,7 +44,9 @@
 #include <vecmath/polygon.h>
 #include <vecmath/util.h>
 
+#include <algorithm>
 #include <iterator>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -100,6 +103,54 @@ namespace TrenchBroom {
                 .and_then([&]() { return kdl::result<Brush, BrushError>::success(std::move(brush)); });
         }
 
+        kdl::result<Brush, BrushError> Brush::createFromTopology(std::vector<BrushFace> faces, const std::vector<vm::vec3>& vertices, const std::vector<std::vector<size_t>>& faceVertices) {
+            if (faces.size() < 4u || faces.size() != faceVertices.size()) {
+                return kdl::result<Brush, BrushError>::error(BrushError::InvalidBrush);
+            }
+
+            // every directed edge must occur once, and its opposite must occur as well
+            std::set<std::pair<size_t, size_t>> edges;
+            std::vector<bool> usedVertices(vertices.size(), false);
+            for (const auto& indices : faceVertices) {
+                if (indices.size() < 3u) {
+                    return kdl::result<Brush, BrushError>::error(BrushError::InvalidBrush);
+                }
+                for (size_t i = 0u; i < indices.size(); ++i) {
+                    const auto origin = indices[i];
+                    const auto destination = indices[(i + 1u) % indices.size()];
+                    if (origin >= vertices.size() || origin == destination || !edges.insert(std::make_pair(origin, destination)).second) {
+                        return kdl::result<Brush, BrushError>::error(BrushError::InvalidBrush);
+                    }
+                    usedVertices[origin] = true;
+                }
+            }
+
+            for (const auto& [origin, destination] : edges) {
+                if (edges.count(std::make_pair(destination, origin)) == 0u) {
+                    return kdl::result<Brush, BrushError>::error(BrushError::InvalidBrush);
+                }
+            }
+            if (std::find(std::begin(usedVertices), std::end(usedVertices), false) != std::end(usedVertices)) {
+                return kdl::result<Brush, BrushError>::error(BrushError::InvalidBrush);
+            }
+
+            const auto planes = kdl::vec_transform(faces, [](const BrushFace& face) { return face.boundary(); });
+
+            Brush brush(std::move(faces));
+            brush.m_geometry = std::make_unique<BrushGeometry>(vertices, faceVertices, planes);
+
+            size_t faceIndex = 0u;
+            for (BrushFaceGeometry* faceGeometry : brush.m_geometry->faces()) {
+                brush.m_faces[faceIndex].setGeometry(faceGeometry);
+                faceGeometry->setPayload(faceIndex);
+                ++faceIndex;
+            }
+
+            assert(brush.checkFaceLinks());
+
+            return kdl::result<Brush, BrushError>::success(std::move(brush));
+        }
+
         kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds) {
             // First, add all faces to the brush geometry
             BrushFace::sortFaces(m_faces);
@@ -151,7 +202,8 @@ namespace TrenchBroom {
         }
 
         std::optional<size_t> Brush::findFace(const std::string& textureName) const {
-            return kdl::vec_index_of(m_faces, [&](const BrushFace& face) { return face.attributes().textureName() == textureName; });
+            const auto internedTextureName = Assets::TextureName(textureName);
+            return kdl::vec_index_of(m_faces, [&](const BrushFace& face) { return face.attributes().internedTextureName() == internedTextureName; });
         }
 
         std::optional<size_t> Brush::findFace(const vm::vec3& normal) const {
@@ -881,6 +933,23 @@ namespace TrenchBroom {
             return Brush::create(worldBounds, kdl::vec_concat(m_faces, brush.faces()));
         }
 
+        /**
+         * Returns the offset of the given transformation if it is a pure translation.
+         */
+        static std::optional<vm::vec3> translationOffset(const vm::mat4x4& transformation) {
+            for (size_t col = 0u; col < 3u; ++col) {
+                for (size_t row = 0u; row < 4u; ++row) {
+                    if (transformation[col][row] != (col == row ? 1.0 : 0.0)) {
+                        return std::nullopt;
+                    }
+                }
+            }
+            if (transformation[3][3] != 1.0) {
+                return std::nullopt;
+            }
+            return vm::vec3(transformation[3][0], transformation[3][1], transformation[3][2]);
+        }
+
         kdl::result<Brush, BrushError> Brush::transform(const vm::bbox3& worldBounds, const vm::mat4x4& transformation, const bool lockTextures) const {
             auto faces = m_faces;
             for (auto& face : faces) {
@@ -888,10 +957,46 @@ namespace TrenchBroom {
                     return kdl::result<Brush, BrushError>::error(BrushError::InvalidFace);
                 }
             }
-            
+
+            if (m_geometry != nullptr) {
+                if (const auto delta = translationOffset(transformation)) {
+                    return createTranslatedBrush(worldBounds, std::move(faces), *delta);
+                }
+            }
+
             return Brush::create(worldBounds, std::move(faces));
         }
 
+        kdl::result<Brush, BrushError> Brush::createTranslatedBrush(const vm::bbox3& worldBounds, std::vector<BrushFace> faces, const vm::vec3& delta) const {
+            // Building the geometry clips it against the world bounds, so only brushes which stay strictly inside the
+            // world bounds can be translated directly.
+            const auto translatedBounds = bounds().translate(delta);
+            for (size_t i = 0u; i < 3u; ++i) {
+                if (translatedBounds.min[i] <= worldBounds.min[i] || translatedBounds.max[i] >= worldBounds.max[i]) {
+                    return Brush::create(worldBounds, std::move(faces));
+                }
+            }
+
+            auto geometry = std::make_unique<BrushGeometry>(*m_geometry, CopyCallback());
+            geometry->translate(delta);
+            geometry->correctVertexPositions();
+
+            Brush brush(std::move(faces));
+            for (BrushFaceGeometry* faceGeometry : geometry->faces()) {
+                const auto faceIndex = faceGeometry->payload();
+                assert(faceIndex.has_value());
+
+                BrushFace& face = brush.m_faces[*faceIndex];
+                faceGeometry->setPlane(face.boundary());
+                face.setGeometry(faceGeometry);
+            }
+            brush.m_geometry = std::move(geometry);
+
+            assert(brush.checkFaceLinks());
+
+            return kdl::result<Brush, BrushError>::success(std::move(brush));
+        }
+
         bool Brush::contains(const vm::bbox3& bounds) const {
             if (!this->bounds().contains(bounds)) {
                 return false;
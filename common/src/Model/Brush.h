@@ -39,6 +39,14 @@ namespace TrenchBroom {
 
         enum class BrushError;
 
+        /**
+         * A convex brush, consisting of its faces and the polyhedron they bound.
+         *
+         * Brushes do not share any mutable state, so the geometric operations (create, clip, transform, subtract,
+         * intersect, moveVertices and the like) may be called concurrently on different threads, as long as no thread
+         * modifies a brush that another thread is using. Several threads may read the same brush at once, e.g. to use
+         * it as a subtrahend. The textures which brush faces refer to are reference counted atomically.
+         */
         class Brush {
         private:
             class CopyCallback;
@@ -65,6 +73,16 @@ namespace TrenchBroom {
             ~Brush();
             
             static kdl::result<Brush, BrushError> create(const vm::bbox3& worldBounds, std::vector<BrushFace> faces);
+
+            /**
+             * Creates a brush from the given faces and a previously computed geometry, e.g. one that was read from a
+             * cache. Unlike create, this does not clip the world bounds by the faces. The vertices of the i-th face
+             * are given by the indices in faceVertices[i] in counter clockwise order.
+             *
+             * Returns BrushError::InvalidBrush if the given topology does not describe a closed polyhedron with one
+             * polygon per face.
+             */
+            static kdl::result<Brush, BrushError> createFromTopology(std::vector<BrushFace> faces, const std::vector<vm::vec3>& vertices, const std::vector<std::vector<size_t>>& faceVertices);
         private:
             Brush(std::vector<BrushFace> faces);
 
@@ -236,6 +254,12 @@ namespace TrenchBroom {
              * @return the transformed brush or an error if the operation fails
              */
             kdl::result<Brush, BrushError> transform(const vm::bbox3& worldBounds, const vm::mat4x4& transformation, bool lockTextures) const;
+        private:
+            /**
+             * Creates a brush from the given faces, which must be the faces of this brush translated by the given offset,
+             * by translating a copy of this brush's geometry instead of building it from the face planes.
+             */
+            kdl::result<Brush, BrushError> createTranslatedBrush(const vm::bbox3& worldBounds, std::vector<BrushFace> faces, const vm::vec3& delta) const;
         public:
             bool contains(const vm::bbox3& bounds) const;
             bool contains(const Brush& brush) const;
@@ -47,6 +47,7 @@
 
 #include <sstream>
 #include <string>
+#include <variant>
 
 namespace TrenchBroom {
     namespace Model {
@@ -64,7 +65,7 @@ namespace TrenchBroom {
         m_boundary(other.m_boundary),
         m_attributes(other.m_attributes),
         m_textureReference(other.m_textureReference),
-        m_texCoordSystem(other.m_texCoordSystem ? other.m_texCoordSystem->clone() : nullptr),
+        m_texCoordSystem(other.m_texCoordSystem),
         m_geometry(nullptr),
         m_lineNumber(other.m_lineNumber),
         m_lineCount(other.m_lineCount),
@@ -107,7 +108,7 @@ namespace TrenchBroom {
 
         BrushFace::~BrushFace() = default;
 
-        kdl::result<BrushFace, BrushError> BrushFace::create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem) {
+        kdl::result<BrushFace, BrushError> BrushFace::create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem) {
             Points points = {{ vm::correct(point0), vm::correct(point1), vm::correct(point2) }};
             const auto [result, plane] = vm::from_points(points[0], points[1], points[2]);
             if (result) {
@@ -117,7 +118,7 @@ namespace TrenchBroom {
             }
         }
 
-        BrushFace::BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem) :
+        BrushFace::BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem) :
         m_points(points),
         m_boundary(boundary),
         m_attributes(attributes),
@@ -126,15 +127,13 @@ namespace TrenchBroom {
         m_lineNumber(0),
         m_lineCount(0),
         m_selected(false),
-        m_markedToRenderFace(false) {
-            ensure(m_texCoordSystem != nullptr, "texCoordSystem is null");
-        }
+        m_markedToRenderFace(false) {}
 
         bool operator==(const BrushFace& lhs, const BrushFace& rhs) {
             return lhs.m_points == rhs.m_points &&
             lhs.m_boundary == rhs.m_boundary &&
             lhs.m_attributes == rhs.m_attributes &&
-            *lhs.m_texCoordSystem == *rhs.m_texCoordSystem &&
+            lhs.texCoordSystem() == rhs.texCoordSystem() &&
             lhs.m_lineNumber == rhs.m_lineNumber &&
             lhs.m_lineCount == rhs.m_lineCount &&
             lhs.m_selected == rhs.m_selected;
@@ -172,11 +171,11 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<TexCoordSystemSnapshot> BrushFace::takeTexCoordSystemSnapshot() const {
-            return m_texCoordSystem->takeSnapshot();
+            return texCoordSystem().takeSnapshot();
         }
 
         void BrushFace::restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot) {
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(mutableTexCoordSystem());
         }
 
         void BrushFace::copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attributes, const vm::plane3& sourceFacePlane, const WrapStyle wrapStyle) {
@@ -184,16 +183,16 @@ namespace TrenchBroom {
             const auto seam = vm::intersect_plane_plane(sourceFacePlane, m_boundary);
             const auto refPoint = vm::project_point(seam, center());
 
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(mutableTexCoordSystem());
 
             // Get the texcoords at the refPoint using the source face's attributes and tex coord system
-            const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, attributes, vm::vec2f::one());
+            const auto desriedCoords = texCoordSystem().getTexCoords(refPoint, attributes, vm::vec2f::one());
 
-            m_texCoordSystem->updateNormal(sourceFacePlane.normal, m_boundary.normal, m_attributes, wrapStyle);
+            mutableTexCoordSystem().updateNormal(sourceFacePlane.normal, m_boundary.normal, m_attributes, wrapStyle);
 
             // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
             if (!vm::is_zero(seam.direction, vm::C::almost_zero())) {
-                const auto currentCoords = m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+                const auto currentCoords = texCoordSystem().getTexCoords(refPoint, m_attributes, vm::vec2f::one());
                 const auto offsetChange = desriedCoords - currentCoords;
                 m_attributes.setOffset(correct(modOffset(m_attributes.offset() + offsetChange), 4));
             }
@@ -271,12 +270,12 @@ namespace TrenchBroom {
         void BrushFace::setAttributes(const BrushFaceAttributes& attributes) {
             const float oldRotation = m_attributes.rotation();
             m_attributes = attributes;
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+            mutableTexCoordSystem().setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
         }
 
         bool BrushFace::setAttributes(const BrushFace& other) {
             auto result = false;
-            result |= m_attributes.setTextureName(other.attributes().textureName());
+            result |= m_attributes.setTextureName(other.attributes().internedTextureName());
             result |= m_attributes.setXOffset(other.attributes().xOffset());
             result |= m_attributes.setYOffset(other.attributes().yOffset());
             result |= m_attributes.setRotation(other.attributes().rotation());
@@ -289,13 +288,15 @@ namespace TrenchBroom {
         }
 
         void BrushFace::resetTexCoordSystemCache() {
-            if (m_texCoordSystem != nullptr) {
-                m_texCoordSystem->resetCache(m_points[0], m_points[1], m_points[2], m_attributes);
-            }
+            mutableTexCoordSystem().resetCache(m_points[0], m_points[1], m_points[2], m_attributes);
         }
 
         const TexCoordSystem& BrushFace::texCoordSystem() const {
-            return *m_texCoordSystem;
+            return std::visit([](const TexCoordSystem& texCoordSystem) -> const TexCoordSystem& { return texCoordSystem; }, m_texCoordSystem);
+        }
+
+        TexCoordSystem& BrushFace::mutableTexCoordSystem() {
+            return std::visit([](TexCoordSystem& texCoordSystem) -> TexCoordSystem& { return texCoordSystem; }, m_texCoordSystem);
         }
 
         const Assets::Texture* BrushFace::texture() const {
@@ -325,44 +326,48 @@ namespace TrenchBroom {
         }
 
         vm::vec3 BrushFace::textureXAxis() const {
-            return m_texCoordSystem->xAxis();
+            return texCoordSystem().xAxis();
         }
 
         vm::vec3 BrushFace::textureYAxis() const {
-            return m_texCoordSystem->yAxis();
+            return texCoordSystem().yAxis();
         }
 
         void BrushFace::resetTextureAxes() {
-            m_texCoordSystem->resetTextureAxes(m_boundary.normal);
+            mutableTexCoordSystem().resetTextureAxes(m_boundary.normal);
         }
 
         void BrushFace::convertToParaxial() {
-            auto [newTexCoordSystem, newAttributes] = m_texCoordSystem->toParaxial(m_points[0], m_points[1], m_points[2], m_attributes);
+            if (const auto* parallel = std::get_if<ParallelTexCoordSystem>(&m_texCoordSystem)) {
+                auto [newTexCoordSystem, newAttributes] = ParaxialTexCoordSystem::fromParallel(m_points[0], m_points[1], m_points[2], m_attributes, parallel->xAxis(), parallel->yAxis());
 
-            m_attributes = newAttributes;
-            m_texCoordSystem = std::move(newTexCoordSystem);
+                m_attributes = newAttributes;
+                m_texCoordSystem = std::move(newTexCoordSystem);
+            }
         }
 
         void BrushFace::convertToParallel() {
-            auto [newTexCoordSystem, newAttributes] = m_texCoordSystem->toParallel(m_points[0], m_points[1], m_points[2], m_attributes);
+            if (std::holds_alternative<ParaxialTexCoordSystem>(m_texCoordSystem)) {
+                auto [newTexCoordSystem, newAttributes] = ParallelTexCoordSystem::fromParaxial(m_points[0], m_points[1], m_points[2], m_attributes);
 
-            m_attributes = newAttributes;
-            m_texCoordSystem = std::move(newTexCoordSystem);
+                m_attributes = newAttributes;
+                m_texCoordSystem = std::move(newTexCoordSystem);
+            }
         }
 
 
         void BrushFace::moveTexture(const vm::vec3& up, const vm::vec3& right, const vm::vec2f& offset) {
-            m_texCoordSystem->moveTexture(m_boundary.normal, up, right, offset, m_attributes);
+            texCoordSystem().moveTexture(m_boundary.normal, up, right, offset, m_attributes);
         }
 
         void BrushFace::rotateTexture(const float angle) {
             const float oldRotation = m_attributes.rotation();
-            m_texCoordSystem->rotateTexture(m_boundary.normal, angle, m_attributes);
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+            texCoordSystem().rotateTexture(m_boundary.normal, angle, m_attributes);
+            mutableTexCoordSystem().setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
         }
 
         void BrushFace::shearTexture(const vm::vec2f& factors) {
-            m_texCoordSystem->shearTexture(m_boundary.normal, factors);
+            mutableTexCoordSystem().shearTexture(m_boundary.normal, factors);
         }
 
         kdl::result<void, BrushError> BrushFace::transform(const vm::mat4x4& transform, const bool lockTexture) {
@@ -382,7 +387,7 @@ namespace TrenchBroom {
 
             return setPoints(m_points[0], m_points[1], m_points[2])
                 .and_then([&]() {
-                    m_texCoordSystem->transform(oldBoundary, m_boundary, transform, m_attributes, textureSize(), lockTexture, invariant);
+                    mutableTexCoordSystem().transform(oldBoundary, m_boundary, transform, m_attributes, textureSize(), lockTexture, invariant);
                     return kdl::result<void, BrushError>::success();
                 });
         }
@@ -411,12 +416,12 @@ namespace TrenchBroom {
                     const auto refPoint = project_point(seam, center());
 
                     // Get the texcoords at the refPoint using the old face's attribs and tex coord system
-                    const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+                    const auto desriedCoords = texCoordSystem().getTexCoords(refPoint, m_attributes, vm::vec2f::one());
 
-                    m_texCoordSystem->updateNormal(oldPlane.normal, m_boundary.normal, m_attributes, WrapStyle::Projection);
+                    mutableTexCoordSystem().updateNormal(oldPlane.normal, m_boundary.normal, m_attributes, WrapStyle::Projection);
 
                     // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
-                    const auto currentCoords = m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+                    const auto currentCoords = texCoordSystem().getTexCoords(refPoint, m_attributes, vm::vec2f::one());
                     const auto offsetChange = desriedCoords - currentCoords;
                     m_attributes.setOffset(correct(modOffset(m_attributes.offset() + offsetChange), 4));
                 }
@@ -425,7 +430,7 @@ namespace TrenchBroom {
         }
 
         vm::mat4x4 BrushFace::projectToBoundaryMatrix() const {
-            const auto texZAxis = m_texCoordSystem->fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
+            const auto texZAxis = texCoordSystem().fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
             const auto worldToPlaneMatrix = vm::plane_projection_matrix(m_boundary.distance, m_boundary.normal, texZAxis);
             const auto [invertible, planeToWorldMatrix] = vm::invert(worldToPlaneMatrix); assert(invertible); unused(invertible);
             return planeToWorldMatrix * vm::mat4x4::zero_out<2>() * worldToPlaneMatrix;
@@ -433,22 +438,22 @@ namespace TrenchBroom {
 
         vm::mat4x4 BrushFace::toTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, const bool project) const {
             if (project) {
-                return vm::mat4x4::zero_out<2>() * m_texCoordSystem->toMatrix(offset, scale);
+                return vm::mat4x4::zero_out<2>() * texCoordSystem().toMatrix(offset, scale);
             } else {
-                return m_texCoordSystem->toMatrix(offset, scale);
+                return texCoordSystem().toMatrix(offset, scale);
             }
         }
 
         vm::mat4x4 BrushFace::fromTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, const bool project) const {
             if (project) {
-                return projectToBoundaryMatrix() * m_texCoordSystem->fromMatrix(offset, scale);
+                return projectToBoundaryMatrix() * texCoordSystem().fromMatrix(offset, scale);
             } else {
-                return m_texCoordSystem->fromMatrix(offset, scale);
+                return texCoordSystem().fromMatrix(offset, scale);
             }
         }
 
         float BrushFace::measureTextureAngle(const vm::vec2f& center, const vm::vec2f& point) const {
-            return m_texCoordSystem->measureAngle(m_attributes.rotation(), center, point);
+            return texCoordSystem().measureAngle(m_attributes.rotation(), center, point);
         }
 
         size_t BrushFace::vertexCount() const {
@@ -493,6 +498,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) const {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -513,7 +522,11 @@ namespace TrenchBroom {
         }
 
         vm::vec2f BrushFace::textureCoords(const vm::vec3& point) const {
-            return m_texCoordSystem->getTexCoords(point, m_attributes, textureSize());
+            return texCoordSystem().getTexCoords(point, m_attributes, textureSize());
+        }
+
+        void BrushFace::textureCoords(const size_t count, const FloatType* xs, const FloatType* ys, const FloatType* zs, float* us, float* vs) const {
+            texCoordSystem().getTexCoords(count, xs, ys, zs, m_attributes, textureSize(), us, vs);
         }
 
         FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const {
@@ -24,6 +24,8 @@
 #include "Assets/AssetReference.h"
 #include "Model/BrushFaceAttributes.h"
 #include "Model/BrushGeometry.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
 #include "Model/Tag.h" // BrushFace inherits from Taggable
 
 #include <kdl/result_forward.h>
@@ -37,6 +39,7 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom {
@@ -50,6 +53,12 @@ namespace TrenchBroom {
         enum class WrapStyle;
         enum class BrushError;
 
+        /**
+         * The texture coordinate system of a brush face. It is stored by value so that copying a face does not
+         * require cloning the coordinate system on the heap.
+         */
+        using TexCoordSystemVariant = std::variant<ParaxialTexCoordSystem, ParallelTexCoordSystem>;
+
         class BrushFace : public Taggable {
         public:
             /*
@@ -86,7 +95,7 @@ namespace TrenchBroom {
             BrushFaceAttributes m_attributes;
 
             Assets::AssetReference<Assets::Texture> m_textureReference;
-            std::unique_ptr<TexCoordSystem> m_texCoordSystem;
+            TexCoordSystemVariant m_texCoordSystem;
             BrushFaceGeometry* m_geometry;
 
             mutable size_t m_lineNumber;
@@ -104,9 +113,9 @@ namespace TrenchBroom {
 
             ~BrushFace();
 
-            static kdl::result<BrushFace, BrushError> create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem);
+            static kdl::result<BrushFace, BrushError> create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem);
 
-            BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem);
+            BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem);
 
             friend bool operator==(const BrushFace& lhs, const BrushFace& rhs);
             friend bool operator!=(const BrushFace& lhs, const BrushFace& rhs);
@@ -171,6 +180,7 @@ namespace TrenchBroom {
             void setGeometry(BrushFaceGeometry* geometry);
 
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount) const;
 
             bool selected() const;
@@ -178,15 +188,18 @@ namespace TrenchBroom {
             void deselect();
 
             vm::vec2f textureCoords(const vm::vec3& point) const;
+            void textureCoords(size_t count, const FloatType* xs, const FloatType* ys, const FloatType* zs, float* us, float* vs) const;
 
             FloatType intersectWithRay(const vm::ray3& ray) const;
         private:
             kdl::result<void, BrushError> setPoints(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2);
             void correctPoints();
+
+            TexCoordSystem& mutableTexCoordSystem();
         public: // brush renderer
             /**
              * This is used to cache results of evaluating the BrushRenderer Filter.
-             * It's only valid within a call to `BrushRenderer::validateBrush`.
+             * It's only valid within a call to `BrushRenderer::validate`.
              *
              * @param marked    whether the face is going to be rendered.
              */
@@ -29,6 +29,9 @@ namespace TrenchBroom {
         const std::string BrushFaceAttributes::NoTextureName = "__TB_empty";
 
         BrushFaceAttributes::BrushFaceAttributes(const std::string& textureName) :
+        BrushFaceAttributes(Assets::TextureName(textureName)) {}
+
+        BrushFaceAttributes::BrushFaceAttributes(const Assets::TextureName& textureName) :
         m_textureName(textureName),
         m_offset(vm::vec2f::zero()),
         m_scale(vm::vec2f(1.0f, 1.0f)),
@@ -48,6 +51,9 @@ namespace TrenchBroom {
         m_color(other.m_color) {}
 
         BrushFaceAttributes::BrushFaceAttributes(const std::string& textureName, const BrushFaceAttributes& other) :
+        BrushFaceAttributes(Assets::TextureName(textureName), other) {}
+
+        BrushFaceAttributes::BrushFaceAttributes(const Assets::TextureName& textureName, const BrushFaceAttributes& other) :
         m_textureName(textureName),
         m_offset(other.m_offset),
         m_scale(other.m_scale),
@@ -87,7 +93,7 @@ namespace TrenchBroom {
         }
 
         BrushFaceAttributes BrushFaceAttributes::takeSnapshot() const {
-            BrushFaceAttributes result(m_textureName);
+            BrushFaceAttributes result(m_textureName.str());
             result.m_offset = m_offset;
             result.m_scale = m_scale;
             result.m_rotation = m_rotation;
@@ -99,6 +105,10 @@ namespace TrenchBroom {
         }
 
         const std::string& BrushFaceAttributes::textureName() const {
+            return m_textureName.str();
+        }
+
+        const Assets::TextureName& BrushFaceAttributes::internedTextureName() const {
             return m_textureName;
         }
 
@@ -163,6 +173,10 @@ namespace TrenchBroom {
         }
         
         bool BrushFaceAttributes::setTextureName(const std::string& textureName) {
+            return setTextureName(Assets::TextureName(textureName));
+        }
+
+        bool BrushFaceAttributes::setTextureName(const Assets::TextureName& textureName) {
             if (textureName == m_textureName) {
                 return false;
             } else {
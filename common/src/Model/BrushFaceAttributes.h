@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Color.h"
+#include "Assets/TextureName.h"
 
 #include <vecmath/forward.h>
 
@@ -35,7 +36,7 @@ namespace TrenchBroom {
         public:
             static const std::string NoTextureName;
         private:
-            std::string m_textureName;
+            Assets::TextureName m_textureName;
 
             vm::vec2f m_offset;
             vm::vec2f m_scale;
@@ -48,8 +49,10 @@ namespace TrenchBroom {
             Color m_color;
         public:
             BrushFaceAttributes(const std::string& textureName);
+            explicit BrushFaceAttributes(const Assets::TextureName& textureName);
             BrushFaceAttributes(const BrushFaceAttributes& other);
             BrushFaceAttributes(const std::string& textureName, const BrushFaceAttributes& other);
+            BrushFaceAttributes(const Assets::TextureName& textureName, const BrushFaceAttributes& other);
 
             BrushFaceAttributes& operator=(BrushFaceAttributes other);
             
@@ -59,6 +62,7 @@ namespace TrenchBroom {
             BrushFaceAttributes takeSnapshot() const;
 
             const std::string& textureName() const;
+            const Assets::TextureName& internedTextureName() const;
 
             const vm::vec2f& offset() const;
             float xOffset() const;
@@ -82,6 +86,7 @@ namespace TrenchBroom {
             bool valid() const;
 
             bool setTextureName(const std::string& textureName);
+            bool setTextureName(const Assets::TextureName& textureName);
             bool setOffset(const vm::vec2f& offset);
             bool setXOffset(float xOffset);
             bool setYOffset(float yOffset);
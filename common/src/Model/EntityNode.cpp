@@ -43,6 +43,7 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <functional>
 #include <optional>
 #include <vector>
 
@@ -242,24 +243,30 @@ namespace TrenchBroom {
             return findContainingGroup(this);
         }
 
+        kdl::result<void, TransformError> EntityNode::transformBrushes(const std::function<kdl::result<void, TransformError>(BrushNode*)>& transformBrush) {
+            const NotifyNodeChange nodeChange(this);
+
+            for (auto* child : children()) {
+                const auto result = child->accept(kdl::overload(
+                    [] (WorldNode*)  { return kdl::result<void, TransformError>::success(); },
+                    [] (LayerNode*)  { return kdl::result<void, TransformError>::success(); },
+                    [] (GroupNode*)  { return kdl::result<void, TransformError>::success(); },
+                    [] (EntityNode*) { return kdl::result<void, TransformError>::success(); },
+                    [&](BrushNode* brush) { return transformBrush(brush); }
+                ));
+                if (!result.is_success()) {
+                    return result;
+                }
+            }
+
+            return kdl::result<void, TransformError>::success();
+        }
+
         kdl::result<void, TransformError> EntityNode::doTransform(const vm::bbox3& worldBounds, const vm::mat4x4& transformation, bool lockTextures) {
             if (hasChildren()) {
-                const NotifyNodeChange nodeChange(this);
-
-                for (auto* child : children()) {
-                    const auto result = child->accept(kdl::overload(
-                        [] (WorldNode*)  { return kdl::result<void, TransformError>::success(); },
-                        [] (LayerNode*)  { return kdl::result<void, TransformError>::success(); },
-                        [] (GroupNode*)  { return kdl::result<void, TransformError>::success(); },
-                        [] (EntityNode*) { return kdl::result<void, TransformError>::success(); },
-                        [&](BrushNode* brush) {
-                            return brush->transform(worldBounds, transformation, lockTextures);
-                        }
-                    ));
-                    if (!result.is_success()) {
-                        return result;
-                    }
-                }
+                return transformBrushes([&](BrushNode* brush) {
+                    return brush->transform(worldBounds, transformation, lockTextures);
+                });
             } else {
                 auto entity = m_entity;
                 entity.transform(transformation);
@@ -31,6 +31,7 @@
 #include <vecmath/bbox.h>
 #include <vecmath/util.h>
 
+#include <functional>
 #include <optional>
 #include <string>
 #include <vector>
@@ -43,6 +44,8 @@ namespace TrenchBroom {
     }
 
     namespace Model {
+        class BrushNode;
+
         class EntityNode : public AttributableNode, public Object {
         public:
             static const HitType::Type EntityHitType;
@@ -63,6 +66,16 @@ namespace TrenchBroom {
         public: // entity model
             const vm::bbox3& modelBounds() const;
             void setModelFrame(const Assets::EntityModelFrame* modelFrame);
+        public: // brush transformation
+            /**
+             * Calls the given function for every brush of this entity. The entity is notified of the change once
+             * before and after all brushes have been transformed. Stops at the first brush that cannot be
+             * transformed.
+             *
+             * @param transformBrush the function that transforms a single brush
+             * @return success if every brush was transformed, or the first error otherwise
+             */
+            kdl::result<void, TransformError> transformBrushes(const std::function<kdl::result<void, TransformError>(BrushNode*)>& transformBrush);
         private: // implement Node interface
             const vm::bbox3& doGetLogicalBounds() const override;
             const vm::bbox3& doGetPhysicalBounds() const override;
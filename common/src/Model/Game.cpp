@@ -20,6 +20,7 @@
 #include "Game.h"
 
 #include "Assets/EntityDefinitionFileSpec.h"
+#include "IO/IOUtils.h"
 #include "Model/BrushFace.h"
 #include "Model/GameFactory.h"
 #include "Model/WorldNode.h"
@@ -82,8 +83,12 @@ namespace TrenchBroom {
             return doLoadMap(format, worldBounds, path, logger);
         }
 
-        void Game::writeMap(WorldNode& world, const IO::Path& path) const {
-            doWriteMap(world, path);
+        IO::TextHash Game::writeMap(WorldNode& world, const IO::Path& path) const {
+            return doWriteMap(world, path, nullptr);
+        }
+
+        IO::TextHash Game::writeMap(WorldNode& world, const IO::Path& path, const IO::PreviousMapFile& previousFile) const {
+            return doWriteMap(world, path, &previousFile);
         }
 
         void Game::exportMap(WorldNode& world, const Model::ExportFormat format, const IO::Path& path) const {
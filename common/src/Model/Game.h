@@ -43,6 +43,11 @@ namespace TrenchBroom {
         class TextureManager;
     }
 
+    namespace IO {
+        struct PreviousMapFile;
+        struct TextHash;
+    }
+
     namespace Model {
         class AttributableNode;
         class BrushFace;
@@ -96,7 +101,22 @@ namespace TrenchBroom {
         public: // loading and writing map files
             std::unique_ptr<WorldNode> newMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const;
             std::unique_ptr<WorldNode> loadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const;
-            void writeMap(WorldNode& world, const IO::Path& path) const;
+
+            /**
+             * Writes the given world to the given path.
+             *
+             * @return the hash of the written file
+             */
+            IO::TextHash writeMap(WorldNode& world, const IO::Path& path) const;
+
+            /**
+             * Writes the given world to the given path, copying the entities that were not modified since the given
+             * previous map file was written from it. The text of the previous map file must include its header, and
+             * it must not be read from the given path since that file is overwritten.
+             *
+             * @return the hash of the written file
+             */
+            IO::TextHash writeMap(WorldNode& world, const IO::Path& path, const IO::PreviousMapFile& previousFile) const;
             void exportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path) const;
         public: // parsing and serializing objects
             std::vector<Node*> parseNodes(const std::string& str, WorldNode& world, const vm::bbox3& worldBounds, Logger& logger) const;
@@ -145,7 +165,7 @@ namespace TrenchBroom {
 
             virtual std::unique_ptr<WorldNode> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const = 0;
             virtual std::unique_ptr<WorldNode> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const = 0;
-            virtual void doWriteMap(WorldNode& world, const IO::Path& path) const = 0;
+            virtual IO::TextHash doWriteMap(WorldNode& world, const IO::Path& path, const IO::PreviousMapFile* previousFile) const = 0;
             virtual void doExportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path) const = 0;
 
             virtual std::vector<Node*> doParseNodes(const std::string& str, WorldNode& world, const vm::bbox3& worldBounds, Logger& logger) const = 0;
@@ -56,6 +56,8 @@ namespace TrenchBroom {
         }
 
         void GameFileSystem::reloadShaders() {
+            // pick up any files that were added to or removed from the game directories since they were cached
+            refresh();
             if (m_shaderFS != nullptr) {
                 m_shaderFS->reload();
             }
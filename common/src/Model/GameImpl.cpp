@@ -23,6 +23,8 @@
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Assets/Palette.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityDefinitionFileSpec.h"
@@ -39,6 +41,8 @@
 #include "IO/FileMatcher.h"
 #include "IO/GameConfigParser.h"
 #include "IO/IOUtils.h"
+#include "IO/MapCache.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
@@ -177,28 +181,67 @@ namespace TrenchBroom {
 
         std::unique_ptr<WorldNode> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
             IO::SimpleParserStatus parserStatus(logger);
-            auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+            const auto fixedPath = IO::Disk::fixPath(path);
+            auto file = IO::Disk::openFile(fixedPath);
             auto fileReader = file->reader().buffer();
+
+            if (!pref(Preferences::UseMapCache)) {
+                IO::WorldReader worldReader(fileReader.stringView());
+                return worldReader.read(format, worldBounds, parserStatus);
+            }
+
+            const auto cachePath = IO::MapCache::cachePath(fixedPath);
+            if (auto world = IO::MapCache::readWorld(cachePath, fileReader.stringView(), gameName(), format, worldBounds)) {
+                logger.debug() << "Loaded map from cache file " << cachePath.asString();
+                return world;
+            }
+
             IO::WorldReader worldReader(fileReader.stringView());
-            return worldReader.read(format, worldBounds, parserStatus);
+            auto world = worldReader.read(format, worldBounds, parserStatus);
+
+            // the cache does not store the parser messages, so they would not be shown when the map is loaded again
+            if (!parserStatus.hasWarningsOrErrors()) {
+                try {
+                    IO::MapCache::writeWorld(cachePath, *world, fileReader.stringView(), gameName(), worldBounds);
+                } catch (const FileSystemException& e) {
+                    logger.warn() << "Could not write map cache file: " << e.what();
+                }
+            }
+
+            return world;
         }
 
-        void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path, const bool exporting) const {
+        IO::TextHash GameImpl::doWriteMap(WorldNode& world, const IO::Path& path, const bool exporting, const IO::PreviousMapFile* previousFile) const {
             const auto mapFormatName = formatName(world.format());
 
-            std::ofstream file = openPathAsOutputStream(path);
-            if (!file) {
+            // binary mode so that the hashed text is exactly what ends up in the file
+            std::ofstream fileStream = openPathAsOutputStream(path, std::ios::out | std::ios::binary);
+            if (!fileStream) {
                 throw FileSystemException("Cannot open file: " + path.asString());
             }
+
+            // hash the file while it is written so that it need not be read again to detect later changes
+            IO::HashingOutputStream file(fileStream);
             IO::writeGameComment(file, gameName(), mapFormatName);
 
-            IO::NodeWriter writer(world, file);
+            auto serializer = IO::MapFileSerializer::create(world.format(), file);
+            if (previousFile != nullptr) {
+                // if the previous file was written for another game or format, all entities are serialized again
+                if (const auto previousText = IO::skipGameComment(previousFile->text, gameName(), mapFormatName)) {
+                    serializer = IO::MapFileSerializer::create(world.format(), file, IO::PreviousMapFile{*previousText, previousFile->isModified});
+                }
+            }
+
+            IO::NodeWriter writer(world, std::move(serializer));
             writer.setExporting(exporting);
             writer.writeMap();
+
+            file.flush();
+            return file.hash();
         }
 
-        void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path) const {
-            doWriteMap(world, path, false);
+        IO::TextHash GameImpl::doWriteMap(WorldNode& world, const IO::Path& path, const IO::PreviousMapFile* previousFile) const {
+            return doWriteMap(world, path, false, previousFile);
         }
 
         void GameImpl::doExportMap(WorldNode& world, const Model::ExportFormat format, const IO::Path& path) const {
@@ -210,7 +253,7 @@ namespace TrenchBroom {
                     break;
                 }
                 case Model::ExportFormat::Map:
-                    doWriteMap(world, path, true);
+                    doWriteMap(world, path, true, nullptr);
                     break;
             }
         }
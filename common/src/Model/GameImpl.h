@@ -65,8 +65,8 @@ namespace TrenchBroom {
 
             std::unique_ptr<WorldNode> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const override;
             std::unique_ptr<WorldNode> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const override;
-            void doWriteMap(WorldNode& world, const IO::Path& path, bool exporting) const;
-            void doWriteMap(WorldNode& world, const IO::Path& path) const override;
+            IO::TextHash doWriteMap(WorldNode& world, const IO::Path& path, bool exporting, const IO::PreviousMapFile* previousFile) const;
+            IO::TextHash doWriteMap(WorldNode& world, const IO::Path& path, const IO::PreviousMapFile* previousFile) const override;
             void doExportMap(WorldNode& world, Model::ExportFormat format, const IO::Path& path) const override;
 
             std::vector<Node*> doParseNodes(const std::string& str, WorldNode& world, const vm::bbox3& worldBounds, Logger& logger) const override;
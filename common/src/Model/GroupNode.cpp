@@ -51,6 +51,14 @@ namespace TrenchBroom {
             setEntity(std::move(entity));
         }
 
+        const std::optional<IdType>& GroupNode::persistentId() const {
+            return m_persistentId;
+        }
+
+        void GroupNode::setPersistentId(const IdType persistentId) const {
+            m_persistentId = persistentId;
+        }
+
         bool GroupNode::opened() const {
             return m_editState == Edit_Open;
         }
@@ -22,12 +22,14 @@
 #include "FloatType.h"
 #include "Macros.h"
 #include "Model/AttributableNode.h"
+#include "Model/IdType.h"
 #include "Model/Object.h"
 
 #include <kdl/result_forward.h>
 
 #include <vecmath/bbox.h>
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -45,11 +47,19 @@ namespace TrenchBroom {
             mutable vm::bbox3 m_logicalBounds;
             mutable vm::bbox3 m_physicalBounds;
             mutable bool m_boundsValid;
+            mutable std::optional<IdType> m_persistentId;
         public:
             GroupNode(const std::string& name);
 
             void setName(const std::string& name);
 
+            /**
+             * Returns the ID that was written to a map file for this group, if any. Like the file position, the ID
+             * is set by the serializer, and it is kept so that the group retains its ID when the map is saved again.
+             */
+            const std::optional<IdType>& persistentId() const;
+            void setPersistentId(IdType persistentId) const;
+
             bool opened() const;
             bool hasOpenedDescendant() const;
             bool closed() const;
@@ -89,11 +89,15 @@ namespace TrenchBroom {
         }
 
         Issue::Issue(Node* node) :
-        m_seqId(nextSeqId()),
+        m_seqId(0u),
         m_node(node) {
             ensure(m_node != nullptr, "node is null");
         }
 
+        void Issue::assignSeqId() {
+            m_seqId = nextSeqId();
+        }
+
         size_t Issue::nextSeqId() {
             static size_t seqId = 0;
             return seqId++;
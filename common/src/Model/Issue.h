@@ -52,8 +52,17 @@ namespace TrenchBroom {
             void setHidden(bool hidden);
         protected:
             explicit Issue(Node* node);
-            static size_t nextSeqId();
             static IssueType freeType();
+        private:
+            friend class Node;
+
+            /**
+             * Assigns the next sequence ID to this issue. This is done when the issue is added to its node rather than
+             * when it is created, so that the sequence IDs don't depend on the order in which concurrently generated
+             * issues were created.
+             */
+            void assignSeqId();
+            static size_t nextSeqId();
         private: // subclassing interface
             virtual size_t doGetLineNumber() const;
             virtual IssueType doGetType() const = 0;
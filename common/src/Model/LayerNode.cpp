@@ -124,6 +124,14 @@ namespace TrenchBroom {
             });
         }
 
+        const std::optional<IdType>& LayerNode::persistentId() const {
+            return m_persistentId;
+        }
+
+        void LayerNode::setPersistentId(const IdType persistentId) const {
+            m_persistentId = persistentId;
+        }
+
         const std::string& LayerNode::doGetName() const {
             static const auto NoName = std::string("");
             const auto* value = entity().attribute(AttributeNames::LayerName);
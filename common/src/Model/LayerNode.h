@@ -23,6 +23,7 @@
 #include "FloatType.h"
 #include "Macros.h"
 #include "Model/AttributableNode.h"
+#include "Model/IdType.h"
 
 #include <vecmath/bbox.h>
 
@@ -37,6 +38,7 @@ namespace TrenchBroom {
             mutable vm::bbox3 m_logicalBounds;
             mutable vm::bbox3 m_physicalBounds;
             mutable bool m_boundsValid;
+            mutable std::optional<IdType> m_persistentId;
         public:
             LayerNode(const std::string& name);
 
@@ -60,6 +62,13 @@ namespace TrenchBroom {
 
             bool omitFromExport() const;
             void setOmitFromExport(bool omitFromExport);
+
+            /**
+             * Returns the ID that was written to a map file for this layer, if any. Like the file position, the ID
+             * is set by the serializer, and it is kept so that the layer retains its ID when the map is saved again.
+             */
+            const std::optional<IdType>& persistentId() const;
+            void setPersistentId(IdType persistentId) const;
         private: // implement Node interface
             const std::string& doGetName() const override;
             const vm::bbox3& doGetLogicalBounds() const override;
@@ -74,44 +74,34 @@ namespace TrenchBroom {
         kdl::result<BrushFace, BrushError> ModelFactoryImpl::doCreateFace(const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const BrushFaceAttributes& attribs) const {
             assert(m_format != MapFormat::Unknown);
             return Model::isParallelTexCoordSystem(m_format)
-                   ? BrushFace::create(point1, point2, point3, attribs, std::make_unique<ParallelTexCoordSystem>(point1, point2, point3, attribs))
-                   : BrushFace::create(point1, point2, point3, attribs, std::make_unique<ParaxialTexCoordSystem>(point1, point2, point3, attribs));
+                   ? BrushFace::create(point1, point2, point3, attribs, ParallelTexCoordSystem(point1, point2, point3, attribs))
+                   : BrushFace::create(point1, point2, point3, attribs, ParaxialTexCoordSystem(point1, point2, point3, attribs));
         }
 
         kdl::result<BrushFace, BrushError> ModelFactoryImpl::doCreateFaceFromStandard(const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const BrushFaceAttributes& inputAttribs) const {
             assert(m_format != MapFormat::Unknown);
 
-            std::unique_ptr<TexCoordSystem> texCoordSystem;
-            BrushFaceAttributes attribs("");
-
             if (Model::isParallelTexCoordSystem(m_format)) {
                 // Convert paraxial to parallel
-                std::tie(texCoordSystem, attribs) = ParallelTexCoordSystem::fromParaxial(point1, point2, point3, inputAttribs);
+                auto [texCoordSystem, attribs] = ParallelTexCoordSystem::fromParaxial(point1, point2, point3, inputAttribs);
+                return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
             } else {
                 // Pass through paraxial
-                texCoordSystem = std::make_unique<ParaxialTexCoordSystem>(point1, point2, point3, inputAttribs);
-                attribs = inputAttribs;
+                return BrushFace::create(point1, point2, point3, inputAttribs, ParaxialTexCoordSystem(point1, point2, point3, inputAttribs));
             }
-
-            return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
         }
 
         kdl::result<BrushFace, BrushError> ModelFactoryImpl::doCreateFaceFromValve(const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const BrushFaceAttributes& inputAttribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY) const {
             assert(m_format != MapFormat::Unknown);
 
-            std::unique_ptr<TexCoordSystem> texCoordSystem;
-            BrushFaceAttributes attribs("");
-
             if (Model::isParallelTexCoordSystem(m_format)) {
                 // Pass through parallel
-                texCoordSystem = std::make_unique<ParallelTexCoordSystem>(texAxisX, texAxisY);
-                attribs = inputAttribs;
+                return BrushFace::create(point1, point2, point3, inputAttribs, ParallelTexCoordSystem(texAxisX, texAxisY));
             } else {
                 // Convert parallel to paraxial
-                std::tie(texCoordSystem, attribs) = ParaxialTexCoordSystem::fromParallel(point1, point2, point3, inputAttribs, texAxisX, texAxisY);
+                auto [texCoordSystem, attribs] = ParaxialTexCoordSystem::fromParallel(point1, point2, point3, inputAttribs, texAxisX, texAxisY);
+                return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
             }
-
-            return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
         }
     }
 }
@@ -32,8 +32,11 @@
 #include "Model/WorldNode.h"
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/vector_set.h>
 #include <kdl/vector_utils.h>
 
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -159,65 +162,122 @@ namespace TrenchBroom {
         }
 
         /**
-         * Recursively collect brushes and entities from the given vector of node trees such that
-         * the returned nodes match the given predicate. A matching brush is only returned if it
-         * isn't in the given vector brushes. A node matches the given predicate if there is a brush
-         * in the given vector of brushes such that the predicate evaluates to true for that pair of
-         * node and brush.
+         * Indicates whether any group containing the given node is not opened. Such a group is matched as a whole
+         * instead of the given node.
+         */
+        static bool isInUnopenedGroup(Node* node) {
+            return node->visitParent(kdl::overload(
+                [](WorldNode*)                            { return false; },
+                [](LayerNode*)                            { return false; },
+                [](auto&& thisLambda, GroupNode* group)   { return !group->opened() || group->visitParent(thisLambda).value_or(false); },
+                [](auto&& thisLambda, EntityNode* entity) { return entity->visitParent(thisLambda).value_or(false); },
+                [](auto&& thisLambda, BrushNode* brush)   { return brush->visitParent(thisLambda).value_or(false); }
+            )).value_or(false);
+        }
+
+        /**
+         * Collects the brushes, entities and unopened groups of the given world that match the given predicate. A
+         * matching brush is only returned if it isn't in the given vector brushes. A node matches the given predicate
+         * if there is a brush in the given vector of brushes such that the predicate evaluates to true for that pair
+         * of node and brush. Entities that contain brushes are not matched themselves, and groups that are not opened
+         * are only matched as a whole.
+         *
+         * The candidate nodes for each brush are found by querying the node tree of the world with the bounds of
+         * the brush, so the given predicate must only evaluate to true if the bounds of the node and of the brush
+         * intersect. Since the node tree does not contain groups, unopened groups are found by traversing the world
+         * and are tested against every brush.
+         *
+         * The predicate is evaluated in parallel for all candidate nodes other than groups.
          *
          * The given predicate must be a function that maps a node and a brush to true or false.
          */
         template <typename P>
-        static std::vector<Node*> collectMatchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes, const P& predicate) {
-            auto result = std::vector<Model::Node*>{};
+        static std::vector<Node*> collectMatchingNodes(WorldNode& world, const std::vector<BrushNode*>& brushes, const P& predicate) {
+            const auto brushBounds = kdl::vec_transform(brushes, [](const auto* brush) { return brush->logicalBounds(); });
+            const auto intersectors = world.findNodesIntersecting(brushBounds);
+            const auto queryBrushes = kdl::vector_set<const Node*>(std::begin(brushes), std::end(brushes));
+
+            // collect every candidate once, together with the brushes whose bounds it intersects
+            auto candidates = std::vector<Node*>{};
+            auto candidateBrushes = std::vector<std::vector<const BrushNode*>>{};
+            auto candidateIndices = std::unordered_map<const Node*, size_t>{};
+            for (size_t i = 0u; i < brushes.size(); ++i) {
+                for (auto* node : intersectors[i]) {
+                    // if `node` is one of the search query nodes, don't count it as touching
+                    if (queryBrushes.count(node) > 0u || isInUnopenedGroup(node)) {
+                        continue;
+                    }
 
-            const auto collectIfMatching = [&](auto* node) {
-                for (const auto* brush : brushes) {
-                    if (predicate(node, brush)) {
-                        result.push_back(node);
+                    const auto isCandidate = node->accept(kdl::overload(
+                        [](WorldNode*)         { return false; },
+                        [](LayerNode*)         { return false; },
+                        [](GroupNode*)         { return false; },
+                        [](EntityNode* entity) {
+                            // computes and caches the bounds of the entity before they are accessed in parallel
+                            entity->logicalBounds();
+                            return !entity->hasChildren();
+                        },
+                        [](BrushNode*)         { return true; }
+                    ));
+
+                    if (isCandidate) {
+                        const auto [it, inserted] = candidateIndices.emplace(node, candidates.size());
+                        if (inserted) {
+                            candidates.push_back(node);
+                            candidateBrushes.emplace_back();
+                        }
+                        candidateBrushes[it->second].push_back(brushes[i]);
+                    }
+                }
+            }
+
+            auto matches = std::vector<char>(candidates.size(), 0);
+            kdl::parallel_for(0u, candidates.size(), [&](const size_t i) {
+                for (const auto* brush : candidateBrushes[i]) {
+                    if (predicate(candidates[i], brush)) {
+                        matches[i] = 1;
                         return;
                     }
                 }
-            };
+            });
 
-            for (auto* node : nodes) {
-                node->accept(kdl::overload(
-                    [] (auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
-                    [] (auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::GroupNode* group) { 
-                        if (group->opened()) {
-                            group->visitChildren(thisLambda);
-                        } else {
-                            collectIfMatching(group);
-                        }
-                    },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { 
-                        if (entity->hasChildren()) {
-                            entity->visitChildren(thisLambda);
-                        } else {
-                            collectIfMatching(entity);
-                        }
-                    },
-                    [&](Model::BrushNode* brush)  { 
-                        // if `brush` is one of the search query nodes, don't count it as touching
-                        if (!kdl::vec_contains(brushes, brush)) {
-                            collectIfMatching(brush);
+            auto result = std::vector<Node*>{};
+            for (size_t i = 0u; i < candidates.size(); ++i) {
+                if (matches[i]) {
+                    result.push_back(candidates[i]);
+                }
+            }
+
+            world.accept(kdl::overload(
+                [] (auto&& thisLambda, WorldNode* w) { w->visitChildren(thisLambda); },
+                [] (auto&& thisLambda, LayerNode* l) { l->visitChildren(thisLambda); },
+                [&](auto&& thisLambda, GroupNode* group) {
+                    if (group->opened()) {
+                        group->visitChildren(thisLambda);
+                    } else {
+                        for (const auto* brush : brushes) {
+                            if (predicate(group, brush)) {
+                                result.push_back(group);
+                                return;
+                            }
                         }
                     }
-                ));
-            }
+                },
+                [] (EntityNode*) {},
+                [] (BrushNode*) {}
+            ));
 
             return result;
         }
 
-        std::vector<Node*> collectTouchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes) {
-            return collectMatchingNodes(nodes, brushes, [](const auto* node, const auto* brush) {
+        std::vector<Node*> collectTouchingNodes(WorldNode& world, const std::vector<BrushNode*>& brushes) {
+            return collectMatchingNodes(world, brushes, [](const auto* node, const auto* brush) {
                 return brush->intersects(node);
             });
         }
 
-        std::vector<Node*> collectContainedNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes) {
-            return collectMatchingNodes(nodes, brushes, [](const auto* node, const auto* brush) {
+        std::vector<Node*> collectContainedNodes(WorldNode& world, const std::vector<BrushNode*>& brushes) {
+            return collectMatchingNodes(world, brushes, [](const auto* node, const auto* brush) {
                 return brush->contains(node);
             });
         }
@@ -368,5 +428,32 @@ namespace TrenchBroom {
                  }
             ));
         }
+
+        void validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators) {
+            const auto invalidNodes = kdl::vec_filter(nodes, [](const Node* node) { return !node->issuesValid(); });
+            auto issues = std::vector<std::vector<Issue*>>(invalidNodes.size());
+
+            auto brushIndices = std::vector<size_t>{};
+            for (size_t i = 0u; i < invalidNodes.size(); ++i) {
+                invalidNodes[i]->accept(kdl::overload(
+                    [&](WorldNode* world)   { issues[i] = world->generateIssues(issueGenerators); },
+                    [&](LayerNode* layer)   { issues[i] = layer->generateIssues(issueGenerators); },
+                    [&](GroupNode* group)   { issues[i] = group->generateIssues(issueGenerators); },
+                    [&](EntityNode* entity) { issues[i] = entity->generateIssues(issueGenerators); },
+                    [&](BrushNode*)         { brushIndices.push_back(i); }
+                ));
+            }
+
+            kdl::parallel_for(0u, brushIndices.size(), [&](const size_t j) {
+                const auto i = brushIndices[j];
+                issues[i] = invalidNodes[i]->generateIssues(issueGenerators);
+            });
+
+            // the issues are added in the order of the given nodes so that their sequence IDs don't depend on the
+            // order in which the brush issues were generated
+            for (size_t i = 0u; i < invalidNodes.size(); ++i) {
+                invalidNodes[i]->setIssues(std::move(issues[i]));
+            }
+        }
     }
 }
@@ -31,6 +31,7 @@ namespace TrenchBroom {
     namespace Model {
         class BrushFaceHandle;
         class EditorContext;
+        class IssueGenerator;
         class LayerNode;
         class Node;
 
@@ -55,8 +56,8 @@ namespace TrenchBroom {
 
         std::vector<Node*> collectNodes(const std::vector<Node*>& nodes);
 
-        std::vector<Node*> collectTouchingNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
-        std::vector<Node*> collectContainedNodes(const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
+        std::vector<Node*> collectTouchingNodes(WorldNode& world, const std::vector<BrushNode*>& brushes);
+        std::vector<Node*> collectContainedNodes(WorldNode& world, const std::vector<BrushNode*>& brushes);
 
         std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes);
 
@@ -71,6 +72,17 @@ namespace TrenchBroom {
         bool boundsContainNode(const vm::bbox3& bounds, const Node* node);
         bool boundsIntersectNode(const vm::bbox3& bounds, const Node* node);
 
+        /**
+         * Generates the issues of those of the given nodes whose issues were invalidated, and leaves the issues of
+         * all other nodes untouched.
+         *
+         * The issues of brush nodes are generated in parallel because the issue generators only read the given brush
+         * and immutable state such as the world bounds. The issues of all other nodes are generated on the calling
+         * thread since generating them may fill lazily computed caches such as entity bounds. The generated issues
+         * are added to their nodes in the order of the given nodes, so their sequence IDs follow that order.
+         */
+        void validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators);
+
     }
 }
 
@@ -592,6 +592,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t Node::lineCount() const {
+            return m_lineCount;
+        }
+
         void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) const {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -606,6 +610,10 @@ namespace TrenchBroom {
             return m_issues;
         }
 
+        bool Node::issuesValid() const {
+            return m_issuesValid;
+        }
+
         bool Node::issueHidden(const IssueType type) const {
             return (type & m_hiddenIssues) != 0;
         }
@@ -618,12 +626,26 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<Issue*> Node::generateIssues(const std::vector<IssueGenerator*>& issueGenerators) {
+            auto issues = std::vector<Issue*>{};
+            for (const auto* generator : issueGenerators) {
+                doGenerateIssues(generator, issues);
+            }
+            return issues;
+        }
+
+        void Node::setIssues(std::vector<Issue*> issues) {
+            clearIssues();
+            m_issues = std::move(issues);
+            for (auto* issue : m_issues) {
+                issue->assignSeqId();
+            }
+            m_issuesValid = true;
+        }
+
         void Node::validateIssues(const std::vector<IssueGenerator*>& issueGenerators) {
             if (!m_issuesValid) {
-                for (const auto* generator : issueGenerators) {
-                    doGenerateIssues(generator, m_issues);
-                }
-                m_issuesValid = true;
+                setIssues(generateIssues(issueGenerators));
             }
         }
 
@@ -292,10 +292,24 @@ namespace TrenchBroom {
             void findNodesContaining(const vm::vec3& point, std::vector<Node*>& result);
         public: // file position
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount) const;
             bool containsLine(size_t lineNumber) const;
         public: // issue management
             const std::vector<Issue*>& issues(const std::vector<IssueGenerator*>& issueGenerators);
+            bool issuesValid() const;
+
+            /**
+             * Generates the issues of this node without adding them to this node. This only reads this node, so it can
+             * be called for several nodes concurrently.
+             */
+            std::vector<Issue*> generateIssues(const std::vector<IssueGenerator*>& issueGenerators);
+
+            /**
+             * Replaces the issues of this node with the given issues, which must have been generated by generateIssues,
+             * and assigns sequence IDs to them in the given order.
+             */
+            void setIssues(std::vector<Issue*> issues);
 
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
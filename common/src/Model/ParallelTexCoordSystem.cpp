@@ -73,9 +73,9 @@ namespace TrenchBroom {
         m_xAxis(xAxis),
         m_yAxis(yAxis) {}
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoordSystem::fromParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) {
+        std::tuple<ParallelTexCoordSystem, BrushFaceAttributes> ParallelTexCoordSystem::fromParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) {
             const auto tempParaxial = ParaxialTexCoordSystem(point0, point1, point2, attribs);
-            return { ParallelTexCoordSystem(tempParaxial.xAxis(), tempParaxial.yAxis()).clone(), attribs };
+            return { ParallelTexCoordSystem(tempParaxial.xAxis(), tempParaxial.yAxis()), attribs };
         }
 
         std::unique_ptr<TexCoordSystem> ParallelTexCoordSystem::doClone() const {
@@ -126,7 +126,7 @@ namespace TrenchBroom {
         }
 
         vm::vec2f ParallelTexCoordSystem::doGetTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const {
-            return (computeTexCoords(point, attribs.scale()) + attribs.offset()) / textureSize;
+            return computeTexCoords(point, attribs, textureSize);
         }
 
         /**
@@ -343,7 +343,8 @@ namespace TrenchBroom {
         }
 
         std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoordSystem::doToParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
-            return ParaxialTexCoordSystem::fromParallel(point0, point1, point2, attribs, m_xAxis, m_yAxis);
+            const auto [paraxial, newAttribs] = ParaxialTexCoordSystem::fromParallel(point0, point1, point2, attribs, m_xAxis, m_yAxis);
+            return { paraxial.clone(), newAttribs };
         }
     }
 }
@@ -129,7 +129,7 @@ namespace TrenchBroom {
         }
 
         vm::vec2f ParaxialTexCoordSystem::doGetTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const {
-            return (computeTexCoords(point, attribs.scale()) + attribs.offset()) / textureSize;
+            return computeTexCoords(point, attribs, textureSize);
         }
 
         void ParaxialTexCoordSystem::doSetRotation(const vm::vec3& normal, const float /* oldAngle */, const float newAngle) {
@@ -264,7 +264,8 @@ namespace TrenchBroom {
         }
 
         std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::doToParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
-            return ParallelTexCoordSystem::fromParaxial(point0, point1, point2, attribs);
+            const auto [parallel, newAttribs] = ParallelTexCoordSystem::fromParaxial(point0, point1, point2, attribs);
+            return { parallel.clone(), newAttribs };
         }
 
         std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::doToParaxial(const vm::vec3&, const vm::vec3&, const vm::vec3&, const BrushFaceAttributes& attribs) const {
@@ -610,7 +611,7 @@ namespace TrenchBroom {
             }
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::fromParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, const vm::vec3& xAxis, const vm::vec3& yAxis) {
+        std::tuple<ParaxialTexCoordSystem, BrushFaceAttributes> ParaxialTexCoordSystem::fromParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, const vm::vec3& xAxis, const vm::vec3& yAxis) {
             const vm::plane3 facePlane = planeFromPoints(point0, point1, point2);
             const vm::mat4x4f worldToTexSpace = FromParallel::valveTo4x4Matrix(facePlane, attribs, xAxis, yAxis);
             const auto facePoints = std::array<vm::vec3f, 3>{vm::vec3f(point0), vm::vec3f(point1), vm::vec3f(point2)};
@@ -628,7 +629,7 @@ namespace TrenchBroom {
                 newAttribs.setRotation(0.0f);
             }
 
-            return { std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, newAttribs),
+            return { ParaxialTexCoordSystem(point0, point1, point2, newAttribs),
                      newAttribs };
         }
     }
@@ -77,9 +77,9 @@ namespace TrenchBroom {
         private:
             void rotateAxes(vm::vec3& xAxis, vm::vec3& yAxis, FloatType angleInRadians, size_t planeNormIndex) const;
         public:
-            static std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> fromParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, const vm::vec3& xAxis, const vm::vec3& yAxis);
+            static std::tuple<ParaxialTexCoordSystem, BrushFaceAttributes> fromParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, const vm::vec3& xAxis, const vm::vec3& yAxis);
         private:
-            deleteCopyAndMove(ParaxialTexCoordSystem)
+            defineCopyAndMove(ParaxialTexCoordSystem)
         };
     }
 }
@@ -1105,6 +1105,21 @@ namespace TrenchBroom {
              */
             explicit Polyhedron(std::vector<vm::vec<T,3>> positions);
 
+            /**
+             * Constructs a polyhedron with the given topology without computing a convex hull. The boundary of the
+             * i-th face is given by the indices of its vertices in counter clockwise order in faces[i], and its plane
+             * is given by planes[i].
+             *
+             * The given topology must describe a closed polyhedron, that is, every edge must be shared by exactly two
+             * faces which traverse it in opposite directions, and every vertex must belong to a face. The caller is
+             * responsible for checking this.
+             *
+             * @param positions the vertex positions
+             * @param faces the vertex indices of the face boundaries
+             * @param planes the face planes
+             */
+            Polyhedron(const std::vector<vm::vec<T,3>>& positions, const std::vector<std::vector<size_t>>& faces, const std::vector<vm::plane<T,3>>& planes);
+
             /**
              * Copy constructor.
              */
@@ -1406,6 +1421,16 @@ namespace TrenchBroom {
              * @return a face or null if no face satisfies the criteria listed above
              */
             Face* findClosestFace(const std::vector<vm::vec<T,3>>& positions, T maxDistance = std::numeric_limits<T>::max());
+
+            /**
+             * Translates this polyhedron by moving its vertices and face planes by the given offset. A translation does
+             * not change the topology of this polyhedron, so this is much cheaper than building a translated copy.
+             *
+             * Updates the bounds of this polyhedron afterwards.
+             *
+             * @param delta the offset by which to translate this polyhedron
+             */
+            void translate(const vm::vec<T,3>& delta);
         private:
             /**
              * Updates the bounds to the smallest bounding box that contains the positions of all vertices of this
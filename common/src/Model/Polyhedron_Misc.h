@@ -31,6 +31,7 @@
 #include <vecmath/scalar.h>
 #include <vecmath/util.h>
 
+#include <map>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -194,6 +195,44 @@ namespace TrenchBroom {
             addPoints(std::move(positions));
         }
 
+        template <typename T, typename FP, typename VP>
+        Polyhedron<T,FP,VP>::Polyhedron(const std::vector<vm::vec<T,3>>& positions, const std::vector<std::vector<size_t>>& faces, const std::vector<vm::plane<T,3>>& planes) {
+            assert(faces.size() == planes.size());
+
+            std::vector<Vertex*> vertices;
+            vertices.reserve(positions.size());
+            for (const auto& position : positions) {
+                Vertex* vertex = new Vertex(position);
+                vertices.push_back(vertex);
+                m_vertices.push_back(vertex);
+            }
+
+            // maps each directed edge (origin, destination) to the half edge that runs along it
+            std::map<std::pair<size_t, size_t>, HalfEdge*> halfEdges;
+            for (size_t i = 0u; i < faces.size(); ++i) {
+                const auto& indices = faces[i];
+                assert(indices.size() >= 3u);
+
+                HalfEdgeList boundary;
+                for (size_t j = 0u; j < indices.size(); ++j) {
+                    HalfEdge* halfEdge = new HalfEdge(vertices[indices[j]]);
+                    boundary.push_back(halfEdge);
+                    halfEdges[std::make_pair(indices[j], indices[(j + 1u) % indices.size()])] = halfEdge;
+                }
+                m_faces.push_back(new Face(std::move(boundary), planes[i]));
+            }
+
+            for (const auto& [vertexIndices, halfEdge] : halfEdges) {
+                const auto& [origin, destination] = vertexIndices;
+                if (origin < destination) {
+                    HalfEdge* twin = halfEdges.at(std::make_pair(destination, origin));
+                    m_edges.push_back(new Edge(halfEdge, twin));
+                }
+            }
+
+            updateBounds();
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron<T,FP,VP>::Polyhedron(const Polyhedron<T,FP,VP>& other) {
             Copy copy(other.faces(), other.edges(), other.vertices(), *this, CopyCallback());
@@ -661,6 +700,18 @@ namespace TrenchBroom {
             return closestFace;
         }
 
+        template <typename T, typename FP, typename VP>
+        void Polyhedron<T,FP,VP>::translate(const vm::vec<T,3>& delta) {
+            for (auto* vertex : m_vertices) {
+                vertex->setPosition(vertex->position() + delta);
+            }
+            for (auto* face : m_faces) {
+                const auto& plane = face->plane();
+                face->setPlane(vm::plane<T,3>(plane.anchor() + delta, plane.normal));
+            }
+            updateBounds();
+        }
+
         template <typename T, typename FP, typename VP>
         void Polyhedron<T,FP,VP>::updateBounds() {
             auto builder = typename vm::bbox<T,3>::builder();
@@ -86,6 +86,10 @@ namespace TrenchBroom {
             return doGetTexCoords(point, attribs, textureSize);
         }
 
+        void TexCoordSystem::getTexCoords(const size_t count, const FloatType* xs, const FloatType* ys, const FloatType* zs, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize, float* us, float* vs) const {
+            computeTexCoords(count, xs, ys, zs, attribs, textureSize, us, vs);
+        }
+
         void TexCoordSystem::setRotation(const vm::vec3& normal, const float oldAngle, const float newAngle) {
             doSetRotation(normal, oldAngle, newAngle);
         }
@@ -226,6 +230,30 @@ namespace TrenchBroom {
                          dot(point, safeScaleAxis(getYAxis(), scale.y())));
         }
 
+        vm::vec2f TexCoordSystem::computeTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const {
+            float u, v;
+            computeTexCoords(1u, &point[0], &point[1], &point[2], attribs, textureSize, &u, &v);
+            return vm::vec2f(u, v);
+        }
+
+        void TexCoordSystem::computeTexCoords(const size_t count, const FloatType* xs, const FloatType* ys, const FloatType* zs, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize, float* us, float* vs) const {
+            const auto xAxis = safeScaleAxis(getXAxis(), attribs.scale().x());
+            const auto yAxis = safeScaleAxis(getYAxis(), attribs.scale().y());
+            const auto offset = attribs.offset();
+
+            const auto xx = xAxis.x(), xy = xAxis.y(), xz = xAxis.z();
+            const auto ox = offset.x(), sx = textureSize.x();
+            for (size_t i = 0u; i < count; ++i) {
+                us[i] = (static_cast<float>(xs[i] * xx + ys[i] * xy + zs[i] * xz) + ox) / sx;
+            }
+
+            const auto yx = yAxis.x(), yy = yAxis.y(), yz = yAxis.z();
+            const auto oy = offset.y(), sy = textureSize.y();
+            for (size_t i = 0u; i < count; ++i) {
+                vs[i] = (static_cast<float>(xs[i] * yx + ys[i] * yy + zs[i] * yz) + oy) / sy;
+            }
+        }
+
         std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> TexCoordSystem::toParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
             return doToParallel(point0, point1, point2, attribs);
         }
@@ -20,7 +20,6 @@
 #pragma once
 
 #include "FloatType.h"
-#include "Macros.h"
 
 #include "Model/BrushFaceAttributes.h"
 
@@ -75,6 +74,14 @@ namespace TrenchBroom {
 
             vm::vec2f getTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const;
 
+            /**
+             * Computes the texture coordinates of the given number of points, whose components are given in separate
+             * arrays, and stores their components in the given arrays. The result is the same as calling getTexCoords
+             * for every point, but the texture axes are computed only once, and the loop over the points can be
+             * vectorized by the compiler.
+             */
+            void getTexCoords(size_t count, const FloatType* xs, const FloatType* ys, const FloatType* zs, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize, float* us, float* vs) const;
+
             void setRotation(const vm::vec3& normal, float oldAngle, float newAngle);
             void transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant);
             void updateNormal(const vm::vec3& oldNormal, const vm::vec3& newNormal, const BrushFaceAttributes& attribs, const WrapStyle style);
@@ -121,6 +128,14 @@ namespace TrenchBroom {
         protected:
             vm::vec2f computeTexCoords(const vm::vec3& point, const vm::vec2f& scale) const;
 
+            /**
+             * Computes the scaled and offset texture coordinates of the given point. All coordinate systems compute
+             * their texture coordinates like this, and both getTexCoords overloads use the same computation so that
+             * their results are identical.
+             */
+            vm::vec2f computeTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const;
+            void computeTexCoords(size_t count, const FloatType* xs, const FloatType* ys, const FloatType* zs, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize, float* us, float* vs) const;
+
             template <typename T>
             T safeScale(const T value) const {
                 return vm::is_equal(value, T(0.0), vm::constants<T>::almost_zero()) ? static_cast<T>(1.0) : value;
@@ -131,7 +146,11 @@ namespace TrenchBroom {
                 return axis / safeScale(T1(factor));
             }
 
-            deleteCopyAndMove(TexCoordSystem)
+            // copying and moving is only possible for the concrete subclasses to prevent slicing
+            TexCoordSystem(const TexCoordSystem& other) = default;
+            TexCoordSystem(TexCoordSystem&& other) noexcept = default;
+            TexCoordSystem& operator=(const TexCoordSystem& other) = default;
+            TexCoordSystem& operator=(TexCoordSystem&& other) = default;
         };
     }
 }
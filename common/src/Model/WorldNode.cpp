@@ -33,6 +33,7 @@
 #include "Model/TagVisitor.h"
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/vector_utils.h>
 
@@ -50,7 +51,8 @@ namespace TrenchBroom {
         m_attributableIndex(std::make_unique<AttributableNodeIndex>()),
         m_issueGeneratorRegistry(std::make_unique<IssueGeneratorRegistry>()),
         m_nodeTree(std::make_unique<NodeTree>()),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_nodeTreeQueryCount(0u) {
             entity.addOrUpdateAttribute(AttributeNames::Classname, AttributeValues::WorldspawnClassname);
             entity.setPointEntity(false);
             setEntity(std::move(entity));
@@ -159,7 +161,10 @@ namespace TrenchBroom {
         }
 
         void WorldNode::enableNodeTreeUpdates() {
-            m_updateNodeTree = true;
+            if (!m_updateNodeTree) {
+                m_updateNodeTree = true;
+                rebuildNodeTree();
+            }
         }
 
         void WorldNode::rebuildNodeTree() {
@@ -179,6 +184,33 @@ namespace TrenchBroom {
             ));
 
             m_nodeTree->clearAndBuild(nodes, [](const auto* node){ return node->physicalBounds(); });
+            nodeTreeDidChange();
+        }
+
+        std::vector<std::vector<Node*>> WorldNode::findNodesIntersecting(const std::vector<vm::bbox3>& boxes) {
+            willQueryNodeTree(boxes.size());
+
+            auto result = std::vector<std::vector<Node*>>(boxes.size());
+            kdl::parallel_for(0u, boxes.size(), [&](const size_t i) {
+                result[i] = m_nodeTree->findIntersectors(boxes[i]);
+            });
+            return result;
+        }
+
+        void WorldNode::willQueryNodeTree(const size_t queryCount) {
+            // Flattening the tree takes about as long as a few dozen queries, so it only pays off once the tree has
+            // stopped changing. While objects are being dragged around, every change is followed by just a few
+            // picks, and those are answered by the dynamic tree.
+            static const size_t FreezeQueryCount = 16u;
+
+            m_nodeTreeQueryCount += queryCount;
+            if (m_nodeTreeQueryCount >= FreezeQueryCount) {
+                m_nodeTree->freeze();
+            }
+        }
+
+        void WorldNode::nodeTreeDidChange() {
+            m_nodeTreeQueryCount = 0u;
         }
 
         void WorldNode::invalidateAllIssues() {
@@ -263,6 +295,7 @@ namespace TrenchBroom {
                     [&](auto&& thisLambda, EntityNode* entity) { m_nodeTree->insert(entity->physicalBounds(), entity); entity->visitChildren(thisLambda); },
                     [&](BrushNode* brush)                      { m_nodeTree->insert(brush->physicalBounds(), brush); }
                 ));
+                nodeTreeDidChange();
             }
         }
 
@@ -283,6 +316,7 @@ namespace TrenchBroom {
                     [&](auto&& thisLambda, EntityNode* entity) { doRemove(entity); entity->visitChildren(thisLambda); },
                     [&](BrushNode* brush)                      { doRemove(brush); }
                 ));
+                nodeTreeDidChange();
             }
         }
 
@@ -295,6 +329,7 @@ namespace TrenchBroom {
                     [&](EntityNode* entity) { m_nodeTree->update(entity->physicalBounds(), entity); },
                     [&](BrushNode* brush)   { m_nodeTree->update(brush->physicalBounds(), brush); }
                 ));
+                nodeTreeDidChange();
             }
         }
 
@@ -303,12 +338,14 @@ namespace TrenchBroom {
         }
 
         void WorldNode::doPick(const vm::ray3& ray, PickResult& pickResult) {
+            willQueryNodeTree(1u);
             for (auto* node : m_nodeTree->findIntersectors(ray)) {
                 node->pick(ray, pickResult);
             }
         }
 
         void WorldNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) {
+            willQueryNodeTree(1u);
             for (auto* node : m_nodeTree->findContainers(point)) {
                 node->findNodesContaining(point, result);
             }
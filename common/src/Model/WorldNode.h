@@ -53,6 +53,8 @@ namespace TrenchBroom {
             using NodeTree = AABBTree<FloatType, 3, Node*>;
             std::unique_ptr<NodeTree> m_nodeTree;
             bool m_updateNodeTree;
+            // the number of queries of the node tree since it was last modified
+            size_t m_nodeTreeQueryCount;
         public:
             WorldNode(Entity entity, MapFormat mapFormat);
             ~WorldNode() override;
@@ -112,8 +114,30 @@ namespace TrenchBroom {
             void unregisterAllIssueGenerators();
         public: // node tree bulk updating
             void disableNodeTreeUpdates();
+            /**
+             * Enables node tree updates. If they were disabled, the node tree is rebuilt from scratch.
+             */
             void enableNodeTreeUpdates();
+            /**
+             * Rebuilds the node tree from scratch using the bulk builder of the tree.
+             */
             void rebuildNodeTree();
+        public: // spatial queries
+            /**
+             * Finds the entities and brushes whose physical bounds intersect with each of the given boxes. The node
+             * tree is queried for all boxes in parallel.
+             *
+             * @param boxes the boxes to test
+             * @return a vector containing, for each of the given boxes, the nodes whose bounds intersect with it
+             */
+            std::vector<std::vector<Node*>> findNodesIntersecting(const std::vector<vm::bbox3>& boxes);
+        private:
+            /**
+             * Records that the given number of queries are about to be run on the node tree and freezes the tree once
+             * it has been queried often enough without being modified in between.
+             */
+            void willQueryNodeTree(size_t queryCount);
+            void nodeTreeDidChange();
         private:
             void invalidateAllIssues();
         private: // implement Node interface
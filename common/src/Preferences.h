@@ -127,6 +127,8 @@ namespace TrenchBroom {
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        extern Preference<bool> UseMapCache;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
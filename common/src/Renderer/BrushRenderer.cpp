@@ -33,6 +33,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
@@ -341,8 +342,35 @@ namespace TrenchBroom {
         void BrushRenderer::validate() {
             assert(!valid());
 
+            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
+
+            // evaluate the filter first, so that only the brushes which will be rendered are validated
+            std::vector<std::tuple<const Model::BrushNode*, Filter::EdgeRenderPolicy>> brushesToValidate;
+            std::vector<const Model::BrushNode*> brushesToRender;
+            brushesToValidate.reserve(m_invalidBrushes.size());
+            brushesToRender.reserve(m_invalidBrushes.size());
+
             for (auto brush : m_invalidBrushes) {
-                validateBrush(brush);
+                // evaluate filter. only evaluate the filter once per brush.
+                const auto settings = wrapper.markFaces(brush);
+                const auto [facePolicy, edgePolicy] = settings;
+
+                if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
+                    edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
+                    // NOTE: this skips inserting the brush into m_brushInfo
+                    continue;
+                }
+
+                brushesToValidate.emplace_back(brush, edgePolicy);
+                brushesToRender.push_back(brush);
+            }
+
+            // validate the vertex caches of all rendered brushes at once, so that their texture coordinates are
+            // computed in batches
+            BrushRendererBrushCache::validateVertexCaches(brushesToRender);
+
+            for (const auto& [brush, edgePolicy] : brushesToValidate) {
+                validateBrush(brush, edgePolicy);
             }
             m_invalidBrushes.clear();
             assert(valid());
@@ -438,23 +466,11 @@ namespace TrenchBroom {
             return false;
         }
 
-        void BrushRenderer::validateBrush(const Model::BrushNode* brush) {
+        void BrushRenderer::validateBrush(const Model::BrushNode* brush, const Filter::EdgeRenderPolicy edgePolicy) {
             assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
             assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
             assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
 
-            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
-
-            // evaluate filter. only evaluate the filter once per brush.
-            const auto settings = wrapper.markFaces(brush);
-            const auto [facePolicy, edgePolicy] = settings;
-
-            if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
-                edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
-                // NOTE: this skips inserting the brush into m_brushInfo
-                return;
-            }
-
             BrushInfo& info = m_brushInfo[brush];
 
             // collect vertices
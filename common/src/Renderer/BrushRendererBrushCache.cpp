@@ -19,12 +19,16 @@
 
 #include "BrushRendererBrushCache.h"
 
+#include "FloatType.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/Polyhedron.h"
 
+#include <vecmath/vec.h>
+
 #include <algorithm>
+#include <utility>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -54,22 +58,107 @@ namespace TrenchBroom {
             m_cachedFacesSortedByTexture.clear();
         }
 
+        /**
+         * The positions of the vertices of the faces of a batch of brushes, stored as separate arrays of their
+         * components so that their texture coordinates can be computed face by face in a tight loop.
+         */
+        struct BrushRendererBrushCache::VertexBatch {
+            std::vector<FloatType> xs;
+            std::vector<FloatType> ys;
+            std::vector<FloatType> zs;
+            std::vector<float> us;
+            std::vector<float> vs;
+
+            // the faces in the order in which their vertices were added, with the index of their first vertex
+            std::vector<std::pair<const Model::BrushFace*, size_t>> faces;
+
+            size_t vertexCount() const {
+                return xs.size();
+            }
+
+            void addVertex(const vm::vec3& position) {
+                xs.push_back(position.x());
+                ys.push_back(position.y());
+                zs.push_back(position.z());
+            }
+
+            void computeTexCoords() {
+                us.resize(vertexCount());
+                vs.resize(vertexCount());
+
+                for (const auto& [face, first] : faces) {
+                    face->textureCoords(face->vertexCount(), &xs[first], &ys[first], &zs[first], &us[first], &vs[first]);
+                }
+            }
+
+            void clear() {
+                xs.clear();
+                ys.clear();
+                zs.clear();
+                us.clear();
+                vs.clear();
+                faces.clear();
+            }
+        };
+
+        // The number of vertices after which the texture coordinates of a batch are computed.
+        static constexpr size_t MaxBatchVertexCount = 16384u;
+
         void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode* brushNode) {
             if (m_rendererCacheValid) {
                 return;
             }
 
-            // build vertex cache and face cache
-            const Model::Brush& brush = brushNode->brush();
+            assert(&brushNode->brushRendererBrushCache() == this);
+            validateVertexCaches({ brushNode });
+        }
 
-            m_cachedVertices.clear();
-            m_cachedVertices.reserve(brush.vertexCount());
+        void BrushRendererBrushCache::validateVertexCaches(const std::vector<const Model::BrushNode*>& brushNodes) {
+            VertexBatch batch;
+            std::vector<const Model::BrushNode*> batchBrushNodes;
+
+            const auto flushBatch = [&]() {
+                batch.computeTexCoords();
+
+                size_t firstVertex = 0u;
+                for (const auto* brushNode : batchBrushNodes) {
+                    firstVertex = brushNode->brushRendererBrushCache().cacheVertices(brushNode, batch, firstVertex);
+                }
+
+                batch.clear();
+                batchBrushNodes.clear();
+            };
+
+            for (const auto* brushNode : brushNodes) {
+                auto& cache = brushNode->brushRendererBrushCache();
+                if (!cache.m_rendererCacheValid) {
+                    cache.cacheFacesAndEdges(brushNode, batch);
+                    batchBrushNodes.push_back(brushNode);
+
+                    if (batch.vertexCount() >= MaxBatchVertexCount) {
+                        flushBatch();
+                    }
+                }
+            }
+
+            if (!batchBrushNodes.empty()) {
+                flushBatch();
+            }
+        }
+
+        void BrushRendererBrushCache::cacheFacesAndEdges(const Model::BrushNode* brushNode, VertexBatch& batch) {
+            // build face cache and collect the vertex positions
+            const Model::Brush& brush = brushNode->brush();
 
             m_cachedFacesSortedByTexture.clear();
             m_cachedFacesSortedByTexture.reserve(brush.faceCount());
 
+            size_t vertexIndexRelativeToBrush = 0u;
             for (const Model::BrushFace& face : brush.faces()) {
-                const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
+                batch.faces.emplace_back(&face, batch.vertexCount());
+
+                // face cache
+                m_cachedFacesSortedByTexture.emplace_back(&face, vertexIndexRelativeToBrush);
 
                 // The boundary is in CCW order, but the renderer expects CW order:
                 auto& boundary = face.geometry()->boundary();
@@ -81,17 +170,10 @@ namespace TrenchBroom {
                     // This is used below when building the edge cache.
                     // NOTE: we'll overwrite the payload as we visit the same vertex several times while visiting
                     // different faces, this is fine.
-                    const auto currentIndex = m_cachedVertices.size();
-                    vertex->setPayload(static_cast<GLuint>(currentIndex));
+                    vertex->setPayload(static_cast<GLuint>(vertexIndexRelativeToBrush++));
 
-                    const auto& position = vertex->position();
-                    m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face.boundary().normal), face.textureCoords(position));
-
-                    current = current->previous();
+                    batch.addVertex(vertex->position());
                 }
-
-                // face cache
-                m_cachedFacesSortedByTexture.emplace_back(&face, indexOfFirstVertexRelativeToBrush);
             }
 
             // Sort by texture so BrushRenderer can efficiently step through the BrushFaces
@@ -119,8 +201,26 @@ namespace TrenchBroom {
 
                 m_cachedEdges.emplace_back(&face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
             }
+        }
+
+        size_t BrushRendererBrushCache::cacheVertices(const Model::BrushNode* brushNode, const VertexBatch& batch, size_t firstVertex) {
+            // build vertex cache from the positions and texture coordinates in the batch, in the order in which
+            // cacheFacesAndEdges added them
+            const Model::Brush& brush = brushNode->brush();
+
+            m_cachedVertices.clear();
+            m_cachedVertices.reserve(brush.vertexCount());
+
+            for (const Model::BrushFace& face : brush.faces()) {
+                const auto normal = vm::vec3f(face.boundary().normal);
+                for (size_t i = 0u; i < face.vertexCount(); ++i, ++firstVertex) {
+                    const auto position = vm::vec3(batch.xs[firstVertex], batch.ys[firstVertex], batch.zs[firstVertex]);
+                    m_cachedVertices.emplace_back(vm::vec3f(position), normal, vm::vec2f(batch.us[firstVertex], batch.vs[firstVertex]));
+                }
+            }
 
             m_rendererCacheValid = true;
+            return firstVertex;
         }
 
         const std::vector<BrushRendererBrushCache::Vertex>& BrushRendererBrushCache::cachedVertices() const {
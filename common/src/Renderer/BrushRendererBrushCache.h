@@ -84,12 +84,24 @@ namespace TrenchBroom {
              */
             void validateVertexCache(const Model::BrushNode* brushNode);
 
+            /**
+             * Validates the vertex caches of the given brushes. The texture coordinates of the vertices of many faces
+             * are computed at once, which is faster than validating the caches one by one if many of them are
+             * invalid, e.g. after loading a map or changing a texture.
+             */
+            static void validateVertexCaches(const std::vector<const Model::BrushNode*>& brushNodes);
+
             /**
              * Returns all vertices for all faces of the brush.
              */
             const std::vector<Vertex>& cachedVertices() const;
             const std::vector<CachedFace>& cachedFacesSortedByTexture() const;
             const std::vector<CachedEdge>& cachedEdges() const;
+        private:
+            struct VertexBatch;
+
+            void cacheFacesAndEdges(const Model::BrushNode* brushNode, VertexBatch& batch);
+            size_t cacheVertices(const Model::BrushNode* brushNode, const VertexBatch& batch, size_t firstVertex);
         };
     }
 }
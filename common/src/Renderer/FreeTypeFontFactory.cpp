@@ -53,18 +53,19 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<TextureFont> FreeTypeFontFactory::doCreateFont(const FontDescriptor& fontDescriptor) {
-            auto [face, bufferedReader] = loadFont(fontDescriptor);
+            auto [face, file, bufferedReader] = loadFont(fontDescriptor);
             auto font = buildFont(face, fontDescriptor.minChar(), fontDescriptor.charCount());
             FT_Done_Face(face);
 
-            // NOTE: bufferedReader is returned from loadFont() just to keep the buffer from
-            // being deallocated until after we call FT_Done_Face
+            // NOTE: file and bufferedReader are returned from loadFont() just to keep the buffer from
+            // being deallocated or unmapped until after we call FT_Done_Face
+            unused(file);
             unused(bufferedReader);
 
             return font;
         }
 
-        std::pair<FT_Face, IO::BufferedReader> FreeTypeFontFactory::loadFont(const FontDescriptor& fontDescriptor) {
+        std::tuple<FT_Face, std::shared_ptr<IO::File>, IO::BufferedReader> FreeTypeFontFactory::loadFont(const FontDescriptor& fontDescriptor) {
             const auto fontPath = fontDescriptor.path().isAbsolute() ? fontDescriptor.path() : IO::SystemPaths::findResourceFile(fontDescriptor.path());
 
             auto file = IO::Disk::openFile(fontPath);
@@ -79,7 +80,7 @@ namespace TrenchBroom {
             const auto fontSize = static_cast<FT_UInt>(fontDescriptor.size());
             FT_Set_Pixel_Sizes(face, 0, fontSize);
 
-            return {face, std::move(reader)};
+            return {face, std::move(file), std::move(reader)};
         }
 
         std::unique_ptr<TextureFont> FreeTypeFontFactory::buildFont(FT_Face face, const unsigned char firstChar, const unsigned char charCount) {
@@ -20,19 +20,36 @@
 #include "Autosaver.h"
 
 #include "Exceptions.h"
+#include "Logger.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "Model/Brush.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/Game.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
+#include <kdl/overload.h>
 #include <kdl/string_compare.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
+#include <kdl/thread_pool.h>
+
+#include <vecmath/bbox.h>
+
+#include <QString>
 
 #include <algorithm> // for std::sort
 #include <cassert>
 #include <limits>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace View {
@@ -62,17 +79,27 @@ namespace TrenchBroom {
             return backupNo > 0u;
         }
 
-        Autosaver::Autosaver(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds saveInterval, const size_t maxBackups) :
+        Autosaver::Autosaver(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds saveInterval, const size_t maxBackups, const Mode mode) :
         m_document(document),
         m_saveInterval(saveInterval),
         m_maxBackups(maxBackups),
         m_lastSaveTime(Clock::now()),
-        m_lastModificationCount(kdl::mem_lock(m_document)->modificationCount()) {}
+        m_lastModificationCount(kdl::mem_lock(m_document)->modificationCount()),
+        m_mode(mode) {}
+
+        Autosaver::~Autosaver() {
+            if (m_pendingAutosave.valid()) {
+                m_pendingAutosave.wait();
+            }
+        }
 
         void Autosaver::triggerAutosave(Logger& logger) {
             if (kdl::mem_expired(m_document)) {
                 return;
             }
+            if (!collectPendingAutosave(logger, false)) {
+                return;
+            }
 
             const auto currentTime = Clock::now();
 
@@ -95,27 +122,23 @@ namespace TrenchBroom {
                 return;
             }
 
-            autosave(logger, document);
+            if (m_mode == Mode::Background) {
+                autosaveInBackground(document);
+            } else {
+                autosave(logger, document);
+            }
+        }
+
+        void Autosaver::waitForAutosave(Logger& logger) {
+            collectPendingAutosave(logger, true);
         }
 
         void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document) {
             const auto& mapPath = document->path();
             assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
 
-            const auto mapFilename = mapPath.lastComponent();
-            const auto mapBasename = mapFilename.deleteExtension();
-
             try {
-                auto fs = createBackupFileSystem(logger, mapPath);
-                auto backups = collectBackups(fs, mapBasename);
-
-                thinBackups(logger, fs, backups);
-                cleanBackups(fs, backups, mapBasename);
-
-                assert(backups.size() < m_maxBackups);
-                const auto backupNo = backups.size() + 1;
-
-                const auto backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
+                const auto backupFilePath = prepareBackup(logger, mapPath);
 
                 m_lastSaveTime = Clock::now();
                 m_lastModificationCount = document->modificationCount();
@@ -127,6 +150,155 @@ namespace TrenchBroom {
             }
         }
 
+        namespace {
+            /**
+             * Collects the messages of a background autosave so that they can be logged on the thread that
+             * triggered it.
+             */
+            class BufferingLogger : public Logger {
+            private:
+                std::vector<std::pair<LogLevel, std::string>> m_messages;
+            public:
+                std::vector<std::pair<LogLevel, std::string>> messages() {
+                    return std::move(m_messages);
+                }
+            private:
+                void doLog(const LogLevel level, const std::string& message) override {
+                    m_messages.emplace_back(level, message);
+                }
+
+                void doLog(const LogLevel level, const QString& message) override {
+                    m_messages.emplace_back(level, message.toStdString());
+                }
+            };
+        }
+
+        static void copyNodeState(const Model::Node& original, Model::Node& clone) {
+            if (const auto* world = dynamic_cast<const Model::WorldNode*>(&original)) {
+                static_cast<Model::WorldNode&>(clone).setEntity(world->entity());
+            } else if (const auto* layer = dynamic_cast<const Model::LayerNode*>(&original)) {
+                auto& layerClone = static_cast<Model::LayerNode&>(clone);
+                layerClone.setEntity(layer->entity());
+                if (layer->persistentId()) {
+                    layerClone.setPersistentId(*layer->persistentId());
+                }
+            } else if (const auto* group = dynamic_cast<const Model::GroupNode*>(&original)) {
+                auto& groupClone = static_cast<Model::GroupNode&>(clone);
+                groupClone.setEntity(group->entity());
+                if (group->persistentId()) {
+                    groupClone.setPersistentId(*group->persistentId());
+                }
+            }
+
+            assert(original.childCount() == clone.childCount());
+            for (size_t i = 0u; i < original.childCount(); ++i) {
+                copyNodeState(*original.children()[i], *clone.children()[i]);
+            }
+        }
+
+        /**
+         * Removes the references to entity definitions, entity models and textures from the given snapshot. The
+         * snapshot is destroyed on a worker thread, possibly after the assets were reloaded, but the usage counts of
+         * the assets must only be changed on the main thread while the assets are alive. Writing a map does not
+         * require any assets.
+         */
+        static void detachAssets(Model::WorldNode& snapshot) {
+            snapshot.accept(kdl::overload(
+                [](auto&& thisLambda, Model::WorldNode* world) { world->setDefinition(nullptr); world->visitChildren(thisLambda); },
+                [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+                [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+                [](auto&& thisLambda, Model::EntityNode* entity) {
+                    entity->setDefinition(nullptr);
+                    entity->setModelFrame(nullptr);
+                    entity->visitChildren(thisLambda);
+                },
+                [](Model::BrushNode* brushNode) {
+                    for (size_t i = 0u; i < brushNode->brush().faceCount(); ++i) {
+                        brushNode->setFaceTexture(i, nullptr);
+                    }
+                }
+            ));
+        }
+
+        /**
+         * Returns a deep copy of the given world that is not affected by any later changes to the document. Cloning
+         * a node does not copy the attributes of worlds, layers and groups, nor the persistent IDs of layers and
+         * groups, so these are copied afterwards. The copy does not refer to any assets.
+         */
+        static std::unique_ptr<Model::WorldNode> takeWorldSnapshot(const Model::WorldNode& world, const vm::bbox3& worldBounds) {
+            auto snapshot = std::unique_ptr<Model::WorldNode>(static_cast<Model::WorldNode*>(world.cloneRecursively(worldBounds)));
+            copyNodeState(world, *snapshot);
+            detachAssets(*snapshot);
+            return snapshot;
+        }
+
+        void Autosaver::autosaveInBackground(std::shared_ptr<MapDocument> document) {
+            const auto mapPath = document->path();
+            assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
+
+            // a failed backup is not retried before the save interval has passed again, just like a synchronous one
+            m_lastSaveTime = Clock::now();
+            m_lastModificationCount = document->modificationCount();
+
+            auto game = document->game();
+            auto world = takeWorldSnapshot(*document->world(), document->worldBounds());
+            m_pendingAutosave = kdl::default_thread_pool().async([this, mapPath, game = std::move(game), world = std::move(world)]() {
+                BufferingLogger logger;
+                try {
+                    const auto backupFilePath = prepareBackup(logger, mapPath);
+                    game->writeMap(*world, backupFilePath);
+
+                    logger.info() << "Created autosave backup at " << backupFilePath;
+                } catch (const FileSystemException& e) {
+                    logger.error() << "Aborting autosave: " << e.what();
+                }
+                return logger.messages();
+            });
+        }
+
+        /**
+         * Logs the messages of the backup that was written in the background, if any.
+         *
+         * @param logger the logger to log the messages to
+         * @param wait whether to wait for the backup to complete
+         * @return true if no backup is being written in the background anymore
+         */
+        bool Autosaver::collectPendingAutosave(Logger& logger, const bool wait) {
+            if (!m_pendingAutosave.valid()) {
+                return true;
+            }
+            if (!wait && m_pendingAutosave.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+
+            for (const auto& [level, message] : m_pendingAutosave.get()) {
+                logger.log(level, message);
+            }
+            return true;
+        }
+
+        /**
+         * Creates the autosave directory if necessary, deletes and renumbers the existing backups so that there is
+         * room for a new one, and returns the absolute path of the new backup.
+         *
+         * Threadsafe
+         */
+        IO::Path Autosaver::prepareBackup(Logger& logger, const IO::Path& mapPath) const {
+            const auto mapFilename = mapPath.lastComponent();
+            const auto mapBasename = mapFilename.deleteExtension();
+
+            auto fs = createBackupFileSystem(logger, mapPath);
+            auto backups = collectBackups(fs, mapBasename);
+
+            thinBackups(logger, fs, backups);
+            cleanBackups(fs, backups, mapBasename);
+
+            assert(backups.size() < m_maxBackups);
+            const auto backupNo = backups.size() + 1;
+
+            return fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
+        }
+
         IO::WritableDiskFileSystem Autosaver::createBackupFileSystem(Logger& logger, const IO::Path& mapPath) const {
             const auto basePath = mapPath.deleteLastComponent();
             const auto autosavePath = basePath + IO::Path("autosave");
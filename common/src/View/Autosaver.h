@@ -22,10 +22,15 @@
 #include "IO/Path.h"
 
 #include <chrono>
+#include <future>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     class Logger;
+    enum class LogLevel;
 
     namespace IO {
         class WritableDiskFileSystem;
@@ -37,6 +42,19 @@ namespace TrenchBroom {
 
         class Autosaver {
         public:
+            /**
+             * Determines how a backup is written.
+             *
+             * Synchronous: the document is saved to the backup file on the calling thread.
+             * Background: a snapshot of the world is taken on the calling thread, and the snapshot is written to the
+             * backup file by a task of the process wide thread pool. Old backups are also thinned out by that task.
+             * The document can be edited while the backup is being written.
+             */
+            enum class Mode {
+                Synchronous,
+                Background
+            };
+
             class BackupFileMatcher {
             private:
                 const IO::Path m_mapBasename;
@@ -69,13 +87,34 @@ namespace TrenchBroom {
              * The modification count that was last recorded.
              */
             size_t m_lastModificationCount;
-            
+
+            Mode m_mode;
+
+            /**
+             * The messages logged by the backup that is being written in the background, if any.
+             */
+            using LogMessage = std::pair<LogLevel, std::string>;
+            std::future<std::vector<LogMessage>> m_pendingAutosave;
         public:
-            explicit Autosaver(std::weak_ptr<MapDocument> document, std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000), size_t maxBackups = 50);
+            explicit Autosaver(std::weak_ptr<MapDocument> document, std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000), size_t maxBackups = 50, Mode mode = Mode::Synchronous);
+            ~Autosaver();
 
+            /**
+             * Creates a backup if the document was modified and the save interval has passed. If a backup is still
+             * being written in the background, no new backup is created.
+             */
             void triggerAutosave(Logger& logger);
+
+            /**
+             * Waits until the backup that is being written in the background, if any, is complete, and logs its
+             * messages to the given logger.
+             */
+            void waitForAutosave(Logger& logger);
         private:
             void autosave(Logger& logger, std::shared_ptr<View::MapDocument> document);
+            void autosaveInBackground(std::shared_ptr<View::MapDocument> document);
+            bool collectPendingAutosave(Logger& logger, bool wait);
+            IO::Path prepareBackup(Logger& logger, const IO::Path& mapPath) const;
             IO::WritableDiskFileSystem createBackupFileSystem(Logger& logger, const IO::Path& mapPath) const;
             std::vector<IO::Path> collectBackups(const IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const;
             void thinBackups(Logger& logger, IO::WritableDiskFileSystem& fs, std::vector<IO::Path>& backups) const;
@@ -26,6 +26,7 @@
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
@@ -118,22 +119,26 @@ namespace TrenchBroom {
             if (document->world() != nullptr) {
                 const auto& issueGenerators = document->world()->registeredIssueGenerators();
                 
+                auto nodes = std::vector<Model::Node*>{};
+                document->world()->accept(kdl::overload(
+                    [&](auto&& thisLambda, Model::WorldNode* world)   { nodes.push_back(world); world->visitChildren(thisLambda); },
+                    [&](auto&& thisLambda, Model::LayerNode* layer)   { nodes.push_back(layer); layer->visitChildren(thisLambda); },
+                    [&](auto&& thisLambda, Model::GroupNode* group)   { nodes.push_back(group); group->visitChildren(thisLambda); },
+                    [&](auto&& thisLambda, Model::EntityNode* entity) { nodes.push_back(entity); entity->visitChildren(thisLambda); },
+                    [&](Model::BrushNode* brush)                      { nodes.push_back(brush); }
+                ));
+
+                // only the nodes that changed since the last update are validated again
+                Model::validateIssues(nodes, issueGenerators);
+
                 auto issues = std::vector<Model::Issue*>{};
-                const auto collectIssues = [&](auto* node) {
+                for (auto* node : nodes) {
                     for (auto* issue : node->issues(issueGenerators)) {
                         if (m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenGenerators) == 0)) {
                             issues.push_back(issue);
                         }
                     }
-                };
-
-                document->world()->accept(kdl::overload(
-                    [&](auto&& thisLambda, Model::WorldNode* world)   { collectIssues(world); world->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::LayerNode* layer)   { collectIssues(layer); layer->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::GroupNode* group)   { collectIssues(group); group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { collectIssues(entity); entity->visitChildren(thisLambda); },
-                    [&](Model::BrushNode* brush)                      { collectIssues(brush); }
-                ));
+                }
 
                 issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) { return lhs->seqId() > rhs->seqId(); });
                 m_tableModel->setIssues(std::move(issues));
@@ -32,7 +32,10 @@
 #include "EL/ELExceptions.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/GameConfigParser.h"
+#include "IO/MapFileSerializer.h"
+#include "IO/Reader.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
 #include "Model/AttributeNameWithDoubleQuotationMarksIssueGenerator.h"
@@ -40,6 +43,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushGeometry.h"
@@ -132,6 +136,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -360,20 +365,72 @@ namespace TrenchBroom {
         void MapDocument::saveDocumentTo(const IO::Path& path) {
             ensure(m_game.get() != nullptr, "game is null");
             ensure(m_world != nullptr, "world is null");
+
+            // writing the map updates the file positions of all nodes
+            clearSavedFile();
             m_game->writeMap(*m_world, path);
         }
 
         void MapDocument::exportDocumentAs(const Model::ExportFormat format, const IO::Path& path) {
+            clearSavedFile();
             m_game->exportMap(*m_world, format, path);
         }
 
         void MapDocument::doSaveDocument(const IO::Path& path) {
-            saveDocumentTo(path);
+            auto savedFileHash = saveDocumentIncrementally(path);
+            if (!savedFileHash) {
+                clearSavedFile();
+                savedFileHash = m_game->writeMap(*m_world, path);
+            }
+            setSavedFile(path, *savedFileHash);
             setLastSaveModificationCount();
             setPath(path);
             documentWasSavedNotifier(this);
         }
 
+        /**
+         * Saves the document to the given path by copying the entities and brushes that were not modified from the
+         * file that the document was last saved to. This is only possible if the document was last saved to the same
+         * path, and if the file was not changed since.
+         *
+         * @return the hash of the saved file, or nothing if the document must be saved completely
+         */
+        std::optional<IO::TextHash> MapDocument::saveDocumentIncrementally(const IO::Path& path) {
+            if (!m_savedFile || m_savedFile->path != path) {
+                return std::nullopt;
+            }
+
+            // the previous file is read while the map is written, so the map is written to a temporary file first
+            const auto tempPath = path.addExtension("tmp");
+            try {
+                auto hash = IO::TextHash{};
+                {
+                    const auto file = IO::Disk::openFile(path);
+                    const auto reader = file->reader().buffer();
+                    const auto text = reader.stringView();
+                    if (text.size() != m_savedFile->hash.size || IO::hashText(text) != m_savedFile->hash) {
+                        return std::nullopt;
+                    }
+
+                    const auto isModified = [&](const Model::Node* node) {
+                        return m_modifiedNodes.count(node) > 0u;
+                    };
+                    hash = m_game->writeMap(*m_world, tempPath, IO::PreviousMapFile{text, isModified});
+                }
+
+                IO::Disk::moveFile(tempPath, path, true);
+                return hash;
+            } catch (const FileSystemException& e) {
+                warn() << "Could not save map incrementally: " << e.what();
+                try {
+                    if (IO::Disk::fileExists(tempPath)) {
+                        IO::Disk::deleteFile(tempPath);
+                    }
+                } catch (const FileSystemException&) {}
+                return std::nullopt;
+            }
+        }
+
         void MapDocument::clearDocument() {
             if (m_world != nullptr) {
                 documentWillBeClearedNotifier(this);
@@ -384,6 +441,7 @@ namespace TrenchBroom {
                 clearTagActions();
                 clearWorld();
                 clearModificationCount();
+                clearSavedFile();
 
                 documentWasClearedNotifier(this);
             }
@@ -396,6 +454,13 @@ namespace TrenchBroom {
         std::string MapDocument::serializeSelectedNodes() {
             std::stringstream stream;
             m_game->writeNodesToStream(*m_world, m_selectedNodes.nodes(), stream);
+
+            // serializing the nodes updates the file positions of the nodes and of the world
+            for (const auto* node : m_selectedNodes.nodes()) {
+                setModifiedRecursively(node);
+            }
+            setModified(m_world.get());
+
             return stream.str();
         }
 
@@ -687,7 +752,7 @@ namespace TrenchBroom {
 
         void MapDocument::selectTouching(const bool del) {
             const auto nodes = kdl::vec_filter(
-                Model::collectTouchingNodes(std::vector<Model::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+                Model::collectTouchingNodes(*m_world, m_selectedNodes.brushes()),
                 [&](Model::Node* node) { return m_editorContext->selectable(node); });
 
             Transaction transaction(this, "Select Touching");
@@ -700,7 +765,7 @@ namespace TrenchBroom {
 
         void MapDocument::selectInside(const bool del) {
             const auto nodes = kdl::vec_filter(
-                Model::collectContainedNodes(std::vector<Model::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+                Model::collectContainedNodes(*m_world, m_selectedNodes.brushes()),
                 [&](Model::Node* node) { return m_editorContext->selectable(node); });
 
             Transaction transaction(this, "Select Inside");
@@ -834,7 +899,7 @@ namespace TrenchBroom {
             deleteObjects();
 
             const auto nodesToSelect = kdl::vec_filter(
-                Model::collectContainedNodes(std::vector<Model::Node*>{world()}, tallBrushes), 
+                Model::collectContainedNodes(*world(), tallBrushes),
                 [&](const auto* node) { return editorContext().selectable(node); });
             kdl::vec_clear_and_delete(tallBrushes);
 
@@ -2220,7 +2285,7 @@ namespace TrenchBroom {
                     const Model::Brush& brush = brushNode->brush();
                     for (size_t i = 0u; i < brush.faceCount(); ++i) {
                         const Model::BrushFace& face = brush.face(i);
-                        Assets::Texture* texture = manager.texture(face.attributes().textureName());
+                        Assets::Texture* texture = manager.texture(face.attributes().internedTextureName());
                         brushNode->setFaceTexture(i, texture);
                     }
                 }
@@ -2256,7 +2321,7 @@ namespace TrenchBroom {
             for (const auto& faceHandle : faceHandles) {
                 Model::BrushNode* node = faceHandle.node();
                 const Model::BrushFace& face = faceHandle.face();
-                Assets::Texture* texture = m_textureManager->texture(face.attributes().textureName());
+                Assets::Texture* texture = m_textureManager->texture(face.attributes().internedTextureName());
                 node->setFaceTexture(faceHandle.faceIndex(), texture);
             }
             textureUsageCountsDidChangeNotifier();
@@ -2580,6 +2645,79 @@ namespace TrenchBroom {
             documentModificationStateDidChangeNotifier();
         }
 
+        void MapDocument::setSavedFile(const IO::Path& path, const IO::TextHash& hash) {
+            m_savedFile = SavedFile{path, hash};
+            m_modifiedNodes.clear();
+        }
+
+        void MapDocument::clearSavedFile() {
+            m_savedFile = std::nullopt;
+            m_modifiedNodes.clear();
+        }
+
+        /**
+         * Returns the node for which the entity that contains the given node is written to a map file.
+         */
+        static const Model::Node* serializedEntityNode(const Model::Node* node) {
+            return node->accept(kdl::overload(
+                [](const Model::WorldNode* world)   -> const Model::Node* { return world; },
+                [](const Model::LayerNode* layer)   -> const Model::Node* {
+                    return layer->isDefaultLayer() && layer->parent() != nullptr ? layer->parent() : layer;
+                },
+                [](const Model::GroupNode* group)   -> const Model::Node* { return group; },
+                [](const Model::EntityNode* entity) -> const Model::Node* { return entity; },
+                [](const Model::BrushNode* brush)   -> const Model::Node* {
+                    return brush->parent() != nullptr ? serializedEntityNode(brush->parent()) : brush;
+                }
+            ));
+        }
+
+        /**
+         * Marks the given node as modified, and the entity that contains it, too.
+         */
+        void MapDocument::setModified(const Model::Node* node) {
+            if (m_savedFile) {
+                m_modifiedNodes.insert(node);
+                m_modifiedNodes.insert(serializedEntityNode(node));
+            }
+        }
+
+        void MapDocument::setModifiedRecursively(const Model::Node* node) {
+            setModified(node);
+            for (const auto* child : node->children()) {
+                setModifiedRecursively(child);
+            }
+        }
+
+        void MapDocument::nodesWereAddedForSave(const std::vector<Model::Node*>& nodes) {
+            // the file positions of added nodes don't refer to the saved file
+            for (const auto* node : nodes) {
+                setModifiedRecursively(node);
+            }
+        }
+
+        void MapDocument::nodesDidChangeForSave(const std::vector<Model::Node*>& nodes) {
+            // this is also called for the parents of added and removed nodes
+            for (const auto* node : nodes) {
+                setModified(node);
+            }
+        }
+
+        void MapDocument::layersDidChangeForSave(const std::vector<Model::Node*>& nodes) {
+            // the visibility and lock state of layers are stored in the layer entities
+            for (const auto* node : nodes) {
+                if (dynamic_cast<const Model::LayerNode*>(node) != nullptr) {
+                    setModified(node);
+                }
+            }
+        }
+
+        void MapDocument::brushFacesDidChangeForSave(const std::vector<Model::BrushFaceHandle>& faces) {
+            for (const auto& face : faces) {
+                setModified(face.node());
+            }
+        }
+
         void MapDocument::bindObservers() {
             PreferenceManager& prefs = PreferenceManager::instance();
             prefs.preferenceDidChangeNotifier.addObserver(this, &MapDocument::preferenceDidChange);
@@ -2596,6 +2734,13 @@ namespace TrenchBroom {
             brushFacesDidChangeNotifier.addObserver(this, &MapDocument::updateFaceTags);
             modsDidChangeNotifier.addObserver(this, &MapDocument::updateAllFaceTags);
             textureCollectionsDidChangeNotifier.addObserver(this, &MapDocument::updateAllFaceTags);
+
+            // incremental saving
+            nodesWereAddedNotifier.addObserver(this, &MapDocument::nodesWereAddedForSave);
+            nodesDidChangeNotifier.addObserver(this, &MapDocument::nodesDidChangeForSave);
+            nodeVisibilityDidChangeNotifier.addObserver(this, &MapDocument::layersDidChangeForSave);
+            nodeLockingDidChangeNotifier.addObserver(this, &MapDocument::layersDidChangeForSave);
+            brushFacesDidChangeNotifier.addObserver(this, &MapDocument::brushFacesDidChangeForSave);
         }
 
         void MapDocument::unbindObservers() {
@@ -2614,6 +2759,13 @@ namespace TrenchBroom {
             brushFacesDidChangeNotifier.removeObserver(this, &MapDocument::updateFaceTags);
             modsDidChangeNotifier.removeObserver(this, &MapDocument::updateAllFaceTags);
             textureCollectionsDidChangeNotifier.removeObserver(this, &MapDocument::updateAllFaceTags);
+
+            // incremental saving
+            nodesWereAddedNotifier.removeObserver(this, &MapDocument::nodesWereAddedForSave);
+            nodesDidChangeNotifier.removeObserver(this, &MapDocument::nodesDidChangeForSave);
+            nodeVisibilityDidChangeNotifier.removeObserver(this, &MapDocument::layersDidChangeForSave);
+            nodeLockingDidChangeNotifier.removeObserver(this, &MapDocument::layersDidChangeForSave);
+            brushFacesDidChangeNotifier.removeObserver(this, &MapDocument::brushFacesDidChangeForSave);
         }
 
         void MapDocument::preferenceDidChange(const IO::Path& path) {
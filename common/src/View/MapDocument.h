@@ -21,6 +21,7 @@
 
 #include "FloatType.h"
 #include "Notifier.h"
+#include "IO/IOUtils.h"
 #include "IO/Path.h"
 #include "Model/Game.h"
 #include "Model/MapFacade.h"
@@ -35,6 +36,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -111,6 +113,18 @@ namespace TrenchBroom {
             size_t m_lastSaveModificationCount;
             size_t m_modificationCount;
 
+            /*
+             * The map file that the document was last saved to, and the nodes that were modified since. When the
+             * document is saved to the same file again, and the file was not changed by anyone else in the meantime,
+             * the entities and brushes which were not modified are copied from the file.
+             */
+            struct SavedFile {
+                IO::Path path;
+                IO::TextHash hash;
+            };
+            std::optional<SavedFile> m_savedFile;
+            std::unordered_set<const Model::Node*> m_modifiedNodes;
+
             Model::NodeCollection m_selectedNodes;
             std::vector<Model::BrushFaceHandle> m_selectedBrushFaces;
 
@@ -258,6 +272,7 @@ namespace TrenchBroom {
             void exportDocumentAs(Model::ExportFormat format, const IO::Path& path);
         private:
             void doSaveDocument(const IO::Path& path);
+            std::optional<IO::TextHash> saveDocumentIncrementally(const IO::Path& path);
             void clearDocument();
         public: // text encoding
             MapTextEncoding encoding() const;
@@ -568,6 +583,16 @@ namespace TrenchBroom {
         private:
             void setLastSaveModificationCount();
             void clearModificationCount();
+        private: // tracking modified nodes for incremental saving
+            void setSavedFile(const IO::Path& path, const IO::TextHash& hash);
+            void clearSavedFile();
+            void setModified(const Model::Node* node);
+            void setModifiedRecursively(const Model::Node* node);
+
+            void nodesWereAddedForSave(const std::vector<Model::Node*>& nodes);
+            void nodesDidChangeForSave(const std::vector<Model::Node*>& nodes);
+            void layersDidChangeForSave(const std::vector<Model::Node*>& nodes);
+            void brushFacesDidChangeForSave(const std::vector<Model::BrushFaceHandle>& faces);
         private: // observers
             void bindObservers();
             void unbindObservers();
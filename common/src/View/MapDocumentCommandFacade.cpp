@@ -36,6 +36,7 @@
 #include "Model/Game.h"
 #include "Model/GroupNode.h"
 #include "Model/Issue.h"
+#include "Model/LayerNode.h"
 #include "Model/ModelUtils.h"
 #include "Model/Snapshot.h"
 #include "Model/WorldNode.h"
@@ -45,6 +46,7 @@
 
 #include <kdl/map_utils.h>
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
@@ -56,6 +58,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -412,8 +415,53 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*> &>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier<const std::vector<Model::Node*> &>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
 
+            // collect the brushes and entities in the order in which the nodes transform them
+            std::vector<Model::Node*> nodesToTransform;
+            std::vector<Model::BrushNode*> brushesToTransform;
+            for (auto* node : nodes) {
+                node->accept(kdl::overload(
+                    [] (Model::WorldNode*) {},
+                    [] (Model::LayerNode*) {},
+                    [] (auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+                    [&](Model::EntityNode* entity) {
+                        // the brushes of an entity are applied by the entity so that it is notified only once
+                        nodesToTransform.push_back(entity);
+                        entity->visitChildren(kdl::overload(
+                            [] (Model::WorldNode*)  {},
+                            [] (Model::LayerNode*)  {},
+                            [] (Model::GroupNode*)  {},
+                            [] (Model::EntityNode*) {},
+                            [&](Model::BrushNode* brush) { brushesToTransform.push_back(brush); }
+                        ));
+                    },
+                    [&](Model::BrushNode* brush) {
+                        nodesToTransform.push_back(brush);
+                        brushesToTransform.push_back(brush);
+                    }
+                ));
+            }
+
+            // transforming the brushes is expensive, so compute the new brushes in parallel and apply them in order below
+            auto transformedBrushes = kdl::vec_parallel_transform(brushesToTransform, [&](const Model::BrushNode* brushNode) {
+                return brushNode->brush().transform(m_worldBounds, transform, lockTextures);
+            });
+
+            size_t nextBrushIndex = 0u;
+            const auto applyTransformedBrush = [&](Model::BrushNode* brushNode) {
+                assert(brushesToTransform[nextBrushIndex] == brushNode);
+                return std::move(transformedBrushes[nextBrushIndex++]).visit(kdl::overload(
+                    [&](Model::Brush&& brush) {
+                        brushNode->setBrush(std::move(brush));
+                        return kdl::result<void, Model::TransformError>::success();
+                    },
+                    [](const Model::BrushError e) {
+                        return kdl::result<void, Model::TransformError>::error(Model::TransformError{kdl::str_to_string(e)});
+                    }
+                ));
+            };
+
             bool success = true;
-            for (auto nodeIt = std::begin(nodes); nodeIt != std::end(nodes) && success; ++nodeIt) {
+            for (auto nodeIt = std::begin(nodesToTransform); nodeIt != std::end(nodesToTransform) && success; ++nodeIt) {
                 success = (*nodeIt)->accept(kdl::overload(
                     [](Model::WorldNode*) {
                         return kdl::result<void, Model::TransformError>::success();
@@ -421,14 +469,18 @@ namespace TrenchBroom {
                     [](Model::LayerNode*) {
                         return kdl::result<void, Model::TransformError>::success();
                     },
-                    [&](Model::GroupNode* group) {
-                        return group->transform(m_worldBounds, transform, lockTextures);
+                    [](Model::GroupNode*) {
+                        return kdl::result<void, Model::TransformError>::success();
                     },
                     [&](Model::EntityNode* entity) {
-                        return entity->transform(m_worldBounds, transform, lockTextures);
+                        if (entity->hasChildren()) {
+                            return entity->transformBrushes(applyTransformedBrush);
+                        } else {
+                            return entity->transform(m_worldBounds, transform, lockTextures);
+                        }
                     },
-                    [&](Model::BrushNode* brush) {
-                        return brush->transform(m_worldBounds, transform, lockTextures);
+                    [&](Model::BrushNode* brushNode) {
+                        return applyTransformedBrush(brushNode);
                     }
                 )).handle_errors(
                     [&](Model::TransformError&& e) {
@@ -109,7 +109,7 @@ namespace TrenchBroom {
         m_frameManager(frameManager),
         m_document(std::move(document)),
         m_lastInputTime(std::chrono::system_clock::now()),
-        m_autosaver(std::make_unique<Autosaver>(m_document)),
+        m_autosaver(std::make_unique<Autosaver>(m_document, std::chrono::minutes(10), 50u, Autosaver::Mode::Background)),
         m_autosaveTimer(nullptr),
         m_toolBar(nullptr),
         m_hSplitter(nullptr),
@@ -185,7 +185,9 @@ namespace TrenchBroom {
 
             // let's trigger a final autosave before releasing the document
             NullLogger logger;
+            m_autosaver->waitForAutosave(logger);
             m_autosaver->triggerAutosave(logger);
+            m_autosaver->waitForAutosave(logger);
 
             m_document->setViewEffectsService(nullptr);
             m_document.reset();
@@ -22,8 +22,11 @@
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
 
+#include <cmath>
+#include <random>
 #include <set>
 #include <sstream>
+#include <vector>
 
 #include "Catch2.h"
 #include "GTestCompat.h"
@@ -36,6 +39,7 @@ namespace TrenchBroom {
 
     void assertTree(const std::string& exp, const AABB& actual);
     void assertIntersectors(const AABB& tree, const RAY& ray, std::initializer_list<AABB::DataType> items);
+    void assertIntersectors(const AABB& tree, const BOX& box, std::initializer_list<AABB::DataType> items);
     void assertTreeContains(const AABB& tree, const BOX& box, AABB::DataType data);
     void assertTreeDoesNotContain(const AABB& tree, const BOX& box, AABB::DataType data);
 
@@ -489,6 +493,225 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
     }
 
+    TEST_CASE("AABBTreeTest.findBoxIntersectors", "[AABBTreeTest]") {
+        AABB tree;
+        assertIntersectors(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), {});
+
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(-1.0, +2.0, -1.0), VEC(+1.0, +4.0, +1.0)), 3u);
+
+        assertIntersectors(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), {});
+        assertIntersectors(tree, BOX(VEC(-3.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), { 1u });
+        assertIntersectors(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(+2.0, +2.0, +1.0)), { 2u, 3u });
+        assertIntersectors(tree, BOX(VEC(-5.0, -5.0, -5.0), VEC(+5.0, +5.0, +5.0)), { 1u, 2u, 3u });
+
+        // touching boxes intersect
+        assertIntersectors(tree, BOX(VEC(-2.0, -1.0, -1.0), VEC(-1.0, +1.0, +1.0)), { 1u });
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildEmpty", "[AABBTreeTest]") {
+        AABB tree;
+        tree.insert(BOX(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0)), 1u);
+
+        tree.clearAndBuild(std::vector<size_t>{}, [](const size_t) { return BOX(); });
+        ASSERT_TRUE(tree.empty());
+        ASSERT_FALSE(tree.contains(1u));
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildSingleNode", "[AABBTreeTest]") {
+        const BOX bounds(VEC(0.0, 0.0, 0.0), VEC(2.0, 1.0, 1.0));
+
+        AABB tree;
+        tree.clearAndBuild(std::vector<size_t>{1u}, [&](const size_t) { return bounds; });
+
+        assertTree(R"(
+L [ ( 0 0 0 ) ( 2 1 1 ) ]: 1
+)" , tree);
+        assertTreeContains(tree, bounds, 1u);
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildSplitsBySurfaceArea", "[AABBTreeTest]") {
+        // two clusters of boxes, the builder must separate the clusters at the root
+        const std::vector<BOX> bounds{
+            BOX(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0)),
+            BOX(VEC(10.0, 0.0, 0.0), VEC(11.0, 1.0, 1.0)),
+            BOX(VEC(1.0, 0.0, 0.0), VEC(2.0, 1.0, 1.0)),
+            BOX(VEC(11.0, 0.0, 0.0), VEC(12.0, 1.0, 1.0)),
+        };
+
+        AABB tree;
+        tree.clearAndBuild(std::vector<size_t>{0u, 1u, 2u, 3u}, [&](const size_t i) { return bounds[i]; });
+
+        assertTree(R"(
+O [ ( 0 0 0 ) ( 12 1 1 ) ]
+  O [ ( 0 0 0 ) ( 2 1 1 ) ]
+    L [ ( 0 0 0 ) ( 1 1 1 ) ]: 0
+    L [ ( 1 0 0 ) ( 2 1 1 ) ]: 2
+  O [ ( 10 0 0 ) ( 12 1 1 ) ]
+    L [ ( 10 0 0 ) ( 11 1 1 ) ]: 1
+    L [ ( 11 0 0 ) ( 12 1 1 ) ]: 3
+)" , tree);
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildWithDuplicateData", "[AABBTreeTest]") {
+        AABB tree;
+        ASSERT_THROW(tree.clearAndBuild(std::vector<size_t>{1u, 2u, 1u}, [](const size_t) { return BOX(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0)); }), NodeTreeException);
+        ASSERT_TRUE(tree.empty());
+        ASSERT_FALSE(tree.contains(1u));
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildWithIdenticalBounds", "[AABBTreeTest]") {
+        const BOX bounds(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0));
+        const std::vector<size_t> data{1u, 2u, 3u, 4u, 5u};
+
+        AABB tree;
+        tree.clearAndBuild(data, [&](const size_t) { return bounds; });
+
+        ASSERT_EQ(4u, tree.height());
+        for (const auto i : data) {
+            assertTreeContains(tree, bounds, i);
+        }
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildMatchesIncrementalQueries", "[AABBTreeTest]") {
+        std::mt19937 rng(42u);
+        std::uniform_real_distribution<double> pos(-1000.0, 1000.0);
+        std::uniform_real_distribution<double> size(1.0, 64.0);
+
+        std::vector<BOX> bounds;
+        std::vector<size_t> data;
+        // enough nodes to exercise the parallel builder
+        for (size_t i = 0u; i < 10000u; ++i) {
+            const auto min = VEC(pos(rng), pos(rng), pos(rng));
+            bounds.emplace_back(min, min + VEC(size(rng), size(rng), size(rng)));
+            data.push_back(i);
+        }
+
+        AABB incremental;
+        for (size_t i = 0u; i < data.size(); ++i) {
+            incremental.insert(bounds[i], data[i]);
+        }
+
+        AABB bulk;
+        bulk.clearAndBuild(data, [&](const size_t i) { return bounds[i]; });
+        // rebuilding must not complain about existing data
+        bulk.clearAndBuild(data, [&](const size_t i) { return bounds[i]; });
+
+        ASSERT_EQ(incremental.bounds(), bulk.bounds());
+        ASSERT_LE(bulk.height(), 64u);
+
+        for (size_t i = 0u; i < 100u; ++i) {
+            const auto ray = RAY(VEC(pos(rng), pos(rng), pos(rng)), vm::normalize(VEC(pos(rng), pos(rng), pos(rng))));
+
+            std::set<size_t> expected;
+            incremental.findIntersectors(ray, std::inserter(expected, std::end(expected)));
+
+            std::set<size_t> actual;
+            bulk.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+
+            ASSERT_EQ(expected, actual);
+        }
+
+        for (size_t i = 0u; i < data.size(); i += 97u) {
+            assertTreeContains(bulk, bounds[i], data[i]);
+        }
+
+        // incremental updates still work after a bulk build
+        ASSERT_TRUE(bulk.remove(data[0]));
+        assertTreeDoesNotContain(bulk, bounds[0], data[0]);
+        bulk.insert(bounds[0], data[0]);
+        assertTreeContains(bulk, bounds[0], data[0]);
+    }
+
+    TEST_CASE("AABBTreeTest.freeze", "[AABBTreeTest]") {
+        AABB tree;
+        tree.freeze();
+        ASSERT_FALSE(tree.frozen());
+
+        const auto box1 = BOX(VEC(-2.0, -1.0, -1.0), VEC(-1.0, +1.0, +1.0));
+        const auto box2 = BOX(VEC(+1.0, -1.0, -1.0), VEC(+2.0, +1.0, +1.0));
+        const auto box3 = BOX(VEC(-0.5, -0.5, -0.5), VEC(+0.5, +0.5, +0.5));
+
+        tree.insert(box1, 1u);
+        tree.insert(box2, 2u);
+        ASSERT_FALSE(tree.frozen());
+
+        tree.freeze();
+        ASSERT_TRUE(tree.frozen());
+        assertIntersectors(tree, RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x()), {1u, 2u});
+        assertIntersectors(tree, RAY(VEC(-3.0, 0.0, 0.0), VEC::neg_x()), {});
+        assertIntersectors(tree, RAY(VEC(+1.5, 0.0, 0.0), VEC::pos_y()), {2u});
+        assertTreeContains(tree, box1, 1u);
+        assertTreeContains(tree, box2, 2u);
+
+        tree.insert(box3, 3u);
+        ASSERT_FALSE(tree.frozen());
+        tree.freeze();
+        assertIntersectors(tree, RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x()), {1u, 2u, 3u});
+
+        tree.update(BOX(VEC(-0.5, -0.5, 4.5), VEC(+0.5, +0.5, 5.5)), 3u);
+        ASSERT_FALSE(tree.frozen());
+        tree.freeze();
+        assertIntersectors(tree, RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x()), {1u, 2u});
+        assertIntersectors(tree, RAY(VEC(0.0, 0.0, -3.0), VEC::pos_z()), {3u});
+
+        ASSERT_TRUE(tree.remove(1u));
+        ASSERT_FALSE(tree.frozen());
+        tree.freeze();
+        assertIntersectors(tree, RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x()), {2u});
+        assertTreeDoesNotContain(tree, box1, 1u);
+
+        tree.clear();
+        ASSERT_FALSE(tree.frozen());
+        assertIntersectors(tree, RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x()), {});
+    }
+
+    TEST_CASE("AABBTreeTest.frozenQueriesMatchPointerQueries", "[AABBTreeTest]") {
+        std::mt19937 rng(7u);
+        std::uniform_real_distribution<double> pos(-100.0, 100.0);
+        std::uniform_real_distribution<double> size(1.0, 16.0);
+
+        AABB tree;
+        for (size_t i = 0u; i < 1000u; ++i) {
+            const auto min = VEC(pos(rng), pos(rng), pos(rng));
+            tree.insert(BOX(min, min + VEC(size(rng), size(rng), size(rng))), i);
+        }
+        ASSERT_FALSE(tree.frozen());
+
+        std::vector<RAY> rays;
+        std::vector<VEC> points;
+        for (size_t i = 0u; i < 100u; ++i) {
+            rays.emplace_back(VEC(pos(rng), pos(rng), pos(rng)), vm::normalize(VEC(pos(rng), pos(rng), pos(rng))));
+            points.emplace_back(pos(rng), pos(rng), pos(rng));
+        }
+
+        std::vector<BOX> boxes;
+        for (size_t i = 0u; i < 100u; ++i) {
+            const auto min = VEC(pos(rng), pos(rng), pos(rng));
+            boxes.emplace_back(min, min + VEC(size(rng), size(rng), size(rng)));
+        }
+
+        std::vector<std::vector<size_t>> expectedIntersectors;
+        std::vector<std::vector<size_t>> expectedContainers;
+        std::vector<std::vector<size_t>> expectedBoxIntersectors;
+        for (size_t i = 0u; i < rays.size(); ++i) {
+            expectedIntersectors.push_back(tree.findIntersectors(rays[i]));
+            expectedContainers.push_back(tree.findContainers(points[i]));
+            expectedBoxIntersectors.push_back(tree.findIntersectors(boxes[i]));
+        }
+
+        tree.freeze();
+        ASSERT_TRUE(tree.frozen());
+
+        // both layouts visit the nodes in the same depth first order, so the results are identical
+        for (size_t i = 0u; i < rays.size(); ++i) {
+            ASSERT_EQ(expectedIntersectors[i], tree.findIntersectors(rays[i]));
+            ASSERT_EQ(expectedContainers[i], tree.findContainers(points[i]));
+            ASSERT_EQ(expectedBoxIntersectors[i], tree.findIntersectors(boxes[i]));
+        }
+    }
+
     void assertTree(const std::string& exp, const AABB& actual) {
         std::stringstream str;
         actual.print(str);
@@ -504,6 +727,15 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         ASSERT_EQ(expected, actual);
     }
 
+    void assertIntersectors(const AABB& tree, const BOX& box, std::initializer_list<AABB::DataType> items) {
+        const std::set<AABB::DataType> expected(items);
+        std::set<AABB::DataType> actual;
+
+        tree.findIntersectors(box, std::inserter(actual, std::end(actual)));
+
+        ASSERT_EQ(expected, actual);
+    }
+
     void assertTreeContains(const AABB& tree, const BOX& box, AABB::DataType data) {
         ASSERT_TRUE(tree.contains(data));
 
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+#include "GTestCompat.h"
+
+namespace TrenchBroom {
+    class AllocatedObject : public Allocator<AllocatedObject, 4, 8> {
+    public:
+        size_t value;
+        double padding[3];
+
+        explicit AllocatedObject(const size_t i_value) :
+        value(i_value),
+        padding{0.0, 0.0, 0.0} {}
+    };
+
+    TEST_CASE("AllocatorTest.allocateAndDelete", "[AllocatorTest]") {
+        std::vector<std::unique_ptr<AllocatedObject>> objects;
+        for (size_t i = 0; i < 1000; ++i) {
+            objects.push_back(std::make_unique<AllocatedObject>(i));
+        }
+
+        std::set<const AllocatedObject*> addresses;
+        for (size_t i = 0; i < objects.size(); ++i) {
+            ASSERT_EQ(i, objects[i]->value);
+            ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(objects[i].get()) % alignof(AllocatedObject));
+            addresses.insert(objects[i].get());
+        }
+        ASSERT_EQ(objects.size(), addresses.size());
+
+        // free every other object and allocate again to reuse the freed blocks
+        for (size_t i = 0; i < objects.size(); i += 2) {
+            objects[i].reset();
+        }
+        for (size_t i = 0; i < objects.size(); i += 2) {
+            objects[i] = std::make_unique<AllocatedObject>(i);
+        }
+        for (size_t i = 0; i < objects.size(); ++i) {
+            ASSERT_EQ(i, objects[i]->value);
+        }
+
+        objects.clear();
+    }
+
+    TEST_CASE("AllocatorTest.deleteNullptr", "[AllocatorTest]") {
+        AllocatedObject* object = nullptr;
+        delete object;
+    }
+
+    TEST_CASE("AllocatorTest.deleteOnOtherThread", "[AllocatorTest]") {
+        std::vector<AllocatedObject*> objects;
+        std::thread producer([&]() {
+            for (size_t i = 0; i < 1000; ++i) {
+                objects.push_back(new AllocatedObject(i));
+            }
+        });
+        producer.join();
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+            ASSERT_EQ(i, objects[i]->value);
+        }
+
+        std::thread consumer([&]() {
+            for (auto* object : objects) {
+                delete object;
+            }
+        });
+        consumer.join();
+    }
+
+    TEST_CASE("AllocatorTest.concurrentAllocation", "[AllocatorTest]") {
+        constexpr size_t ThreadCount = 8;
+        constexpr size_t ObjectCount = 10000;
+
+        std::vector<std::vector<AllocatedObject*>> objects(ThreadCount);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < ThreadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                auto& mine = objects[t];
+                for (size_t i = 0; i < ObjectCount; ++i) {
+                    mine.push_back(new AllocatedObject(t * ObjectCount + i));
+                    if (i % 3 == 0) {
+                        delete mine[i / 2];
+                        mine[i / 2] = new AllocatedObject(t * ObjectCount + i / 2);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::set<const AllocatedObject*> addresses;
+        for (size_t t = 0; t < ThreadCount; ++t) {
+            for (size_t i = 0; i < ObjectCount; ++i) {
+                ASSERT_EQ(t * ObjectCount + i, objects[t][i]->value);
+                addresses.insert(objects[t][i]);
+            }
+        }
+        ASSERT_EQ(ThreadCount * ObjectCount, addresses.size());
+
+        // delete the objects of each thread on another thread
+        threads.clear();
+        for (size_t t = 0; t < ThreadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (auto* object : objects[(t + 1) % ThreadCount]) {
+                    delete object;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
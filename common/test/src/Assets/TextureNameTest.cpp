@@ -0,0 +1,73 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TextureName.h"
+
+#include <kdl/parallel.h>
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        TEST_CASE("TextureNameTest.constructor", "[TextureNameTest]") {
+            CHECK(TextureName().empty());
+            CHECK(TextureName().str() == "");
+            CHECK(TextureName("") == TextureName());
+
+            const auto name = TextureName("base/wall");
+            CHECK_FALSE(name.empty());
+            CHECK(name.str() == "base/wall");
+        }
+
+        TEST_CASE("TextureNameTest.compare", "[TextureNameTest]") {
+            CHECK(TextureName("base/wall") == TextureName("base/wall"));
+            CHECK(TextureName("base/wall") != TextureName("base/floor"));
+            CHECK(TextureName("base/wall") != TextureName("Base/Wall"));
+
+            // equal names share their storage
+            CHECK(&TextureName("base/wall").str() == &TextureName(std::string("base/wall")).str());
+        }
+
+        TEST_CASE("TextureNameTest.caseInsensitiveIndex", "[TextureNameTest]") {
+            CHECK(TextureName("base/wall").caseInsensitiveIndex() == TextureName("Base/Wall").caseInsensitiveIndex());
+            CHECK(TextureName("base/wall").caseInsensitiveIndex() == TextureName("BASE/WALL").caseInsensitiveIndex());
+            CHECK(TextureName("base/wall").caseInsensitiveIndex() != TextureName("base/floor").caseInsensitiveIndex());
+        }
+
+        TEST_CASE("TextureNameTest.concurrentConstruction", "[TextureNameTest]") {
+            auto names = std::vector<std::string>{};
+            for (size_t i = 0u; i < 1000u; ++i) {
+                names.push_back("TextureNameTest/concurrent" + std::to_string(i % 100u));
+            }
+
+            auto textureNames = std::vector<TextureName>(names.size());
+            kdl::parallel_for(0u, names.size(), [&](const size_t i) {
+                textureNames[i] = TextureName(names[i]);
+            });
+
+            for (size_t i = 0u; i < names.size(); ++i) {
+                CHECK(textureNames[i].str() == names[i]);
+                CHECK(textureNames[i] == textureNames[i % 100u]);
+            }
+        }
+    }
+}
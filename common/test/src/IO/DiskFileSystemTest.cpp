@@ -29,6 +29,7 @@
 
 #include <algorithm>
 
+#include <QFile>
 #include <QFileInfo>
 #include <QString>
 
@@ -150,6 +151,29 @@ namespace TrenchBroom {
             ASSERT_TRUE(Disk::openFile(env.dir() + Path("anotherDir/subDirTest/test2.map")) != nullptr);
         }
 
+        TEST_CASE("DiskTest.openMappedFile", "[DiskTest]") {
+            FSTestEnvironment env;
+            env.createFile(Path("empty.txt"), "");
+
+            const auto file = MappedFile(env.dir() + Path("test.txt"));
+            CHECK(file.size() == 12u);
+            CHECK(std::string(file.begin(), file.end()) == "some content");
+
+            // buffering the file does not copy its contents
+            const auto bufferedReader = file.reader().buffer();
+            CHECK(bufferedReader.stringView() == "some content");
+            CHECK(bufferedReader.stringView().data() == file.begin());
+
+            auto reader = file.reader().subReaderFromBegin(5u, 7u);
+            CHECK(reader.readString(7u) == "content");
+
+            const auto emptyFile = MappedFile(env.dir() + Path("empty.txt"));
+            CHECK(emptyFile.size() == 0u);
+            CHECK(emptyFile.reader().buffer().stringView().empty());
+
+            CHECK_THROWS_AS(MappedFile(env.dir() + Path("does_not_exist.txt")), FileSystemException);
+        }
+
         TEST_CASE("DiskTest.resolvePath", "[DiskTest]") {
             FSTestEnvironment env;
 
@@ -301,6 +325,24 @@ namespace TrenchBroom {
             ASSERT_TRUE(std::find(std::begin(items), std::end(items), Path("anotherDir/subDirTest/test2.map")) != std::end(items));
         }
 
+        TEST_CASE("DiskFileSystemTest.refresh", "[DiskFileSystemTest]") {
+            FSTestEnvironment env;
+            DiskFileSystem fs(env.dir());
+
+            CHECK_FALSE(fs.fileExists(Path("anotherDir/newFile.txt")));
+            CHECK(fs.getDirectoryContents(Path("anotherDir")).size() == 2u);
+
+            // the file is found even though the directory contents were cached before it was created
+            env.createFile(Path("anotherDir/newFile.txt"), "some content");
+            CHECK(fs.fileExists(Path("anotherDir/newFile.txt")));
+            CHECK(fs.fileExists(Path("ANOTHERDIR/NEWFILE.TXT")));
+
+            REQUIRE(QFile::remove(IO::pathAsQString(env.dir() + Path("anotherDir/newFile.txt"))));
+            fs.refresh();
+            CHECK_FALSE(fs.fileExists(Path("anotherDir/newFile.txt")));
+            CHECK(fs.getDirectoryContents(Path("anotherDir")).size() == 2u);
+        }
+
         // getDirectoryContents gets tested thoroughly by the tests for the find* methods
 
         TEST_CASE("DiskFileSystemTest.openFile", "[DiskFileSystemTest]") {
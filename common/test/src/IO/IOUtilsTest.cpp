@@ -0,0 +1,73 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST_CASE("IOUtilsTest.hashTextInPieces", "[IOUtilsTest]") {
+            const auto text = std::string("// entity 0\n{\n\"classname\" \"worldspawn\"\n}\n");
+            const auto pieceSize = GENERATE(size_t(1u), size_t(3u), size_t(8u), size_t(13u));
+
+            TextHasher hasher;
+            for (size_t i = 0u; i < text.size(); i += pieceSize) {
+                hasher.add(std::string_view(text).substr(i, pieceSize));
+            }
+
+            const auto hash = hasher.result();
+            CHECK(hash.size == text.size());
+            CHECK(hash == hashText(text));
+            CHECK(hash != hashText(text.substr(1u)));
+        }
+
+        TEST_CASE("IOUtilsTest.hashWrittenCRLFText", "[IOUtilsTest]") {
+            TestEnvironment env("io_utils_test");
+            const auto path = env.dir() + Path("crlf.map");
+
+            auto hash = TextHash{};
+            {
+                std::ofstream fileStream = openPathAsOutputStream(path, std::ios::out | std::ios::binary);
+                REQUIRE(fileStream);
+
+                HashingOutputStream stream(fileStream);
+                stream << "// entity 0\r\n{\r\n\"classname\" \"worldspawn\"\r\n}\r\n";
+                stream.flush();
+                hash = stream.hash();
+            }
+
+            // the line endings must be written unchanged, otherwise the hash does not match the file
+            const auto file = Disk::openFile(path);
+            const auto reader = file->reader().buffer();
+            const auto text = reader.stringView();
+            CHECK(text == "// entity 0\r\n{\r\n\"classname\" \"worldspawn\"\r\n}\r\n");
+            CHECK(hashText(text) == hash);
+        }
+    }
+}
@@ -50,6 +50,10 @@ namespace TrenchBroom {
 
             ASSERT_TRUE(fs.fileExists(Path("gfx/palette.lmp")));
             ASSERT_TRUE(fs.fileExists(Path("GFX/Palette.LMP")));
+            ASSERT_TRUE(fs.fileExists(Path("./gfx/../GFX/palette.lmp")));
+            ASSERT_FALSE(fs.fileExists(Path("gfx")));
+            ASSERT_FALSE(fs.fileExists(Path("palette.lmp")));
+            ASSERT_THROW(fs.fileExists(Path("../gfx/palette.lmp")), FileSystemException);
         }
 
         TEST_CASE("IdPakFileSystemTest.findItems", "[IdPakFileSystemTest]") {
@@ -138,6 +142,8 @@ namespace TrenchBroom {
             ASSERT_THROW(fs.openFile(Path("/textures")), FileSystemException);
 
             ASSERT_TRUE(fs.openFile(Path("amnet.cfg")) != nullptr);
+            ASSERT_TRUE(fs.openFile(Path("AMNET.CFG")) != nullptr);
+            ASSERT_TRUE(fs.openFile(Path("pics/../textures/e1u1/BRLAVA.wal")) != nullptr);
         }
     }
 }
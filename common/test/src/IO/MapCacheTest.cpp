@@ -0,0 +1,240 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/MapCache.h"
+#include "IO/NodeWriter.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::string ValveMap = R"(// entity 0
+{
+"classname" "worldspawn"
+"mapversion" "220"
+// brush 0
+{
+( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) rock [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) rock [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) rock [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) rock [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) rock [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) rock [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Layer 1"
+"_tb_id" "1"
+"_tb_layer_sort_index" "0"
+"_tb_layer_hidden" "1"
+}
+// entity 2
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 1"
+"_tb_id" "2"
+"_tb_layer" "1"
+}
+// entity 3
+{
+"classname" "func_door"
+"_tb_group" "2"
+// brush 0
+{
+( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) metal [ 0 -1 0 16 ] [ 0 0 -1 8 ] 45 0.5 2
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) metal [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) metal [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 16 8 ) ( 64 17 8 ) ( 65 16 8 ) metal [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 16 8 ) ( 65 16 8 ) ( 64 16 9 ) metal [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 16 8 ) ( 64 16 9 ) ( 64 17 8 ) metal [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+// entity 4
+{
+"classname" "light"
+"origin" "16 16 16"
+}
+)";
+
+        static const std::string Quake2Map = R"(// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) e1u1/floor 0 0 0 1 1 1 2 3.5
+( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) e1u1/floor 16 8 90 0.5 0.5 0 0 0
+( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) e1u1/floor 0 0 0 1 1 0 0 0
+( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) e1u1/floor 0 0 0 1 1 0 0 0
+( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) e1u1/floor 0 0 0 1 1 0 0 0
+( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) e1u1/floor 0 0 0 1 1 0 0 0
+}
+}
+)";
+
+        static std::string writeWorld(const Model::WorldNode& world) {
+            std::stringstream str;
+            NodeWriter writer(world, str);
+            writer.writeMap();
+            return str.str();
+        }
+
+        static void checkNodesEqual(const Model::Node* expected, const Model::Node* actual) {
+            REQUIRE(actual->childCount() == expected->childCount());
+            CHECK(actual->lineNumber() == expected->lineNumber());
+            CHECK(actual->lineCount() == expected->lineCount());
+            CHECK(actual->visibilityState() == expected->visibilityState());
+            CHECK(actual->lockState() == expected->lockState());
+
+            const auto* expectedBrush = dynamic_cast<const Model::BrushNode*>(expected);
+            const auto* actualBrush = dynamic_cast<const Model::BrushNode*>(actual);
+            REQUIRE((expectedBrush == nullptr) == (actualBrush == nullptr));
+            if (expectedBrush != nullptr) {
+                CHECK(actualBrush->brush().vertexPositions() == expectedBrush->brush().vertexPositions());
+                CHECK(actualBrush->logicalBounds() == expectedBrush->logicalBounds());
+                CHECK(actualBrush->brush().fullySpecified());
+
+                REQUIRE(actualBrush->brush().faceCount() == expectedBrush->brush().faceCount());
+                for (size_t i = 0u; i < expectedBrush->brush().faceCount(); ++i) {
+                    const auto& expectedFace = expectedBrush->brush().face(i);
+                    const auto& actualFace = actualBrush->brush().face(i);
+                    CHECK(actualFace.vertexPositions() == expectedFace.vertexPositions());
+                    CHECK(actualFace.lineNumber() == expectedFace.lineNumber());
+                }
+            }
+
+            for (size_t i = 0u; i < expected->childCount(); ++i) {
+                checkNodesEqual(expected->children()[i], actual->children()[i]);
+            }
+        }
+
+        static void checkCachedWorld(const std::string& data, const Model::MapFormat format) {
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = MapCache::cachePath(env.dir() + Path("test.map"));
+            CHECK(cachePath == env.dir() + Path("test.map.tbcache"));
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader reader(data);
+            auto world = reader.read(format, worldBounds, status);
+            REQUIRE(world != nullptr);
+
+            MapCache::writeWorld(cachePath, *world, data, "Quake", worldBounds);
+            REQUIRE(Disk::fileExists(cachePath));
+
+            auto cachedWorld = MapCache::readWorld(cachePath, data, "Quake", format, worldBounds);
+            REQUIRE(cachedWorld != nullptr);
+            CHECK(cachedWorld->format() == format);
+            CHECK(writeWorld(*cachedWorld) == writeWorld(*world));
+            checkNodesEqual(world.get(), cachedWorld.get());
+
+            // the cache is only valid for the map text, game, format and world bounds it was written for
+            CHECK(MapCache::readWorld(cachePath, data + "\n", "Quake", format, worldBounds) == nullptr);
+            CHECK(MapCache::readWorld(cachePath, data, "Quake 2", format, worldBounds) == nullptr);
+            CHECK(MapCache::readWorld(cachePath, data, "Quake", Model::MapFormat::Quake3, worldBounds) == nullptr);
+            CHECK(MapCache::readWorld(cachePath, data, "Quake", format, vm::bbox3(4096.0)) == nullptr);
+            CHECK(MapCache::readWorld(env.dir() + Path("missing.tbcache"), data, "Quake", format, worldBounds) == nullptr);
+        }
+
+        TEST_CASE("MapCacheTest.readValveWorld", "[MapCacheTest]") {
+            checkCachedWorld(ValveMap, Model::MapFormat::Valve);
+        }
+
+        TEST_CASE("MapCacheTest.readQuake2World", "[MapCacheTest]") {
+            checkCachedWorld(Quake2Map, Model::MapFormat::Quake2);
+        }
+
+        TEST_CASE("MapCacheTest.readDamagedCache", "[MapCacheTest]") {
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = env.dir() + Path("test.map.tbcache");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader reader(ValveMap);
+            auto world = reader.read(Model::MapFormat::Valve, worldBounds, status);
+            MapCache::writeWorld(cachePath, *world, ValveMap, "Quake", worldBounds);
+
+            // truncate the cache file
+            const auto contents = Disk::readTextFile(cachePath);
+            {
+                auto stream = openPathAsOutputStream(cachePath, std::ios::out | std::ios::binary);
+                stream.write(contents.data(), static_cast<std::streamsize>(contents.size() / 2u));
+            }
+
+            CHECK(MapCache::readWorld(cachePath, ValveMap, "Quake", Model::MapFormat::Valve, worldBounds) == nullptr);
+        }
+
+        TEST_CASE("MapCacheTest.readModifiedCache", "[MapCacheTest]") {
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = env.dir() + Path("test.map.tbcache");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader reader(ValveMap);
+            auto world = reader.read(Model::MapFormat::Valve, worldBounds, status);
+            MapCache::writeWorld(cachePath, *world, ValveMap, "Quake", worldBounds);
+            REQUIRE(MapCache::readWorld(cachePath, ValveMap, "Quake", Model::MapFormat::Valve, worldBounds) != nullptr);
+
+            // change a texture name, which leaves the structure of the cache file intact
+            auto contents = [&]() {
+                const auto file = Disk::openFile(cachePath);
+                const auto fileReader = file->reader().buffer();
+                return std::string(fileReader.stringView());
+            }();
+
+            const auto textureName = contents.find("rock");
+            REQUIRE(textureName != std::string::npos);
+            contents[textureName + 1u] = 'a';
+
+            {
+                auto stream = openPathAsOutputStream(cachePath, std::ios::out | std::ios::binary);
+                stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            }
+
+            CHECK(MapCache::readWorld(cachePath, ValveMap, "Quake", Model::MapFormat::Valve, worldBounds) == nullptr);
+        }
+    }
+}
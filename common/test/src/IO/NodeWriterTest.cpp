@@ -18,6 +18,7 @@
  */
 
 #include "Exceptions.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/NodeWriter.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushBuilder.h"
@@ -34,9 +35,12 @@
 
 #include <kdl/result.h>
 #include <kdl/string_compare.h>
+#include <kdl/string_utils.h>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include "Catch2.h"
@@ -257,6 +261,180 @@ R"(// entity 0
             ASSERT_EQ(expected, actual);
         }
 
+        TEST_CASE("NodeWriterTest.writeWorldspawnWithManyBrushes", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::WorldNode map(Model::Entity(), Model::MapFormat::Standard);
+
+            // enough brushes to fill several chunks of the serializer
+            const size_t brushCount = 5000u;
+            std::vector<Model::BrushNode*> brushNodes;
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            for (size_t i = 0u; i < brushCount; ++i) {
+                Model::BrushNode* brushNode = map.createBrush(builder.createCube(64.0, "none").value());
+                map.defaultLayer()->addChild(brushNode);
+                brushNodes.push_back(brushNode);
+            }
+
+            std::stringstream str;
+            NodeWriter writer(map, str);
+            writer.writeMap();
+
+            std::string expected = "// entity 0\n{\n\"classname\" \"worldspawn\"\n";
+            for (size_t i = 0u; i < brushCount; ++i) {
+                expected += "// brush " + std::to_string(i) + "\n";
+                expected +=
+R"({
+( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0 0 0 1 1
+( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) none 0 0 0 1 1
+( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) none 0 0 0 1 1
+( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) none 0 0 0 1 1
+( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) none 0 0 0 1 1
+( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) none 0 0 0 1 1
+}
+)";
+            }
+            expected += "}\n";
+
+            const std::string actual = str.str();
+            CHECK(actual == expected);
+
+            for (size_t i = 0u; i < brushCount; ++i) {
+                CHECK(brushNodes[i]->lineNumber() == 5u + 9u * i);
+                CHECK(brushNodes[i]->lineCount() == 8u);
+            }
+        }
+
+        TEST_CASE("NodeWriterTest.writeBrushFilePositions", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::WorldNode map(Model::Entity(), Model::MapFormat::Standard);
+            Model::BrushBuilder builder(&map, worldBounds);
+
+            std::vector<Model::BrushNode*> brushNodes;
+            for (size_t i = 0u; i < 3u; ++i) {
+                Model::BrushNode* brushNode = map.createBrush(builder.createCube(64.0, "none").value());
+                map.defaultLayer()->addChild(brushNode);
+                brushNodes.push_back(brushNode);
+            }
+
+            Model::EntityNode* doorNode = map.createEntity(Model::Entity({
+                {"classname", "func_door"}
+            }));
+            map.defaultLayer()->addChild(doorNode);
+            for (size_t i = 0u; i < 2u; ++i) {
+                Model::BrushNode* brushNode = map.createBrush(builder.createCube(64.0, "none").value());
+                doorNode->addChild(brushNode);
+                brushNodes.push_back(brushNode);
+            }
+
+            Model::EntityNode* lightNode = map.createEntity(Model::Entity({
+                {"classname", "light"}
+            }));
+            map.defaultLayer()->addChild(lightNode);
+
+            std::stringstream str;
+            NodeWriter writer(map, str);
+            writer.writeMap();
+
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(str, line)) {
+                lines.push_back(line);
+            }
+
+            // the lines of the faces must be counted, otherwise every following node is placed too early
+            const std::vector<size_t> expectedLineNumbers = { 5u, 14u, 23u, 36u, 45u };
+            for (size_t i = 0u; i < brushNodes.size(); ++i) {
+                const auto* brushNode = brushNodes[i];
+                CHECK(brushNode->lineNumber() == expectedLineNumbers[i]);
+                CHECK(brushNode->lineCount() == 8u);
+                CHECK(lines[brushNode->lineNumber() - 1u] == "{");
+                CHECK(lines[brushNode->lineNumber() + brushNode->lineCount() - 2u] == "}");
+
+                for (size_t j = 0u; j < brushNode->brush().faceCount(); ++j) {
+                    const auto& face = brushNode->brush().face(j);
+                    CHECK(face.lineNumber() == brushNode->lineNumber() + 1u + j);
+                    CHECK(face.lineCount() == 1u);
+                }
+            }
+
+            CHECK(doorNode->lineNumber() == 33u);
+            CHECK(doorNode->lineCount() == 21u);
+            CHECK(lines[doorNode->lineNumber()] == "\"classname\" \"func_door\"");
+
+            CHECK(lightNode->lineNumber() == 55u);
+            CHECK(lightNode->lineCount() == 3u);
+            CHECK(lines[lightNode->lineNumber()] == "\"classname\" \"light\"");
+        }
+
+        TEST_CASE("NodeWriterTest.writeMapIncrementally", "[NodeWriterTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::WorldNode map(Model::Entity(), Model::MapFormat::Standard);
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::BrushNode* brushNode1 = map.createBrush(builder.createCube(64.0, "none").value());
+            Model::BrushNode* brushNode2 = map.createBrush(builder.createCube(64.0, "none").value());
+            map.defaultLayer()->addChild(brushNode1);
+            map.defaultLayer()->addChild(brushNode2);
+
+            Model::EntityNode* entityNode = map.createEntity(Model::Entity({
+                {"classname", "light"}
+            }));
+            map.defaultLayer()->addChild(entityNode);
+
+            std::stringstream str;
+            NodeWriter writer(map, str);
+            writer.writeMap();
+
+            const std::string previous = str.str();
+
+            // change the previous text to see which parts of it are copied
+            const auto brush2Start = previous.find("// brush 1");
+            const auto entityStart = previous.find("// entity 1");
+            const std::string changedPrevious =
+                previous.substr(0u, brush2Start) +
+                kdl::str_replace_every(previous.substr(brush2Start, entityStart - brush2Start), "none", "old") +
+                kdl::str_replace_every(previous.substr(entityStart), "light", "old_light");
+
+            const auto writeIncrementally = [&](const std::string& previousText, const std::vector<const Model::Node*>& modifiedNodes) {
+                std::stringstream incrementalStr;
+                const auto isModified = [&](const Model::Node* node) {
+                    return std::find(std::begin(modifiedNodes), std::end(modifiedNodes), node) != std::end(modifiedNodes);
+                };
+                NodeWriter incrementalWriter(map, MapFileSerializer::create(map.format(), incrementalStr, PreviousMapFile{previousText, isModified}));
+                incrementalWriter.writeMap();
+                return incrementalStr.str();
+            };
+
+            SECTION("Nothing modified") {
+                CHECK(writeIncrementally(previous, {}) == previous);
+                CHECK(writeIncrementally(changedPrevious, {}) == changedPrevious);
+            }
+
+            SECTION("Brush modified") {
+                // the world is written again, but only the modified brush is formatted
+                CHECK(writeIncrementally(changedPrevious, {&map, brushNode1}) == changedPrevious);
+                CHECK(writeIncrementally(changedPrevious, {&map, brushNode2}) == kdl::str_replace_every(changedPrevious, "old 0", "none 0"));
+                CHECK(brushNode2->lineNumber() == 14u);
+                CHECK(brushNode2->lineCount() == 8u);
+                CHECK(brushNode2->brush().face(0u).lineNumber() == 15u);
+            }
+
+            SECTION("Entity modified") {
+                const auto result = writeIncrementally(changedPrevious, {entityNode});
+                CHECK(result == kdl::str_replace_every(changedPrevious, "old_light", "light"));
+                CHECK(entityNode->lineNumber() == 24u);
+                CHECK(entityNode->lineCount() == 3u);
+            }
+
+            SECTION("Previous text does not match") {
+                CHECK(writeIncrementally(previous.substr(0u, previous.size() / 2u), {}) == previous);
+            }
+        }
+
         TEST_CASE("NodeWriterTest.writeWorldspawnWithBrushInCustomLayer", "[NodeWriterTest]") {
             const vm::bbox3 worldBounds(8192.0);
 
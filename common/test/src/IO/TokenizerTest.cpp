@@ -20,6 +20,8 @@
 #include "IO/Token.h"
 #include "IO/Tokenizer.h"
 
+#include <cmath>
+#include <limits>
 #include <string>
 
 #include "Catch2.h"
@@ -241,5 +243,23 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+
+        TEST_CASE("TokenizerTest.tokenToFloat", "[TokenizerTest]") {
+            using Token = SimpleTokenizer::Token;
+            const auto toFloat = [](const std::string& str) {
+                return Token(SimpleToken::Decimal, str.data(), str.data() + str.size(), 0u, 1u, 1u).toFloat<double>();
+            };
+
+            CHECK(toFloat("12328.38283") == 12328.38283);
+            CHECK(toFloat("-1e-3") == -0.001);
+            CHECK(toFloat("1.5abc") == 1.5);
+            CHECK(toFloat("abc") == 0.0);
+            CHECK(toFloat("1e999") == 0.0);
+
+            // these are not supported by kdl::from_chars, but were accepted by std::stod before
+            CHECK(toFloat("0x1p3") == 8.0);
+            CHECK(toFloat("-inf") == -std::numeric_limits<double>::infinity());
+            CHECK(std::isnan(toFloat("nan")));
+        }
     }
 }
@@ -17,8 +17,13 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Exceptions.h"
 #include "Logger.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
 #include "IO/WadFileSystem.h"
 
 #include <kdl/vector_utils.h>
@@ -57,5 +62,20 @@ namespace TrenchBroom {
             ASSERT_TRUE(kdl::vec_contains(files, IO::Path("speedM_1.D")));
             ASSERT_TRUE(kdl::vec_contains(files, IO::Path("u_get_this.D")));
         }
+
+        TEST_CASE("WadFileSystemTest.truncateWadFile", "[WadFileSystemTest]") {
+            TestEnvironment env("wad_file_system_test");
+            Disk::copyFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad"), env.dir(), false);
+
+            const auto wadPath = env.dir() + Path("cr8_czg.wad");
+            NullLogger logger;
+            WadFileSystem fs(wadPath, logger);
+            REQUIRE(fs.fileExists(Path("cr8_czg_1.D")));
+
+            // truncate the wad file like a texture tool that rebuilds it, the file system must not keep it mapped
+            openPathAsOutputStream(wadPath, std::ios::out | std::ios::binary | std::ios::trunc).close();
+
+            CHECK_THROWS_AS(fs.openFile(Path("cr8_czg_1.D"))->reader(), ReaderException);
+        }
     }
 }
@@ -30,9 +30,13 @@
 #include "Model/ParallelTexCoordSystem.h"
 #include "Model/WorldNode.h"
 
+#include <kdl/thread_pool.h>
+
 #include <vecmath/vec.h>
 
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "Catch2.h"
 #include "GTestCompat.h"
@@ -1409,5 +1413,201 @@ common/caulk
                 CHECK(face.attributes().textureName() == Model::BrushFaceAttributes::NoTextureName);
             }
         }
+
+        TEST_CASE("WorldReaderTest.parseBrushesInFileOrderAndReportErrors", "[WorldReaderTest]") {
+            const std::string data(R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) brush0 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) brush0 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) brush0 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) brush0 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) brush0 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) brush0 0 0 0 1 1
+}
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) incomplete 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) incomplete 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) incomplete 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) incomplete 0 0 0 1 1
+}
+{
+( -32 -32 -16 ) ( -32 -31 -16 ) ( -32 -32 -15 ) brush1 0 0 0 1 1
+( -32 -32 -16 ) ( -32 -32 -15 ) ( -31 -32 -16 ) brush1 0 0 0 1 1
+( -32 -32 -16 ) ( -31 -32 -16 ) ( -32 -31 -16 ) brush1 0 0 0 1 1
+( 32 32 16 ) ( 32 33 16 ) ( 33 32 16 ) brush1 0 0 0 1 1
+( 32 32 16 ) ( 33 32 16 ) ( 32 32 17 ) brush1 0 0 0 1 1
+( 32 32 16 ) ( 32 32 17 ) ( 32 33 16 ) brush1 0 0 0 1 1
+}
+{
+( -32 -32 -16 ) ( -32 -31 -16 ) ( -32 -32 -15 ) incomplete 0 0 0 1 1
+( -32 -32 -16 ) ( -32 -32 -15 ) ( -31 -32 -16 ) incomplete 0 0 0 1 1
+( -32 -32 -16 ) ( -31 -32 -16 ) ( -32 -31 -16 ) incomplete 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+"origin" "0 0 0"
+}
+)");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data);
+
+            auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            REQUIRE(world != nullptr);
+            REQUIRE(world->childCount() == 1u);
+
+            const auto* defaultLayer = world->defaultLayer();
+            REQUIRE(defaultLayer->childCount() == 3u);
+
+            const auto* brush0 = dynamic_cast<const Model::BrushNode*>(defaultLayer->children()[0]);
+            REQUIRE(brush0 != nullptr);
+            CHECK(brush0->brush().face(0u).attributes().textureName() == "brush0");
+            CHECK(brush0->lineNumber() == 4u);
+
+            const auto* brush1 = dynamic_cast<const Model::BrushNode*>(defaultLayer->children()[1]);
+            REQUIRE(brush1 != nullptr);
+            CHECK(brush1->brush().face(0u).attributes().textureName() == "brush1");
+            CHECK(brush1->lineNumber() == 18u);
+
+            CHECK(dynamic_cast<const Model::EntityNode*>(defaultLayer->children()[2]) != nullptr);
+
+            const auto& errors = status.messages(LogLevel::Error);
+            REQUIRE(errors.size() == 2u);
+            CHECK(errors[0].find("Skipping brush") != std::string::npos);
+            CHECK(errors[0].find("(line 12)") != std::string::npos);
+            CHECK(errors[1].find("(line 26)") != std::string::npos);
+        }
+
+        TEST_CASE("WorldReaderTest.reportBrushAndFaceErrorsInFileOrder", "[WorldReaderTest]") {
+            const std::string data(R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) incomplete 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) incomplete 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) incomplete 0 0 0 1 1
+}
+{
+( 0 0 0 ) ( 1 0 0 ) ( 2 0 0 ) colinear 0 0 0 1 1
+}
+}
+)");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data);
+
+            auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            REQUIRE(world != nullptr);
+
+            // the error of the first brush is logged before the face error that was found while parsing the second brush
+            const auto& errors = status.messages(LogLevel::Error);
+            REQUIRE(errors.size() >= 2u);
+            CHECK(errors[0].find("Skipping brush") != std::string::npos);
+            CHECK(errors[0].find("(line 4)") != std::string::npos);
+            CHECK(errors[1].find("Skipping face") != std::string::npos);
+            CHECK(errors[1].find("(line 10)") != std::string::npos);
+        }
+
+        static std::string makeLargeMap(const size_t entityCount, std::vector<size_t>& entityLines, std::vector<size_t>& duplicateLines) {
+            std::stringstream str;
+            size_t line = 1u;
+            for (size_t i = 0u; i < entityCount; ++i) {
+                entityLines.push_back(line);
+                str << "{\n" << (i == 0u ? "\"classname\" \"worldspawn\"\n" : "\"classname\" \"func_wall\"\n");
+                line += 2u;
+                if (i % 100u == 1u) {
+                    str << "\"target\" \"a\"\n\"target\" \"b\"\n";
+                    duplicateLines.push_back(line + 1u);
+                    line += 2u;
+                }
+                str << "{\n";
+                str << "( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) {fence 0 0 0 1 1\n";
+                str << "( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) {fence 0 0 0 1 1\n";
+                str << "( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) {fence 0 0 0 1 1\n";
+                str << "( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) {fence 0 0 0 1 1\n";
+                str << "( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) {fence 0 0 0 1 1\n";
+                str << "( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) {fence 0 0 0 1 1\n";
+                str << "}\n}\n";
+                line += 9u;
+            }
+            return str.str();
+        }
+
+        TEST_CASE("WorldReaderTest.parseLargeMapConcurrently", "[WorldReaderTest]") {
+            // the map must be large enough to be split into several chunks
+            std::vector<size_t> entityLines;
+            std::vector<size_t> duplicateLines;
+            const auto data = makeLargeMap(2000u, entityLines, duplicateLines);
+            REQUIRE(data.size() > 512u * 1024u);
+
+            kdl::thread_pool pool(4u);
+            kdl::scoped_default_thread_pool defaultPool(pool);
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data);
+
+            auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            REQUIRE(world != nullptr);
+            CHECK(world->lineNumber() == 1u);
+
+            const auto* defaultLayer = world->defaultLayer();
+            REQUIRE(defaultLayer->childCount() == entityLines.size());
+            CHECK(defaultLayer->children()[0]->lineNumber() == 3u);
+
+            for (size_t i = 1u; i < entityLines.size(); ++i) {
+                const auto* entityNode = dynamic_cast<const Model::EntityNode*>(defaultLayer->children()[i]);
+                REQUIRE(entityNode != nullptr);
+                CHECK(entityNode->lineNumber() == entityLines[i]);
+
+                REQUIRE(entityNode->childCount() == 1u);
+                const auto* brushNode = dynamic_cast<const Model::BrushNode*>(entityNode->children().front());
+                REQUIRE(brushNode != nullptr);
+                CHECK(brushNode->brush().face(0u).attributes().textureName() == "{fence");
+            }
+
+            const auto& warnings = status.messages(LogLevel::Warn);
+            REQUIRE(warnings.size() == duplicateLines.size());
+            for (size_t i = 0u; i < warnings.size(); ++i) {
+                CHECK(warnings[i].find("(line " + std::to_string(duplicateLines[i]) + ",") != std::string::npos);
+            }
+        }
+
+        TEST_CASE("WorldReaderTest.parseLargeMapConcurrentlyWithError", "[WorldReaderTest]") {
+            std::vector<size_t> entityLines;
+            std::vector<size_t> duplicateLines;
+            auto data = makeLargeMap(2000u, entityLines, duplicateLines);
+
+            // replace the first face of the brush of entity 1500 with garbage
+            const auto errorLine = entityLines[1500u] + 3u;
+            auto lineBegin = size_t(0u);
+            for (size_t line = 1u; line < errorLine; ++line) {
+                lineBegin = data.find('\n', lineBegin) + 1u;
+            }
+            data.replace(lineBegin, 2u, "x ");
+
+            kdl::thread_pool pool(4u);
+            kdl::scoped_default_thread_pool defaultPool(pool);
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data);
+
+            try {
+                reader.read(Model::MapFormat::Standard, worldBounds, status);
+                FAIL("expected a parser exception");
+            } catch (const ParserException& e) {
+                CHECK(std::string(e.what()).find("line " + std::to_string(errorLine) + ",") != std::string::npos);
+            }
+        }
     }
 }
@@ -20,11 +20,14 @@
 #include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/Reader.h"
 #include "IO/ZipFileSystem.h"
 
 #include <algorithm>
 #include <cassert>
+#include <vector>
 
 #include "Catch2.h"
 #include "GTestCompat.h"
@@ -141,5 +144,32 @@ namespace TrenchBroom {
 
             ASSERT_TRUE(fs.openFile(Path("amnet.cfg")) != nullptr);
         }
+
+        TEST_CASE("ZipFileSystemTest.openFiles", "[ZipFileSystemTest]") {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const ZipFileSystem fs(zipPath);
+            const auto paths = std::vector<Path>{
+                Path("textures/e1u1/box1_3.wal"),
+                Path("does_not_exist.cfg"),
+                Path("amnet.cfg"),
+                Path("textures/e1u3/stflr1_5.wal"),
+            };
+
+            const auto files = fs.openFiles(paths);
+            ASSERT_EQ(paths.size(), files.size());
+            ASSERT_TRUE(files[1] == nullptr);
+
+            for (const size_t i : { 0u, 2u, 3u }) {
+                ASSERT_TRUE(files[i] != nullptr);
+                ASSERT_EQ(paths[i], files[i]->path());
+
+                // the files opened in parallel must have the same contents as the files opened one by one
+                const auto file = fs.openFile(paths[i]);
+                const auto expected = file->reader().buffer();
+                const auto actual = files[i]->reader().buffer();
+                ASSERT_EQ(expected.stringView(), actual.stringView());
+            }
+        }
     }
 }
@@ -60,7 +60,7 @@ namespace TrenchBroom {
             const vm::vec3 p2(0.0, -1.0, 4.0);
 
             const BrushFaceAttributes attribs("");
-            BrushFace face = BrushFace::create(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)).value();
+            BrushFace face = BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).value();
             ASSERT_VEC_EQ(p0, face.points()[0]);
             ASSERT_VEC_EQ(p1, face.points()[1]);
             ASSERT_VEC_EQ(p2, face.points()[2]);
@@ -74,7 +74,26 @@ namespace TrenchBroom {
             const vm::vec3 p2(2.0, 0.0, 4.0);
 
             const BrushFaceAttributes attribs("");
-            CHECK_FALSE(BrushFace::create(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)).is_success());
+            CHECK_FALSE(BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).is_success());
+        }
+
+        TEST_CASE("BrushFaceTest.copyTexCoordSystem", "[BrushFaceTest]") {
+            const vm::vec3 p0(0.0,  0.0, 4.0);
+            const vm::vec3 p1(1.0,  0.0, 4.0);
+            const vm::vec3 p2(0.0, -1.0, 4.0);
+
+            const BrushFaceAttributes attribs("");
+            const BrushFace face = BrushFace::create(p0, p1, p2, attribs, ParallelTexCoordSystem(p0, p1, p2, attribs)).value();
+
+            BrushFace copy = face;
+            CHECK(dynamic_cast<const ParallelTexCoordSystem*>(&copy.texCoordSystem()) != nullptr);
+            CHECK(&copy.texCoordSystem() != &face.texCoordSystem());
+            CHECK(copy.texCoordSystem() == face.texCoordSystem());
+
+            const auto xAxis = face.textureXAxis();
+            copy.rotateTexture(45.0f);
+            CHECK(copy.textureXAxis() != xAxis);
+            CHECK(face.textureXAxis() == xAxis);
         }
 
         TEST_CASE("BrushFaceTest.textureUsageCount", "[BrushFaceTest]") {
@@ -90,7 +109,7 @@ namespace TrenchBroom {
             BrushFaceAttributes attribs("");
             {
                 // test constructor
-                BrushFace face = BrushFace::create(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)).value();
+                BrushFace face = BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).value();
                 EXPECT_EQ(0u, texture.usageCount());
 
                 // test setTexture
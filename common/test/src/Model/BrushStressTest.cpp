@@ -0,0 +1,114 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloatType.h"
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/parallel.h>
+#include <kdl/result.h>
+#include <kdl/thread_pool.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <numeric>
+#include <vector>
+
+#include "Catch2.h"
+#include "TestUtils.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        struct BrushOperationsResult {
+            Brush brush;
+            std::vector<Brush> fragments;
+        };
+
+        /*
+         * Runs the geometric brush operations on many threads at once. Every task creates its own brushes, but all
+         * tasks read the same source brushes and refer to the same texture. Run this with ThreadSanitizer to detect
+         * data races.
+         */
+        TEST_CASE("BrushStressTest.concurrentBrushOperations", "[BrushStressTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(Entity(), MapFormat::Standard);
+            BrushBuilder builder(&world, worldBounds);
+
+            Assets::Texture texture("texture", 16, 16);
+            const auto setTexture = [&](Brush brush) {
+                for (auto& face : brush.faces()) {
+                    face.setTexture(&texture);
+                }
+                return brush;
+            };
+
+            const Brush cube = setTexture(builder.createCube(32.0, "texture").value());
+            const Brush subtrahend = setTexture(builder.createCuboid(vm::bbox3(vm::vec3(-8.0, -8.0, -32.0), vm::vec3(8.0, 8.0, 0.0)), "texture").value());
+            const BrushFace clipFace = createParaxial(
+                vm::vec3(8.0, 0.0, 0.0),
+                vm::vec3(8.0, 0.0, 1.0),
+                vm::vec3(8.0, 1.0, 0.0));
+            const auto initialUsageCount = texture.usageCount();
+
+            constexpr size_t Variants = 8u;
+            const auto runOperations = [&](const size_t i) {
+                const auto offset = static_cast<FloatType>(i % Variants);
+
+                Brush brush = Brush::create(worldBounds, cube.faces()).value();
+                brush = brush.transform(worldBounds, vm::translation_matrix(vm::vec3(offset, 0.0, 0.0)), true).value();
+                brush = brush.clip(worldBounds, clipFace).value();
+                brush = brush.moveVertices(worldBounds, { vm::vec3(offset - 16.0, -16.0, -16.0) }, vm::vec3(-4.0, -4.0, -4.0)).value();
+                brush = brush.intersect(worldBounds, cube).value();
+                auto fragments = brush.subtract(world, worldBounds, "texture", subtrahend).value();
+
+                return BrushOperationsResult{std::move(brush), std::move(fragments)};
+            };
+
+            std::vector<BrushOperationsResult> expected;
+            for (size_t i = 0u; i < Variants; ++i) {
+                expected.push_back(runOperations(i));
+            }
+
+            std::vector<size_t> tasks(512u);
+            std::iota(std::begin(tasks), std::end(tasks), 0u);
+
+            kdl::thread_pool pool(4u);
+            auto actual = kdl::vec_parallel_transform(pool, tasks, runOperations);
+
+            REQUIRE(actual.size() == tasks.size());
+            for (size_t i = 0u; i < actual.size(); ++i) {
+                CHECK(actual[i].brush == expected[i % Variants].brush);
+                CHECK(actual[i].fragments == expected[i % Variants].fragments);
+            }
+
+            actual.clear();
+            expected.clear();
+            CHECK(texture.usageCount() == initialUsageCount);
+        }
+    }
+}
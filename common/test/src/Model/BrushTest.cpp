@@ -138,6 +138,50 @@ namespace TrenchBroom {
          Replace: faces.push_back(createParaxial(vm::vec3($1, $2, $3), vm::vec3($4, $5, $6), vm::vec3($7, $8, $9)));
          */
 
+        TEST_CASE("BrushTest.createFromTopology", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(Entity(), MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            // a wedge with triangular and quadrilateral faces
+            const Brush original = builder.createBrush(std::vector<vm::vec3>{vm::vec3(64, -64, 16), vm::vec3(64, 64, 16), vm::vec3(64, -64, -16), vm::vec3(64, 64, -16), vm::vec3(48, 64, 16), vm::vec3(48, 64, -16)}, "texture").value();
+
+            std::vector<vm::vec3> vertices;
+            std::vector<const BrushVertex*> vertexPointers;
+            for (const BrushVertex* vertex : original.vertices()) {
+                vertices.push_back(vertex->position());
+                vertexPointers.push_back(vertex);
+            }
+
+            std::vector<std::vector<size_t>> faceVertices;
+            for (const BrushFace& face : original.faces()) {
+                std::vector<size_t> indices;
+                for (const BrushHalfEdge* halfEdge : face.geometry()->boundary()) {
+                    indices.push_back(*kdl::vec_index_of(vertexPointers, halfEdge->origin()));
+                }
+                faceVertices.push_back(std::move(indices));
+            }
+
+            const Brush brush = Brush::createFromTopology(original.faces(), vertices, faceVertices).value();
+            CHECK(brush.fullySpecified());
+            CHECK(brush.bounds() == original.bounds());
+            CHECK(brush.vertexPositions() == original.vertexPositions());
+            CHECK(brush.edgeCount() == original.edgeCount());
+            for (size_t i = 0u; i < original.faceCount(); ++i) {
+                CHECK(brush.face(i).vertexPositions() == original.face(i).vertexPositions());
+            }
+
+            // an open polyhedron is rejected
+            auto openFaceVertices = faceVertices;
+            openFaceVertices.back().pop_back();
+            CHECK(Brush::createFromTopology(original.faces(), vertices, openFaceVertices).is_error());
+
+            // so is a topology that doesn't have a boundary for every face
+            auto missingFaceVertices = faceVertices;
+            missingFaceVertices.pop_back();
+            CHECK(Brush::createFromTopology(original.faces(), vertices, missingFaceVertices).is_error());
+        }
+
         TEST_CASE("BrushTest.constructWithFailingFaces", "[BrushTest]") {
             /* from rtz_q1
              {
@@ -499,6 +543,66 @@ namespace TrenchBroom {
             EXPECT_COLLECTIONS_EQUIVALENT(expandedBBox.vertices(), brush1.vertexPositions());
         }
 
+        TEST_CASE("BrushTest.translateMatchesGeneralTransform", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(Entity(), MapFormat::Valve);
+            const BrushBuilder builder(&world, worldBounds);
+
+            const std::vector<Brush> brushes {
+                builder.createCuboid(vm::bbox3(vm::vec3(-64, -32, -16), vm::vec3(64, 32, 16)), "texture").value(),
+                builder.createBrush(std::vector<vm::vec3>{vm::vec3(0, 0, 0), vm::vec3(32, 7, 0), vm::vec3(5, 29, 3), vm::vec3(11, 13, 41)}, "texture").value(),
+            };
+
+            const std::vector<vm::vec3> deltas {
+                vm::vec3(16, -32, 8),
+                vm::vec3(0.5, 1.25, -3.0),
+            };
+
+            for (const auto& brush : brushes) {
+                for (const auto& delta : deltas) {
+                    for (const bool lockTextures : { false, true }) {
+                        const auto translation = vm::translation_matrix(delta);
+
+                        // build the expected brush from the transformed faces like the general transformation does
+                        auto faces = brush.faces();
+                        for (auto& face : faces) {
+                            REQUIRE(face.transform(translation, lockTextures).is_success());
+                        }
+                        const Brush expected = Brush::create(worldBounds, faces).value();
+                        const Brush actual = brush.transform(worldBounds, translation, lockTextures).value();
+
+                        CHECK(actual.fullySpecified());
+                        CHECK(vm::is_equal(expected.bounds().min, actual.bounds().min, vm::C::almost_zero()));
+                        CHECK(vm::is_equal(expected.bounds().max, actual.bounds().max, vm::C::almost_zero()));
+
+                        REQUIRE(actual.faceCount() == expected.faceCount());
+                        for (const auto& expectedFace : expected.faces()) {
+                            const auto actualFaceIndex = actual.findFace(expectedFace.boundary());
+                            REQUIRE(actualFaceIndex);
+                            CHECK(actual.face(*actualFaceIndex) == expectedFace);
+                        }
+
+                        REQUIRE(actual.vertexCount() == expected.vertexCount());
+                        for (const auto& position : expected.vertexPositions()) {
+                            CHECK(actual.hasVertex(position, vm::C::almost_zero()));
+                        }
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("BrushTest.translatePastWorldBounds", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(Entity(), MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            const Brush brush = builder.createCuboid(vm::bbox3(vm::vec3(-64, -64, -64), vm::vec3(64, 64, 64)), "texture").value();
+
+            CHECK(brush.transform(worldBounds, vm::translation_matrix(vm::vec3(8064, 0, 0)), false).is_success());
+            CHECK(brush.transform(worldBounds, vm::translation_matrix(vm::vec3(8160, 0, 0)), false).is_error());
+            CHECK(brush.transform(worldBounds, vm::translation_matrix(vm::vec3(20000, 0, 0)), false).is_error());
+        }
+
         TEST_CASE("BrushTest.contractToZero", "[BrushTest]") {
             const vm::bbox3 worldBounds(8192.0);
             WorldNode world(Entity(), MapFormat::Standard);
@@ -18,6 +18,8 @@
  */
 
 #include "Logger.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "TestUtils.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
@@ -26,9 +28,14 @@
 #include "IO/IOUtils.h"
 #include "IO/GameConfigParser.h"
 #include "IO/Path.h"
+#include "IO/TestEnvironment.h"
 #include "Model/EntityNode.h"
 #include "Model/GameConfig.h"
 #include "Model/GameImpl.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
 
 #include <algorithm>
 #include <iterator>
@@ -172,5 +179,51 @@ namespace TrenchBroom {
             const auto& skiesTextures = testCollection.textures();
             ASSERT_TRUE(skiesTextures.front().name() == "test/editor_image");
         }
+
+        TEST_CASE("GameTest.writeMapCache", "[GameTest]") {
+            const auto configPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/games/Quake/GameConfig.cfg");
+            const auto configStr = IO::Disk::readTextFile(configPath);
+            auto configParser = IO::GameConfigParser(configStr, configPath);
+            auto config = configParser.parse();
+
+            IO::TestEnvironment env("GameTest");
+            auto logger = NullLogger();
+            auto game = GameImpl(config, env.dir(), logger);
+
+            setPref(Preferences::UseMapCache, true);
+
+            SECTION("Map without errors is cached") {
+                env.createFile(IO::Path("test.map"), R"(// entity 0
+{
+"classname" "worldspawn"
+}
+)");
+
+                const auto world = game.loadMap(MapFormat::Standard, vm::bbox3(8192.0), env.dir() + IO::Path("test.map"), logger);
+                REQUIRE(world != nullptr);
+                CHECK(env.fileExists(IO::Path("test.map.tbcache")));
+            }
+
+            SECTION("Map with errors is not cached") {
+                // the group is skipped because it has no name, and the error would be lost when loading from the cache
+                env.createFile(IO::Path("test.map"), R"(// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_id" "1"
+}
+)");
+
+                const auto world = game.loadMap(MapFormat::Standard, vm::bbox3(8192.0), env.dir() + IO::Path("test.map"), logger);
+                REQUIRE(world != nullptr);
+                CHECK_FALSE(env.fileExists(IO::Path("test.map.tbcache")));
+            }
+
+            resetPref(Preferences::UseMapCache);
+        }
     }
 }
@@ -24,6 +24,7 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/IOUtils.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/NodeReader.h"
 #include "IO/NodeWriter.h"
 #include "IO/TestParserStatus.h"
@@ -100,17 +101,30 @@ namespace TrenchBroom {
             return std::make_unique<WorldNode>(Entity(), format);
         }
 
-        void TestGame::doWriteMap(WorldNode& world, const IO::Path& path) const {
+        IO::TextHash TestGame::doWriteMap(WorldNode& world, const IO::Path& path, const IO::PreviousMapFile* previousFile) const {
             const auto mapFormatName = formatName(world.format());
 
-            std::ofstream file = openPathAsOutputStream(path);
-            if (!file) {
+            std::ofstream fileStream = openPathAsOutputStream(path, std::ios::out | std::ios::binary);
+            if (!fileStream) {
                 throw FileSystemException("Cannot open file: " + path.asString());
             }
+
+            // hash the file while it is written so that it need not be read again to detect later changes
+            IO::HashingOutputStream file(fileStream);
             IO::writeGameComment(file, gameName(), mapFormatName);
 
-            IO::NodeWriter writer(world, file);
+            auto serializer = IO::MapFileSerializer::create(world.format(), file);
+            if (previousFile != nullptr) {
+                if (const auto previousText = IO::skipGameComment(previousFile->text, gameName(), mapFormatName)) {
+                    serializer = IO::MapFileSerializer::create(world.format(), file, IO::PreviousMapFile{*previousText, previousFile->isModified});
+                }
+            }
+
+            IO::NodeWriter writer(world, std::move(serializer));
             writer.writeMap();
+
+            file.flush();
+            return file.hash();
         }
 
         void TestGame::doExportMap(WorldNode& /* world */, const Model::ExportFormat /* format */, const IO::Path& /* path */) const {}
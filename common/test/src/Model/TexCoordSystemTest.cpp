@@ -25,6 +25,8 @@
 
 #include <vecmath/vec.h>
 
+#include <vector>
+
 #include "Catch2.h"
 #include "GTestCompat.h"
 
@@ -52,6 +54,45 @@ namespace TrenchBroom {
             parallelSnapshot->restore(parallel);
         }
 
+        TEST_CASE("TexCoordSystemTest.getTexCoordsOfPoints", "[TexCoordSystemTest]") {
+            BrushFaceAttributes attribs("");
+            attribs.setOffset(vm::vec2f(12.0f, -3.5f));
+            attribs.setScale(vm::vec2f(0.5f, 2.0f));
+            attribs.setRotation(30.0f);
+
+            const auto textureSize = vm::vec2f(64.0f, 128.0f);
+            const auto points = std::vector<vm::vec3>{
+                vm::vec3(0.0, 0.0, 0.0),
+                vm::vec3(16.0, -32.0, 8.0),
+                vm::vec3(-1024.5, 77.25, 3.0),
+                vm::vec3(4096.0, 4096.0, -4096.0),
+                vm::vec3(1.0, 2.0, 3.0),
+            };
+
+            std::vector<FloatType> xs, ys, zs;
+            for (const auto& point : points) {
+                xs.push_back(point.x());
+                ys.push_back(point.y());
+                zs.push_back(point.z());
+            }
+
+            const auto checkTexCoords = [&](const TexCoordSystem& texCoordSystem) {
+                std::vector<float> us(points.size()), vs(points.size());
+                texCoordSystem.getTexCoords(points.size(), xs.data(), ys.data(), zs.data(), attribs, textureSize, us.data(), vs.data());
+
+                for (size_t i = 0u; i < points.size(); ++i) {
+                    const auto expected = texCoordSystem.getTexCoords(points[i], attribs, textureSize);
+                    CHECK(us[i] == Approx(expected.x()));
+                    CHECK(vs[i] == Approx(expected.y()));
+                }
+            };
+
+            checkTexCoords(ParaxialTexCoordSystem(vm::vec3::pos_z(), attribs));
+            checkTexCoords(ParaxialTexCoordSystem(vm::normalize(vm::vec3(1.0, 2.0, 3.0)), attribs));
+            checkTexCoords(ParallelTexCoordSystem(vm::vec3(0.0, 0.0, 0.0), vm::vec3(1.0, 0.0, 1.0), vm::vec3(0.0, 1.0, 2.0), attribs));
+            checkTexCoords(ParallelTexCoordSystem(vm::vec3::pos_y(), vm::vec3::pos_x()));
+        }
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
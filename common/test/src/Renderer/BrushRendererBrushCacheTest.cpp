@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+#include "Model/WorldNode.h"
+#include "Renderer/BrushRendererBrushCache.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Checks that the cached vertices of the given brush have the positions and texture coordinates of the
+         * vertices of its faces, in the order in which the cache stores them.
+         */
+        static void checkCachedVertices(const Model::BrushNode* brushNode) {
+            const auto& cachedVertices = brushNode->brushRendererBrushCache().cachedVertices();
+
+            size_t i = 0u;
+            for (const auto& face : brushNode->brush().faces()) {
+                // the cache stores the vertices of every face in clockwise order
+                const auto& boundary = face.geometry()->boundary();
+                for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it) {
+                    REQUIRE(i < cachedVertices.size());
+
+                    const auto& position = (*it)->origin()->position();
+                    const auto& vertex = cachedVertices[i++];
+                    CHECK(vertex.attr == vm::vec3f(position));
+                    CHECK(vertex.rest.rest.attr == face.textureCoords(position));
+                }
+            }
+            CHECK(i == cachedVertices.size());
+        }
+
+        TEST_CASE("BrushRendererBrushCacheTest.validateVertexCaches", "[BrushRendererBrushCacheTest]") {
+            const auto mapFormat = GENERATE(Model::MapFormat::Standard, Model::MapFormat::Valve);
+
+            const vm::bbox3 worldBounds(8192.0);
+            Model::WorldNode world(Model::Entity(), mapFormat);
+            Model::BrushBuilder builder(&world, worldBounds);
+
+            Assets::Texture texture("texture", 64, 32);
+
+            // enough brushes to compute the texture coordinates in several batches
+            std::vector<Model::BrushNode*> brushNodes;
+            for (size_t i = 0u; i < 1000u; ++i) {
+                const auto origin = vm::vec3(static_cast<FloatType>(i % 10u) * 37.0, static_cast<FloatType>(i / 10u) * 23.0, static_cast<FloatType>(i % 7u) * 11.0);
+                auto brush = builder.createCuboid(vm::bbox3(origin, origin + vm::vec3(32.0, 16.0, 48.0)), "texture").value();
+
+                for (auto& face : brush.faces()) {
+                    auto attributes = face.attributes();
+                    attributes.setOffset(vm::vec2f(static_cast<float>(i % 13u), -static_cast<float>(i % 5u)));
+                    attributes.setScale(vm::vec2f(0.5f + static_cast<float>(i % 3u), 1.0f - 0.25f * static_cast<float>(i % 4u)));
+                    attributes.setRotation(static_cast<float>(i % 8u) * 15.0f);
+                    face.setAttributes(attributes);
+                    face.setTexture(&texture);
+                }
+
+                brushNodes.push_back(world.createBrush(std::move(brush)));
+            }
+
+            SECTION("Validate in batches") {
+                BrushRendererBrushCache::validateVertexCaches(std::vector<const Model::BrushNode*>(std::begin(brushNodes), std::end(brushNodes)));
+            }
+
+            SECTION("Validate one by one") {
+                for (const auto* brushNode : brushNodes) {
+                    brushNode->brushRendererBrushCache().validateVertexCache(brushNode);
+                }
+            }
+
+            for (const auto* brushNode : brushNodes) {
+                checkCachedVertices(brushNode);
+            }
+
+            kdl::vec_clear_and_delete(brushNodes);
+        }
+    }
+}
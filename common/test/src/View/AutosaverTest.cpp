@@ -18,14 +18,22 @@
  */
 
 #include "Logger.h"
+#include "Assets/EntityDefinition.h"
+#include "IO/DiskIO.h"
 #include "IO/Path.h"
 #include "IO/TestEnvironment.h"
 #include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
 #include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
 #include "View/Autosaver.h"
 #include "View/MapDocumentTest.h"
 
+#include <kdl/string_compare.h>
+
 #include <chrono>
+#include <string>
 #include <thread>
 
 #include "Catch2.h"
@@ -142,6 +150,84 @@ namespace TrenchBroom {
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.2.map")));
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesSnapshotInBackground") {
+            using namespace std::literals::chrono_literals;
+
+            IO::TestEnvironment env("autosaver_test");
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0s, 50u, Autosaver::Mode::Background);
+
+            // modify the map
+            auto* brushNode = createBrushNode("some_texture");
+            document->addNode(brushNode, document->currentLayer());
+            const auto lineNumber = brushNode->lineNumber();
+
+            autosaver.triggerAutosave(logger);
+
+            // edit the map while the backup is being written
+            document->addNode(createBrushNode("other_texture"), document->currentLayer());
+            document->setAttribute("message", "changed");
+
+            autosaver.waitForAutosave(logger);
+            ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
+
+            // the backup contains the map as it was when the autosave was triggered
+            const auto backup = IO::Disk::readTextFile(env.dir() + IO::Path("autosave/test.1.map"));
+            CHECK(kdl::cs::str_contains(backup, "some_texture"));
+            CHECK_FALSE(kdl::cs::str_contains(backup, "other_texture"));
+            CHECK_FALSE(kdl::cs::str_contains(backup, "changed"));
+
+            // the document was not changed by writing the backup
+            CHECK(document->world()->defaultLayer()->childCount() == 2u);
+            CHECK(document->world()->entity().hasAttribute("message", "changed"));
+            CHECK(brushNode->lineNumber() == lineNumber);
+
+            // no new backup is created until the map is modified again
+            autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
+            CHECK_FALSE(env.fileExists(IO::Path("autosave/test.2.map")));
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverReloadsAssetsDuringBackgroundSave") {
+            using namespace std::literals::chrono_literals;
+
+            IO::TestEnvironment env("autosaver_test");
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0s, 50u, Autosaver::Mode::Background);
+
+            // modify the map
+            auto* entityNode = new Model::EntityNode({
+                {"classname", "point_entity"}
+            });
+            document->addNode(entityNode, document->currentLayer());
+            REQUIRE(entityNode->entity().definition() == m_pointEntityDef);
+
+            autosaver.triggerAutosave(logger);
+
+            // the snapshot that is being written does not refer to the entity definition
+            CHECK(m_pointEntityDef->usageCount() == 1u);
+
+            // deletes the entity definitions while the backup is being written
+            document->reloadEntityDefinitions();
+            m_pointEntityDef = nullptr;
+            m_brushEntityDef = nullptr;
+
+            autosaver.waitForAutosave(logger);
+            ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
+
+            const auto backup = IO::Disk::readTextFile(env.dir() + IO::Path("autosave/test.1.map"));
+            CHECK(kdl::cs::str_contains(backup, "point_entity"));
+            CHECK(entityNode->entity().definition() == nullptr);
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesPresent") {
             // https://github.com/TrenchBroom/TrenchBroom/issues/2544
 
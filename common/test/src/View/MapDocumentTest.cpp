@@ -21,10 +21,19 @@
 
 #include "Exceptions.h"
 #include "Assets/EntityDefinition.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
 #include "Model/BrushNode.h"
+#include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/EmptyAttributeNameIssueGenerator.h"
 #include "Model/EmptyAttributeValueIssueGenerator.h"
 #include "Model/Entity.h"
@@ -38,6 +47,7 @@
 #include "Model/LockState.h"
 #include "Model/MapFormat.h"
 #include "Model/ModelUtils.h"
+#include "Model/NonIntegerVerticesIssueGenerator.h"
 #include "Model/ParallelTexCoordSystem.h"
 #include "Model/PickResult.h"
 #include "Model/Polyhedron.h"
@@ -51,6 +61,7 @@
 
 #include <kdl/result.h>
 #include <kdl/overload.h>
+#include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
@@ -1203,6 +1214,87 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(issueGenerators);
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "IssueGenerator.validateIssues", "[IssueGenerator]") {
+            Model::BrushNode* brush1 = createBrushNode();
+            Model::BrushNode* brush2 = createBrushNode();
+            document->addNode(brush1, document->parentForNodes());
+            document->addNode(brush2, document->parentForNodes());
+
+            document->deselectAll();
+            document->select(brush2);
+            REQUIRE(document->translateObjects(vm::vec3(0.5, 0.0, 0.0)));
+            document->deselectAll();
+
+            auto issueGenerators = std::vector<Model::IssueGenerator*>{
+                new Model::NonIntegerVerticesIssueGenerator()
+            };
+
+            const auto nodes = Model::collectNodes(std::vector<Model::Node*>{document->world()});
+            Model::validateIssues(nodes, issueGenerators);
+
+            for (const auto* node : nodes) {
+                CHECK(node->issuesValid());
+            }
+            CHECK(brush1->issues(issueGenerators).empty());
+            REQUIRE(brush2->issues(issueGenerators).size() == 1u);
+
+            // only the issues of modified nodes are generated again
+            auto* brush2Issue = brush2->issues(issueGenerators).front();
+
+            document->select(brush1);
+            REQUIRE(document->translateObjects(vm::vec3(0.5, 0.0, 0.0)));
+            document->deselectAll();
+
+            CHECK_FALSE(brush1->issuesValid());
+            CHECK(brush2->issuesValid());
+
+            Model::validateIssues(nodes, issueGenerators);
+            CHECK(brush1->issuesValid());
+            CHECK(brush1->issues(issueGenerators).size() == 1u);
+            CHECK(brush2->issues(issueGenerators) == std::vector<Model::Issue*>{brush2Issue});
+
+            kdl::vec_clear_and_delete(issueGenerators);
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "IssueGenerator.validateIssuesInNodeOrder", "[IssueGenerator]") {
+            auto* entityNode = new Model::EntityNode({
+                {"classname", "func_door"},
+                {"", ""}
+            });
+            document->addNode(entityNode, document->parentForNodes());
+
+            for (size_t i = 0u; i < 100u; ++i) {
+                auto* brushNode = createBrushNode();
+                document->addNode(brushNode, i % 2u == 0u ? document->parentForNodes() : entityNode);
+            }
+
+            document->selectAllNodes();
+            REQUIRE(document->translateObjects(vm::vec3(0.5, 0.0, 0.0)));
+            document->deselectAll();
+
+            auto issueGenerators = std::vector<Model::IssueGenerator*>{
+                new Model::EmptyAttributeNameIssueGenerator(),
+                new Model::NonIntegerVerticesIssueGenerator()
+            };
+
+            const auto nodes = Model::collectNodes(std::vector<Model::Node*>{document->world()});
+            Model::validateIssues(nodes, issueGenerators);
+
+            // the sequence IDs of the issues follow the order of the nodes, regardless of the order in which the
+            // issues of the brushes were generated
+            auto issues = std::vector<Model::Issue*>{};
+            for (auto* node : nodes) {
+                issues = kdl::vec_concat(std::move(issues), node->issues(issueGenerators));
+            }
+
+            REQUIRE(issues.size() == 101u);
+            for (size_t i = 1u; i < issues.size(); ++i) {
+                CHECK(issues[i - 1u]->seqId() < issues[i]->seqId());
+            }
+
+            kdl::vec_clear_and_delete(issueGenerators);
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.defaultLayerSortIndexImmutable", "[LayerTest]") {
             Model::LayerNode* defaultLayer = document->world()->defaultLayer();
 
@@ -1540,5 +1632,130 @@ namespace TrenchBroom {
             document->redoCommand();
             CHECK(document->currentLayer() == layer2);
         }
+
+        static size_t countNodes(const Model::Node* node) {
+            size_t count = 0u;
+            node->accept([&](auto&& thisLambda, const Model::Node* n) {
+                ++count;
+                n->visitChildren(thisLambda);
+            });
+            return count;
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.saveDocumentIncrementally", "[MapDocumentTest]") {
+            IO::TestEnvironment env("incremental_save_test");
+
+            auto* layer1 = document->world()->createLayer("layer1");
+            auto* layer2 = document->world()->createLayer("layer2");
+            document->addNode(layer1, document->world());
+            document->addNode(layer2, document->world());
+
+            auto* brushNode = createBrushNode();
+            document->addNode(brushNode, layer1);
+
+            auto* entityNode = new Model::EntityNode();
+            document->addNode(entityNode, layer1);
+
+            auto* groupedBrushNode = createBrushNode();
+            document->addNode(groupedBrushNode, document->world()->defaultLayer());
+            document->deselectAll();
+            document->select(groupedBrushNode);
+            auto* groupNode = document->groupSelection("group");
+            document->deselectAll();
+
+            const auto path = env.dir() + IO::Path("test.map");
+            document->saveDocumentAs(path);
+            REQUIRE(env.fileExists(IO::Path("test.map")));
+
+            SECTION("add node") {
+                document->addNode(createBrushNode(), layer2);
+            }
+
+            SECTION("remove node") {
+                document->removeNodes({ brushNode });
+            }
+
+            SECTION("reparent node") {
+                document->reparentNodes(layer2, { entityNode });
+            }
+
+            SECTION("edit face") {
+                document->select(Model::BrushFaceHandle(brushNode, 0u));
+
+                Model::ChangeBrushFaceAttributesRequest request;
+                request.setTextureName("other_texture");
+                request.setXOffset(16.0f);
+                document->setFaceAttributes(request);
+            }
+
+            SECTION("reorder layers") {
+                document->moveLayer(layer1, 1);
+            }
+
+            SECTION("lock and hide layer") {
+                document->lock({ layer1 });
+                document->hide({ layer2 });
+            }
+
+            SECTION("rename group") {
+                document->select(groupNode);
+                document->renameGroups("renamed");
+            }
+
+            document->saveDocument();
+            const auto incrementalText = IO::Disk::readTextFile(path);
+
+            const auto fullPath = env.dir() + IO::Path("full.map");
+            game->writeMap(*document->world(), fullPath);
+            const auto fullText = IO::Disk::readTextFile(fullPath);
+
+            CHECK(incrementalText == fullText);
+
+            IO::TestParserStatus status;
+            IO::WorldReader reader(incrementalText);
+            const auto reloadedWorld = reader.read(Model::MapFormat::Standard, document->worldBounds(), status);
+            REQUIRE(reloadedWorld != nullptr);
+            CHECK(countNodes(reloadedWorld.get()) == countNodes(document->world()));
+        }
+
+        static std::string readFileBytes(const IO::Path& path) {
+            const auto file = IO::Disk::openFile(path);
+            const auto reader = file->reader().buffer();
+            return std::string(reader.stringView());
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.saveDocumentIncrementallyAfterLineEndingsChanged", "[MapDocumentTest]") {
+            IO::TestEnvironment env("incremental_save_crlf_test");
+
+            document->addNode(createBrushNode(), document->world()->defaultLayer());
+
+            const auto path = env.dir() + IO::Path("test.map");
+            document->saveDocumentAs(path);
+
+            // the saved file must not contain any line ending conversions
+            const auto savedText = readFileBytes(path);
+            REQUIRE(savedText.find('\r') == std::string::npos);
+
+            // another editor changes the line endings of the saved file
+            {
+                std::ofstream stream = IO::openPathAsOutputStream(path, std::ios::out | std::ios::binary);
+                stream << kdl::str_replace_every(savedText, "\n", "\r\n");
+            }
+
+            document->addNode(createBrushNode(), document->world()->defaultLayer());
+            document->saveDocument();
+
+            // the changed file cannot be copied from, so the document is saved completely
+            const auto fullPath = env.dir() + IO::Path("full.map");
+            game->writeMap(*document->world(), fullPath);
+            CHECK(readFileBytes(path) == readFileBytes(fullPath));
+
+            // the file that was just saved can be copied from again
+            document->addNode(createBrushNode(), document->world()->defaultLayer());
+            document->saveDocument();
+
+            game->writeMap(*document->world(), fullPath);
+            CHECK(readFileBytes(path) == readFileBytes(fullPath));
+        }
     }
 }
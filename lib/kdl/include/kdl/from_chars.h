@@ -0,0 +1,246 @@
+/*
+ Copyright 2020 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_FROM_CHARS_H
+#define KDL_FROM_CHARS_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace kdl {
+    /**
+     * The result of parsing a number from a range of characters.
+     */
+    struct from_chars_result {
+        /**
+         * Points to the first character that is not part of the parsed number, or to the beginning of the range if
+         * no number could be parsed.
+         */
+        const char* ptr;
+        /**
+         * A default constructed value on success, std::errc::invalid_argument if the range does not start with a
+         * number, or std::errc::result_out_of_range if the number cannot be represented by the result type.
+         */
+        std::errc ec;
+    };
+
+    namespace detail {
+        inline bool is_decimal_digit(const char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        /**
+         * Parses a floating point number using strtod. The characters are copied into a buffer to null terminate
+         * them, which only allocates memory if the number is unusually long.
+         */
+        inline from_chars_result strtod_fallback(const char* first, const char* last, double& value) {
+            const auto length = static_cast<size_t>(last - first);
+
+            char buffer[64];
+            std::string long_buffer;
+            char* str = buffer;
+            if (length < sizeof(buffer)) {
+                std::char_traits<char>::copy(buffer, first, length);
+                buffer[length] = '\0';
+            } else {
+                long_buffer.assign(first, last);
+                str = long_buffer.data();
+            }
+
+            errno = 0;
+            const double result = std::strtod(str, nullptr);
+            if (errno == ERANGE) {
+                return { last, std::errc::result_out_of_range };
+            }
+
+            value = result;
+            return { last, std::errc() };
+        }
+    }
+
+    /**
+     * Parses a floating point number in decimal notation from the given range of characters, similar to
+     * std::from_chars. The number must have the form [+-]digits[.digits][(e|E)[+-]digits], where either the integral
+     * or the fractional digits may be omitted. Unlike std::from_chars, a leading plus sign is accepted. Leading
+     * whitespace, infinity, NaN and hexadecimal notation are not supported.
+     *
+     * Numbers with at most 19 significant digits and a small exponent, which includes practically all numbers found
+     * in text based file formats, are converted exactly without calling into the C library. Other numbers are
+     * converted using strtod. In either case, the result is the closest floating point value to the number.
+     *
+     * @param first the beginning of the range
+     * @param last the end of the range
+     * @param value receives the parsed value on success and is unchanged otherwise
+     * @return the position after the parsed number and an error code
+     */
+    inline from_chars_result from_chars(const char* first, const char* last, double& value) {
+        constexpr double powers_of_ten[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        constexpr int max_exact_power = 22;
+        constexpr std::uint64_t max_exact_mantissa = std::uint64_t(1) << 53;
+        constexpr int max_significant_digits = 19;
+
+        const char* cur = first;
+        bool negative = false;
+        if (cur != last && (*cur == '+' || *cur == '-')) {
+            negative = *cur == '-';
+            ++cur;
+        }
+
+        std::uint64_t mantissa = 0u;
+        int significant_digits = 0;
+        int exponent = 0;
+        bool truncated = false;
+
+        const auto add_digit = [&](const char c, const bool fractional) {
+            const auto digit = static_cast<std::uint64_t>(c - '0');
+            if (significant_digits < max_significant_digits) {
+                mantissa = mantissa * 10u + digit;
+                if (mantissa != 0u) {
+                    ++significant_digits;
+                }
+                if (fractional) {
+                    --exponent;
+                }
+            } else {
+                truncated = truncated || digit != 0u;
+                if (!fractional) {
+                    ++exponent;
+                }
+            }
+        };
+
+        const char* digits_begin = cur;
+        while (cur != last && detail::is_decimal_digit(*cur)) {
+            add_digit(*cur++, false);
+        }
+        bool has_digits = cur != digits_begin;
+
+        if (cur != last && *cur == '.') {
+            ++cur;
+            digits_begin = cur;
+            while (cur != last && detail::is_decimal_digit(*cur)) {
+                add_digit(*cur++, true);
+            }
+            has_digits = has_digits || cur != digits_begin;
+        }
+
+        if (!has_digits) {
+            return { first, std::errc::invalid_argument };
+        }
+
+        if (cur != last && (*cur == 'e' || *cur == 'E')) {
+            const char* exponent_cur = cur + 1;
+            bool negative_exponent = false;
+            if (exponent_cur != last && (*exponent_cur == '+' || *exponent_cur == '-')) {
+                negative_exponent = *exponent_cur == '-';
+                ++exponent_cur;
+            }
+
+            // an exponent without digits is not part of the number
+            if (exponent_cur != last && detail::is_decimal_digit(*exponent_cur)) {
+                int explicit_exponent = 0;
+                while (exponent_cur != last && detail::is_decimal_digit(*exponent_cur)) {
+                    // clamp absurdly large exponents, the result is out of range anyway
+                    if (explicit_exponent < 100000) {
+                        explicit_exponent = explicit_exponent * 10 + (*exponent_cur - '0');
+                    }
+                    ++exponent_cur;
+                }
+                exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+                cur = exponent_cur;
+            }
+        }
+
+        if (mantissa == 0u && !truncated) {
+            value = negative ? -0.0 : 0.0;
+            return { cur, std::errc() };
+        }
+
+        // both the mantissa and the power of ten are exactly representable, so a single multiplication or
+        // division yields the correctly rounded result
+        if (!truncated && mantissa <= max_exact_mantissa && exponent >= -max_exact_power && exponent <= max_exact_power) {
+            double result = static_cast<double>(mantissa);
+            if (exponent < 0) {
+                result /= powers_of_ten[-exponent];
+            } else {
+                result *= powers_of_ten[exponent];
+            }
+            value = negative ? -result : result;
+            return { cur, std::errc() };
+        }
+
+        return detail::strtod_fallback(first, cur, value);
+    }
+
+    /**
+     * Parses an integer in decimal notation from the given range of characters, similar to std::from_chars. Unlike
+     * std::from_chars, a leading plus sign is accepted.
+     *
+     * @tparam T the integer type
+     * @param first the beginning of the range
+     * @param last the end of the range
+     * @param value receives the parsed value on success and is unchanged otherwise
+     * @return the position after the parsed number and an error code
+     */
+    template <typename T, typename std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    from_chars_result from_chars(const char* first, const char* last, T& value) {
+        using U = std::make_unsigned_t<T>;
+
+        const char* cur = first;
+        bool negative = false;
+        if (cur != last && (*cur == '+' || (std::is_signed_v<T> && *cur == '-'))) {
+            negative = *cur == '-';
+            ++cur;
+        }
+
+        const auto max = static_cast<U>(std::numeric_limits<T>::max());
+        const U limit = negative ? static_cast<U>(max + 1u) : max;
+
+        U result = 0u;
+        bool overflow = false;
+        const char* digits_begin = cur;
+        while (cur != last && detail::is_decimal_digit(*cur)) {
+            const auto digit = static_cast<U>(*cur - '0');
+            if (result > (limit - digit) / 10u) {
+                overflow = true;
+            } else {
+                result = static_cast<U>(result * 10u + digit);
+            }
+            ++cur;
+        }
+
+        if (cur == digits_begin) {
+            return { first, std::errc::invalid_argument };
+        }
+        if (overflow) {
+            return { cur, std::errc::result_out_of_range };
+        }
+
+        value = negative ? static_cast<T>(U(0u) - result) : static_cast<T>(result);
+        return { cur, std::errc() };
+    }
+}
+
+#endif //KDL_FROM_CHARS_H
@@ -18,62 +18,193 @@
 #ifndef KDL_PARALLEL_H
 #define KDL_PARALLEL_H
 
-#include <atomic>
-#include <future> // for std::async
-#include <thread>
+#include "kdl/thread_pool.h"
+
+#include <algorithm>
+#include <optional>
+#include <type_traits>
 #include <utility> // for std::declval
 #include <vector>
 
 namespace kdl {
+    namespace detail {
+        /**
+         * Returns the number of consecutive indices that are processed by a single task. Unless a grain size is
+         * given, the range is split into several chunks per thread so that idle threads can steal work if the cost
+         * per index varies.
+         */
+        inline size_t parallel_chunk_size(const size_t count, const thread_pool& pool, const size_t grain_size) {
+            if (grain_size > 0u) {
+                return grain_size;
+            }
+            const size_t chunk_count = pool.concurrency() * 4u;
+            return std::max(size_t(1), (count + chunk_count - 1u) / chunk_count);
+        }
+
+        template <typename F>
+        void parallel_for_chunks(thread_pool& pool, const size_t begin, const size_t end, const size_t grain_size, F&& f) {
+            if (begin >= end) {
+                return;
+            }
+
+            const size_t count = end - begin;
+            const size_t chunk_size = parallel_chunk_size(count, pool, grain_size);
+            if (count <= chunk_size || pool.thread_count() == 0u) {
+                for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += std::min(chunk_size, end - chunk_begin)) {
+                    f(chunk_begin, chunk_begin + std::min(chunk_size, end - chunk_begin), []() { return false; });
+                }
+                return;
+            }
+
+            task_group group(pool);
+            for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += std::min(chunk_size, end - chunk_begin)) {
+                const size_t chunk_end = chunk_begin + std::min(chunk_size, end - chunk_begin);
+                group.run([&f, &group, chunk_begin, chunk_end]() {
+                    f(chunk_begin, chunk_end, [&]() { return group.is_cancelled(); });
+                });
+            }
+            group.wait();
+        }
+    }
+
+    /**
+     * Calls the given function for every index in [begin, end) using the given thread pool. The range is split into
+     * chunks of consecutive indices, and each chunk is processed by a single task.
+     *
+     * If the function throws an exception, the remaining indices may be skipped and the exception is rethrown once
+     * all running tasks have completed.
+     *
+     * @tparam F the type of the function, must be of type `void(size_t)`
+     * @param pool the thread pool to use
+     * @param begin the first index
+     * @param end the index past the last index
+     * @param f the function to call
+     * @param grain_size the number of indices per task, or 0 to choose the chunk size automatically
+     */
+    template <typename F>
+    void parallel_for(thread_pool& pool, const size_t begin, const size_t end, F&& f, const size_t grain_size = 0u) {
+        detail::parallel_for_chunks(pool, begin, end, grain_size, [&](const size_t chunk_begin, const size_t chunk_end, const auto& is_cancelled) {
+            for (size_t i = chunk_begin; i < chunk_end && !is_cancelled(); ++i) {
+                f(i);
+            }
+        });
+    }
+
+    /**
+     * Calls the given function for every index in [begin, end) using the default thread pool.
+     *
+     * @see parallel_for(thread_pool&, size_t, size_t, F&&, size_t)
+     */
+    template <typename F>
+    void parallel_for(const size_t begin, const size_t end, F&& f, const size_t grain_size = 0u) {
+        parallel_for(default_thread_pool(), begin, end, std::forward<F>(f), grain_size);
+    }
+
+    /**
+     * Maps every index in [begin, end) to a value and combines the values using the given reduction function.
+     *
+     * Every chunk of indices is reduced separately, starting with the given identity value, and the partial results
+     * are then reduced in the order of their chunks. The reduction function must be associative and the identity
+     * value must be its neutral element. The result does not depend on the order in which the chunks are executed,
+     * but for reductions which are only approximately associative (such as floating point addition), it may depend
+     * on the chunk size and hence the number of threads.
+     *
+     * @tparam T the type of the values
+     * @tparam M the type of the map function, must be of type `T(size_t)`
+     * @tparam R the type of the reduction function, must be of type `T(T, T)`
+     * @param pool the thread pool to use
+     * @param begin the first index
+     * @param end the index past the last index
+     * @param identity the neutral element of the reduction
+     * @param map the map function
+     * @param reduce the reduction function
+     * @param grain_size the number of indices per task, or 0 to choose the chunk size automatically
+     * @return the reduced value
+     */
+    template <typename T, typename M, typename R>
+    T parallel_reduce(thread_pool& pool, const size_t begin, const size_t end, T identity, M&& map, R&& reduce, const size_t grain_size = 0u) {
+        if (begin >= end) {
+            return identity;
+        }
+
+        const size_t count = end - begin;
+        const size_t chunk_size = detail::parallel_chunk_size(count, pool, grain_size);
+        const size_t chunk_count = (count + chunk_size - 1u) / chunk_size;
+
+        std::vector<std::optional<T>> partial_results(chunk_count);
+        detail::parallel_for_chunks(pool, begin, end, chunk_size, [&](const size_t chunk_begin, const size_t chunk_end, const auto& /* is_cancelled */) {
+            T partial_result = identity;
+            for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                partial_result = reduce(std::move(partial_result), map(i));
+            }
+            partial_results[(chunk_begin - begin) / chunk_size] = std::move(partial_result);
+        });
+
+        T result = std::move(identity);
+        for (auto& partial_result : partial_results) {
+            result = reduce(std::move(result), std::move(*partial_result));
+        }
+        return result;
+    }
+
+    /**
+     * Maps and reduces the indices in [begin, end) using the default thread pool.
+     *
+     * @see parallel_reduce(thread_pool&, size_t, size_t, T, M&&, R&&, size_t)
+     */
+    template <typename T, typename M, typename R>
+    T parallel_reduce(const size_t begin, const size_t end, T identity, M&& map, R&& reduce, const size_t grain_size = 0u) {
+        return parallel_reduce(default_thread_pool(), begin, end, std::move(identity), std::forward<M>(map), std::forward<R>(reduce), grain_size);
+    }
+
     /**
      * Applies the given lambda to each element of the input (passing elements as const lvalue references),
      * and returns a vector of the resulting values, in their original order.
-     * 
-     * The lambda is executed in parallel, using the number of threads returned by std::thread::hardware_concurrency().
-     * 
-     * Because the threads are spawned with std::async(std::launch::async, ...) and no thread pool is used,
-     * there is a relatively large overhead and this should only be used on large/slow to process data sets.
+     *
+     * The lambda is executed in parallel by the given thread pool. The result type need not be default
+     * constructible. If the lambda throws an exception, it is rethrown once all running tasks have completed.
      *
      * @tparam T the type of the vector elements
      * @tparam L the type of the lambda to apply
+     * @param pool the thread pool to use
      * @param input the vector
      * @param transform the lambda to apply, must be of type `auto(const T&)`
      * @return a vector containing the transformed values
      */
     template<class T, class L>
-    auto vec_parallel_transform(const std::vector<T>& input, L&& transform) {
-        using ResultType = decltype(transform(std::declval<const T&>()));
-
-        std::vector<ResultType> result;
-        result.resize(input.size());
+    auto vec_parallel_transform(thread_pool& pool, const std::vector<T>& input, L&& transform) {
+        using ResultType = std::decay_t<decltype(transform(std::declval<const T&>()))>;
 
-        size_t numThreads = static_cast<size_t>(std::thread::hardware_concurrency());
-        if (numThreads == 0) {
-            numThreads = 1;
-        }
-
-        std::atomic<size_t> nextIndex(0);
-
-        std::vector<std::future<void>> threads;
-        threads.resize(numThreads);
-
-        for (size_t i = 0; i < numThreads; ++i) {
-            threads[i] = std::async(std::launch::async, [&]() {
-                while (true) {
-                    const size_t ourIndex = std::atomic_fetch_add(&nextIndex, static_cast<size_t>(1));
-                    if (ourIndex >= input.size()) {
-                        break;
-                    }
-                    result[ourIndex] = transform(input[ourIndex]);
-                }
+        // std::vector<bool> packs its elements into shared words, so concurrent writes to distinct elements race
+        if constexpr (std::is_default_constructible_v<ResultType> && !std::is_same_v<ResultType, bool>) {
+            std::vector<ResultType> result(input.size());
+            parallel_for(pool, 0u, input.size(), [&](const size_t i) {
+                result[i] = transform(input[i]);
+            });
+            return result;
+        } else {
+            std::vector<std::optional<ResultType>> staging(input.size());
+            parallel_for(pool, 0u, input.size(), [&](const size_t i) {
+                staging[i].emplace(transform(input[i]));
             });
-        }
 
-        for (size_t i = 0; i < numThreads; ++i) {
-            threads[i].wait();
+            std::vector<ResultType> result;
+            result.reserve(input.size());
+            for (auto& value : staging) {
+                result.push_back(std::move(*value));
+            }
+            return result;
         }
+    }
 
-        return result;
+    /**
+     * Applies the given lambda to each element of the input using the default thread pool.
+     *
+     * @see vec_parallel_transform(thread_pool&, const std::vector<T>&, L&&)
+     */
+    template<class T, class L>
+    auto vec_parallel_transform(const std::vector<T>& input, L&& transform) {
+        return vec_parallel_transform(default_thread_pool(), input, std::forward<L>(transform));
     }
 }
 
@@ -0,0 +1,436 @@
+/*
+ Copyright 2020 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_THREAD_POOL_H
+#define KDL_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kdl {
+    /**
+     * A pool of persistent worker threads that execute submitted tasks.
+     *
+     * Every worker owns a task queue. Tasks submitted from a worker are pushed onto that worker's own queue and
+     * the worker pops tasks from the back of its queue, so nested work stays local to the thread that created it.
+     * Idle workers steal tasks from the front of the other workers' queues. Tasks submitted from threads outside of
+     * the pool are distributed among the queues in round robin order.
+     *
+     * A pool with zero worker threads executes every task immediately on the thread that submits it. This makes the
+     * execution order deterministic, which is useful for tests and debugging.
+     */
+    class task_group;
+
+    class thread_pool {
+    public:
+        using task = std::function<void()>;
+    private:
+        struct queued_task {
+            task t;
+            // the task group that submitted the task, or nullptr
+            const task_group* group;
+        };
+
+        struct task_queue {
+            std::mutex mutex;
+            std::deque<queued_task> tasks;
+        };
+
+        std::vector<std::unique_ptr<task_queue>> m_queues;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_sleep_condition;
+        std::atomic<size_t> m_queued_task_count;
+        std::atomic<size_t> m_next_queue;
+        bool m_stop;
+    public:
+        /**
+         * Creates a pool with the given number of worker threads.
+         *
+         * @param thread_count the number of worker threads, if 0, tasks are executed on the submitting thread
+         */
+        explicit thread_pool(const size_t thread_count) :
+        m_queued_task_count(0u),
+        m_next_queue(0u),
+        m_stop(false) {
+            for (size_t i = 0u; i < thread_count; ++i) {
+                m_queues.push_back(std::make_unique<task_queue>());
+            }
+            for (size_t i = 0u; i < thread_count; ++i) {
+                m_workers.emplace_back([this, i]() { run_worker(i); });
+            }
+        }
+
+        /**
+         * Executes all remaining tasks and joins the worker threads.
+         */
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                m_stop = true;
+            }
+            m_sleep_condition.notify_all();
+
+            for (auto& worker : m_workers) {
+                worker.join();
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        /**
+         * Returns the number of worker threads of this pool.
+         */
+        size_t thread_count() const {
+            return m_workers.size();
+        }
+
+        /**
+         * Returns the number of threads that can execute tasks at the same time, which is the number of workers plus
+         * the thread that waits for the tasks to complete and helps executing them.
+         */
+        size_t concurrency() const {
+            return thread_count() + 1u;
+        }
+
+        /**
+         * Submits the given task for execution. The task must not throw, use task_group or async to run tasks
+         * which may throw.
+         *
+         * @param t the task to execute
+         */
+        void submit(task t) {
+            submit(std::move(t), nullptr);
+        }
+
+        /**
+         * Submits the given function for execution and returns a future for its result. If the function throws an
+         * exception, it is rethrown when the result is obtained from the future.
+         *
+         * Blocking on the returned future from within a task of this pool does not help executing other tasks, so
+         * tasks that need to wait for other tasks should use a task_group instead.
+         *
+         * @tparam F the type of the function to execute
+         * @param f the function to execute
+         * @return a future for the result of the given function
+         */
+        template <typename F>
+        auto async(F&& f) {
+            using result_type = std::invoke_result_t<std::decay_t<F>>;
+
+            auto packaged_task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(f));
+            auto future = packaged_task->get_future();
+            submit([packaged_task]() { (*packaged_task)(); });
+            return future;
+        }
+
+        /**
+         * Executes a single pending task on the calling thread, if any.
+         *
+         * @return true if a task was executed and false otherwise
+         */
+        bool run_pending_task() {
+            return run_pending_task(nullptr);
+        }
+    private:
+        friend class task_group;
+
+        void submit(task t, const task_group* group) {
+            if (m_workers.empty()) {
+                t();
+                return;
+            }
+
+            auto& queue = current_pool() == this
+                ? *m_queues[current_index()]
+                : *m_queues[m_next_queue++ % m_queues.size()];
+
+            // increment the counter first so that it never underflows when a worker pops the task right away
+            {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                ++m_queued_task_count;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(queued_task{std::move(t), group});
+            }
+            m_sleep_condition.notify_one();
+        }
+
+        /**
+         * Executes a single pending task of the given group on the calling thread, if any. If the given group is
+         * null, any pending task is executed.
+         */
+        bool run_pending_task(const task_group* group) {
+            task t;
+            if (!try_pop(t, group)) {
+                return false;
+            }
+            t();
+            return true;
+        }
+
+        static thread_pool*& current_pool() {
+            thread_local thread_pool* pool = nullptr;
+            return pool;
+        }
+
+        static size_t& current_index() {
+            thread_local size_t index = 0u;
+            return index;
+        }
+
+        bool try_pop(task& t, const task_group* group) {
+            if (m_queues.empty()) {
+                return false;
+            }
+
+            const auto matches = [&](const queued_task& queued) {
+                return group == nullptr || queued.group == group;
+            };
+
+            const bool is_worker = current_pool() == this;
+            if (is_worker) {
+                auto& queue = *m_queues[current_index()];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                const auto it = std::find_if(std::rbegin(queue.tasks), std::rend(queue.tasks), matches);
+                if (it != std::rend(queue.tasks)) {
+                    t = std::move(it->t);
+                    queue.tasks.erase(std::next(it).base());
+                    --m_queued_task_count;
+                    return true;
+                }
+            }
+
+            const size_t first = is_worker ? current_index() + 1u : m_next_queue.load();
+            for (size_t i = 0u; i < m_queues.size(); ++i) {
+                auto& queue = *m_queues[(first + i) % m_queues.size()];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                const auto it = std::find_if(std::begin(queue.tasks), std::end(queue.tasks), matches);
+                if (it != std::end(queue.tasks)) {
+                    t = std::move(it->t);
+                    queue.tasks.erase(it);
+                    --m_queued_task_count;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void run_worker(const size_t index) {
+            current_pool() = this;
+            current_index() = index;
+
+            while (true) {
+                if (run_pending_task()) {
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                m_sleep_condition.wait(lock, [&]() { return m_stop || m_queued_task_count > 0u; });
+                if (m_stop && m_queued_task_count == 0u) {
+                    return;
+                }
+            }
+        }
+    };
+
+    namespace detail {
+        inline std::atomic<thread_pool*>& default_thread_pool_override() {
+            static std::atomic<thread_pool*> pool(nullptr);
+            return pool;
+        }
+    }
+
+    /**
+     * Returns the number of worker threads used by the process wide thread pool. The thread that waits for tasks
+     * helps executing them, so this is one less than the number of hardware threads.
+     */
+    inline size_t default_thread_count() {
+        const auto hardware_threads = static_cast<size_t>(std::thread::hardware_concurrency());
+        return hardware_threads > 1u ? hardware_threads - 1u : 0u;
+    }
+
+    /**
+     * Returns the thread pool used by the parallel algorithms unless a pool is passed explicitly. This is the process
+     * wide pool, which is created on first use, unless it was replaced with a scoped_default_thread_pool.
+     */
+    inline thread_pool& default_thread_pool() {
+        if (auto* pool = detail::default_thread_pool_override().load()) {
+            return *pool;
+        }
+
+        static thread_pool pool(default_thread_count());
+        return pool;
+    }
+
+    /**
+     * RAII class that replaces the default thread pool with the given pool and restores the previous default pool
+     * when going out of scope.
+     *
+     * Tests can use this with a pool without worker threads to run all parallel algorithms deterministically on the
+     * calling thread.
+     */
+    class scoped_default_thread_pool {
+    private:
+        thread_pool* m_previous;
+    public:
+        explicit scoped_default_thread_pool(thread_pool& pool) :
+        m_previous(detail::default_thread_pool_override().exchange(&pool)) {}
+
+        ~scoped_default_thread_pool() {
+            detail::default_thread_pool_override().store(m_previous);
+        }
+
+        scoped_default_thread_pool(const scoped_default_thread_pool&) = delete;
+        scoped_default_thread_pool& operator=(const scoped_default_thread_pool&) = delete;
+    };
+
+    /**
+     * A group of tasks that are executed by a thread pool and can be waited for together.
+     *
+     * If a task throws an exception, the group is cancelled: tasks that have not started yet are skipped, and the
+     * first exception is rethrown by wait. The thread that waits for the group helps executing the pending tasks of
+     * the group, so it is safe to wait for a task group from within a task of the same pool. It never executes tasks
+     * that were submitted by others, so waiting for a group does not get stuck in unrelated long running tasks.
+     */
+    class task_group {
+    private:
+        thread_pool& m_pool;
+        std::atomic<size_t> m_pending_count;
+        // the number of tasks that were submitted, but have not started yet
+        std::atomic<size_t> m_queued_count;
+        std::atomic<bool> m_cancelled;
+        std::mutex m_mutex;
+        std::condition_variable m_done;
+        std::exception_ptr m_exception;
+    public:
+        explicit task_group(thread_pool& pool = default_thread_pool()) :
+        m_pool(pool),
+        m_pending_count(0u),
+        m_queued_count(0u),
+        m_cancelled(false) {}
+
+        /**
+         * Waits for all tasks of this group. Any exception thrown by the tasks is discarded.
+         */
+        ~task_group() {
+            wait_for_tasks();
+        }
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        /**
+         * Submits the given function to the thread pool as part of this group.
+         *
+         * @tparam F the type of the function, must be callable without arguments
+         * @param f the function to run
+         */
+        template <typename F>
+        void run(F&& f) {
+            {
+                // increment under the lock so that a waiting thread cannot miss the notification below
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_pending_count;
+                ++m_queued_count;
+            }
+
+            m_pool.submit([this, f = std::forward<F>(f)]() mutable {
+                --m_queued_count;
+
+                if (!m_cancelled) {
+                    try {
+                        f();
+                    } catch (...) {
+                        cancel(std::current_exception());
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_pending_count == 0u) {
+                    m_done.notify_all();
+                }
+            }, this);
+
+            // wake up a thread waiting for this group so that it can help executing the new task
+            m_done.notify_all();
+        }
+
+        /**
+         * Indicates whether a task of this group has thrown an exception. Long running tasks can check this to stop
+         * early.
+         */
+        bool is_cancelled() const {
+            return m_cancelled;
+        }
+
+        /**
+         * Waits until all tasks of this group have completed, executing pending tasks of this group in the meantime.
+         * If any task has thrown an exception, the first such exception is rethrown, and the group can be reused
+         * afterwards.
+         */
+        void wait() {
+            wait_for_tasks();
+
+            if (m_exception) {
+                auto exception = std::exchange(m_exception, nullptr);
+                m_cancelled = false;
+                std::rethrow_exception(exception);
+            }
+        }
+    private:
+        void cancel(std::exception_ptr exception) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_exception) {
+                m_exception = std::move(exception);
+            }
+            m_cancelled = true;
+        }
+
+        void wait_for_tasks() {
+            while (m_pending_count > 0u) {
+                if (!m_pool.run_pending_task(this)) {
+                    // the remaining tasks are being executed by other threads, block until they have completed or
+                    // until one of them submits another task to this group that this thread can help with
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_done.wait(lock, [&]() { return m_pending_count == 0u || m_queued_count > 0u; });
+                }
+            }
+
+            // synchronize with the task that completed last so that this group can be destroyed safely
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+    };
+}
+
+#endif //KDL_THREAD_POOL_H
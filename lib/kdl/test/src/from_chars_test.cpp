@@ -0,0 +1,129 @@
+/*
+ Copyright 2020 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <catch2/catch.hpp>
+
+#include "kdl/from_chars.h"
+
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace kdl {
+    static double parse_double(const std::string& str, const size_t expected_length, const std::errc expected_error = std::errc()) {
+        double value = -1.0;
+        const auto result = from_chars(str.data(), str.data() + str.size(), value);
+        CHECK(result.ec == expected_error);
+        CHECK(static_cast<size_t>(result.ptr - str.data()) == expected_length);
+        return value;
+    }
+
+    TEST_CASE("from_chars_test.parse_double", "[from_chars_test]") {
+        CHECK(parse_double("0", 1u) == 0.0);
+        CHECK(parse_double("-0", 2u) == 0.0);
+        CHECK(parse_double("64", 2u) == 64.0);
+        CHECK(parse_double("+64", 3u) == 64.0);
+        CHECK(parse_double("-64", 3u) == -64.0);
+        CHECK(parse_double("0.5", 3u) == 0.5);
+        CHECK(parse_double(".5", 2u) == 0.5);
+        CHECK(parse_double("5.", 2u) == 5.0);
+        CHECK(parse_double("-0.125", 6u) == -0.125);
+        CHECK(parse_double("0.1", 3u) == 0.1);
+        CHECK(parse_double("1.000000", 8u) == 1.0);
+        CHECK(parse_double("1e3", 3u) == 1000.0);
+        CHECK(parse_double("1.5E-2", 6u) == 0.015);
+        CHECK(parse_double("2e+2", 4u) == 200.0);
+        CHECK(parse_double("-1.7976931348623157e308", 23u) == -std::numeric_limits<double>::max());
+        CHECK(parse_double("123456789012345678901234567890", 30u) == 123456789012345678901234567890.0);
+        CHECK(parse_double("0.000000000000000000000000000001", 32u) == 1e-30);
+
+        // trailing characters are not part of the number
+        CHECK(parse_double("12 34", 2u) == 12.0);
+        CHECK(parse_double("12)", 2u) == 12.0);
+        CHECK(parse_double("1e", 1u) == 1.0);
+        CHECK(parse_double("1e+", 1u) == 1.0);
+        CHECK(parse_double("1.5.5", 3u) == 1.5);
+
+        // the value is not changed on failure
+        CHECK(parse_double("", 0u, std::errc::invalid_argument) == -1.0);
+        CHECK(parse_double("-", 0u, std::errc::invalid_argument) == -1.0);
+        CHECK(parse_double(".", 0u, std::errc::invalid_argument) == -1.0);
+        CHECK(parse_double("e5", 0u, std::errc::invalid_argument) == -1.0);
+        CHECK(parse_double(" 1", 0u, std::errc::invalid_argument) == -1.0);
+        CHECK(parse_double("1e400", 5u, std::errc::result_out_of_range) == -1.0);
+        CHECK(parse_double("1e-400", 6u, std::errc::result_out_of_range) == -1.0);
+    }
+
+    TEST_CASE("from_chars_test.parse_double_matches_strtod", "[from_chars_test]") {
+        auto rng = std::mt19937_64(12345u);
+        auto mantissa_dist = std::uniform_int_distribution<long long>(-99999999999LL, 99999999999LL);
+        auto scale_dist = std::uniform_int_distribution<int>(0, 12);
+        auto exponent_dist = std::uniform_int_distribution<int>(-40, 40);
+
+        for (size_t i = 0u; i < 10000u; ++i) {
+            std::stringstream str;
+            const auto mantissa = std::to_string(mantissa_dist(rng));
+            const auto scale = static_cast<size_t>(scale_dist(rng));
+            if (scale < mantissa.size()) {
+                str << mantissa.substr(0u, mantissa.size() - scale) << "." << mantissa.substr(mantissa.size() - scale);
+            } else {
+                str << mantissa;
+            }
+            if (i % 2u == 0u) {
+                str << "e" << exponent_dist(rng);
+            }
+
+            const auto s = str.str();
+            double value = 0.0;
+            const auto result = from_chars(s.data(), s.data() + s.size(), value);
+            CHECK(result.ec == std::errc());
+            CHECK(result.ptr == s.data() + s.size());
+            CHECK(value == std::strtod(s.c_str(), nullptr));
+        }
+    }
+
+    TEST_CASE("from_chars_test.parse_integer", "[from_chars_test]") {
+        const auto parse_long = [](const std::string& str, const size_t expected_length, const std::errc expected_error = std::errc()) {
+            long value = -1;
+            const auto result = from_chars(str.data(), str.data() + str.size(), value);
+            CHECK(result.ec == expected_error);
+            CHECK(static_cast<size_t>(result.ptr - str.data()) == expected_length);
+            return value;
+        };
+
+        CHECK(parse_long("0", 1u) == 0);
+        CHECK(parse_long("123", 3u) == 123);
+        CHECK(parse_long("+123", 4u) == 123);
+        CHECK(parse_long("-123", 4u) == -123);
+        CHECK(parse_long("12.5", 2u) == 12);
+        CHECK(parse_long(std::to_string(std::numeric_limits<long>::max()), std::to_string(std::numeric_limits<long>::max()).size()) == std::numeric_limits<long>::max());
+        CHECK(parse_long(std::to_string(std::numeric_limits<long>::min()), std::to_string(std::numeric_limits<long>::min()).size()) == std::numeric_limits<long>::min());
+
+        CHECK(parse_long("", 0u, std::errc::invalid_argument) == -1);
+        CHECK(parse_long("-", 0u, std::errc::invalid_argument) == -1);
+        CHECK(parse_long("x1", 0u, std::errc::invalid_argument) == -1);
+        CHECK(parse_long("99999999999999999999", 20u, std::errc::result_out_of_range) == -1);
+
+        unsigned int u = 7u;
+        const auto str = std::string("-1");
+        CHECK(from_chars(str.data(), str.data() + str.size(), u).ec == std::errc::invalid_argument);
+        CHECK(u == 7u);
+    }
+}
@@ -20,7 +20,10 @@
 #include "test_utils.h"
 
 #include "kdl/parallel.h"
+#include "kdl/thread_pool.h"
 
+#include <numeric>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -43,4 +46,99 @@ namespace kdl {
 
         CHECK(expected == kdl::vec_parallel_transform(input, [](int i){ return std::to_string(i); }));
     }
+
+    TEST_CASE("transform_non_default_constructible", "[parallel_test]") {
+        struct value {
+            int i;
+            explicit value(const int i_) : i(i_) {}
+        };
+
+        const auto result = kdl::vec_parallel_transform(std::vector<int>{1, 2, 3}, [](const int i) { return value(i * 2); });
+        REQUIRE(result.size() == 3u);
+        CHECK(result[0].i == 2);
+        CHECK(result[1].i == 4);
+        CHECK(result[2].i == 6);
+    }
+
+    TEST_CASE("transform_bool", "[parallel_test]") {
+        std::vector<int> input;
+        std::vector<bool> expected;
+
+        for (int i = 0; i < 10000; ++i) {
+            input.push_back(i);
+            expected.push_back(i % 3 == 0);
+        }
+
+        CHECK(expected == kdl::vec_parallel_transform(input, [](const int i) { return i % 3 == 0; }));
+    }
+
+    TEST_CASE("transform_serial_pool", "[parallel_test]") {
+        thread_pool pool(0u);
+        CHECK(std::vector<int>{10, 20, 30} == kdl::vec_parallel_transform(pool, std::vector<int>{1, 2, 3}, [](const int& v) { return v * 10; }));
+    }
+
+    TEST_CASE("parallel_for", "[parallel_test]") {
+        thread_pool pool(4u);
+
+        SECTION("empty range") {
+            size_t count = 0u;
+            kdl::parallel_for(pool, 5u, 5u, [&](const size_t) { ++count; });
+            CHECK(count == 0u);
+        }
+
+        SECTION("every index is visited once") {
+            std::vector<int> visits(10000u, 0);
+            kdl::parallel_for(pool, 0u, visits.size(), [&](const size_t i) { ++visits[i]; });
+            CHECK(visits == std::vector<int>(10000u, 1));
+        }
+
+        SECTION("with grain size") {
+            std::vector<int> visits(1000u, 0);
+            kdl::parallel_for(pool, 100u, 900u, [&](const size_t i) { ++visits[i]; }, 7u);
+            for (size_t i = 0u; i < visits.size(); ++i) {
+                CHECK(visits[i] == (i >= 100u && i < 900u ? 1 : 0));
+            }
+        }
+
+        SECTION("nested") {
+            std::vector<std::vector<int>> visits(64u, std::vector<int>(64u, 0));
+            kdl::parallel_for(pool, 0u, visits.size(), [&](const size_t i) {
+                kdl::parallel_for(pool, 0u, visits[i].size(), [&](const size_t j) { ++visits[i][j]; });
+            }, 1u);
+            CHECK(visits == std::vector<std::vector<int>>(64u, std::vector<int>(64u, 1)));
+        }
+
+        SECTION("exception is propagated") {
+            CHECK_THROWS_AS(kdl::parallel_for(pool, 0u, 10000u, [](const size_t i) {
+                if (i == 5000u) {
+                    throw std::runtime_error("error");
+                }
+            }), std::runtime_error);
+        }
+    }
+
+    TEST_CASE("parallel_for_serial_pool_is_deterministic", "[parallel_test]") {
+        thread_pool pool(0u);
+        kdl::scoped_default_thread_pool scope(pool);
+
+        std::vector<size_t> order;
+        kdl::parallel_for(0u, 100u, [&](const size_t i) { order.push_back(i); }, 3u);
+
+        std::vector<size_t> expected(100u);
+        std::iota(std::begin(expected), std::end(expected), 0u);
+        CHECK(order == expected);
+    }
+
+    TEST_CASE("parallel_reduce", "[parallel_test]") {
+        thread_pool pool(4u);
+
+        CHECK(kdl::parallel_reduce(pool, 0u, 0u, 7, [](const size_t) { return 1; }, std::plus<int>()) == 7);
+        CHECK(kdl::parallel_reduce(pool, 1u, 10001u, size_t(0), [](const size_t i) { return i; }, std::plus<size_t>()) == 50005000u);
+
+        // non-commutative reductions are combined in index order
+        const auto str = kdl::parallel_reduce(pool, 0u, 26u, std::string(), [](const size_t i) {
+            return std::string(1u, static_cast<char>('a' + i));
+        }, [](std::string lhs, const std::string& rhs) { return lhs + rhs; }, 3u);
+        CHECK(str == "abcdefghijklmnopqrstuvwxyz");
+    }
 }
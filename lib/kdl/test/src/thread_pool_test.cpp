@@ -0,0 +1,167 @@
+/*
+ Copyright 2020 Eric Wasylishen
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <catch2/catch.hpp>
+
+#include "test_utils.h"
+#include <catch2/catch.hpp>
+
+#include "kdl/thread_pool.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace kdl {
+    TEST_CASE("thread_pool_test.default_thread_pool", "[thread_pool_test]") {
+        CHECK(&default_thread_pool() == &default_thread_pool());
+        CHECK(default_thread_pool().thread_count() == default_thread_count());
+
+        thread_pool pool(0u);
+        {
+            scoped_default_thread_pool scope(pool);
+            CHECK(&default_thread_pool() == &pool);
+        }
+        CHECK(&default_thread_pool() != &pool);
+    }
+
+    TEST_CASE("thread_pool_test.submit", "[thread_pool_test]") {
+        std::atomic<int> count(0);
+        {
+            thread_pool pool(3u);
+            for (int i = 0; i < 1000; ++i) {
+                pool.submit([&]() { ++count; });
+            }
+        }
+        // the destructor runs all remaining tasks
+        CHECK(count == 1000);
+    }
+
+    TEST_CASE("thread_pool_test.submit_without_workers", "[thread_pool_test]") {
+        thread_pool pool(0u);
+        CHECK(pool.thread_count() == 0u);
+        CHECK(pool.concurrency() == 1u);
+
+        std::vector<int> order;
+        pool.submit([&]() { order.push_back(1); });
+        pool.submit([&]() { order.push_back(2); });
+        CHECK(order == std::vector<int>{1, 2});
+        CHECK_FALSE(pool.run_pending_task());
+    }
+
+    TEST_CASE("thread_pool_test.async", "[thread_pool_test]") {
+        thread_pool pool(2u);
+
+        auto future = pool.async([]() { return 42; });
+        CHECK(future.get() == 42);
+
+        auto failing = pool.async([]() -> int { throw std::runtime_error("error"); });
+        CHECK_THROWS_AS(failing.get(), std::runtime_error);
+    }
+
+    TEST_CASE("thread_pool_test.task_group", "[thread_pool_test]") {
+        thread_pool pool(4u);
+
+        SECTION("waits for all tasks") {
+            std::atomic<int> count(0);
+            task_group group(pool);
+            for (int i = 0; i < 1000; ++i) {
+                group.run([&]() { ++count; });
+            }
+            group.wait();
+            CHECK(count == 1000);
+        }
+
+        SECTION("nested groups") {
+            std::atomic<int> count(0);
+            task_group outer(pool);
+            for (int i = 0; i < 16; ++i) {
+                outer.run([&]() {
+                    task_group inner(pool);
+                    for (int j = 0; j < 16; ++j) {
+                        inner.run([&]() { ++count; });
+                    }
+                    inner.wait();
+                });
+            }
+            outer.wait();
+            CHECK(count == 256);
+        }
+
+        SECTION("tasks can add tasks to their own group") {
+            std::atomic<int> count(0);
+            task_group group(pool);
+            std::function<void(int)> spawn = [&](const int depth) {
+                ++count;
+                if (depth > 0) {
+                    group.run([&, depth]() { spawn(depth - 1); });
+                    group.run([&, depth]() { spawn(depth - 1); });
+                }
+            };
+            group.run([&]() { spawn(6); });
+            group.wait();
+            CHECK(count == 127);
+        }
+
+        SECTION("rethrows first exception and can be reused") {
+            task_group group(pool);
+            group.run([]() { throw std::runtime_error("error"); });
+            CHECK_THROWS_AS(group.wait(), std::runtime_error);
+            CHECK_FALSE(group.is_cancelled());
+
+            std::atomic<int> count(0);
+            group.run([&]() { ++count; });
+            CHECK_NOTHROW(group.wait());
+            CHECK(count == 1);
+        }
+    }
+
+    TEST_CASE("thread_pool_test.task_group_does_not_run_other_tasks", "[thread_pool_test]") {
+        thread_pool pool(1u);
+
+        // occupy the only worker until the end of the test
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        std::atomic<bool> blocking(false);
+        pool.submit([&, released]() {
+            blocking = true;
+            released.wait();
+        });
+        while (!blocking) {
+            std::this_thread::yield();
+        }
+
+        // this task stays queued while the worker is blocked
+        std::atomic<bool> unrelated(false);
+        pool.submit([&]() { unrelated = true; });
+
+        std::atomic<int> count(0);
+        task_group group(pool);
+        for (int i = 0; i < 16; ++i) {
+            group.run([&]() { ++count; });
+        }
+        group.wait();
+
+        CHECK(count == 16);
+        CHECK_FALSE(unrelated);
+
+        release.set_value();
+    }
+}